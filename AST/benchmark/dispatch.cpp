@@ -0,0 +1,236 @@
+/*
+microbenchmark of BasicNode visit dispatch.
+
+compares current dispatch (tag of node + per signature function table)
+with the previous one (std::any boxing of arguments and typeid search of signature),
+which is copied here as 'legacy' namespace.
+
+both evaluate the same deep expression trees: ((1 + 1) + 1) + ... and 1 + (1 + (1 + ...)).
+
+usage: dispatch-benchmark [depth = 1000] [repeats = 10000]
+*/
+
+#include <any>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+import thelast;
+
+#include "create-basic-node.hpp"
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace legacy
+{
+
+/* previous BasicNode: only what is needed for visit */
+class BasicNode
+{
+private:
+    struct IBaseNode
+    {
+        virtual ~IBaseNode() = default;
+        virtual std::any invoke_(std::type_info const & sig, std::any* args) const = 0;
+        virtual bool supports_signature_(std::type_info const & sig) const = 0;
+    };
+
+    template <typename NodeT, typename... Signatures>
+    struct NodeImpl final : public IBaseNode
+    {
+        NodeT data_;
+
+        explicit NodeImpl(NodeT&& node) : data_(std::move(node)) {}
+
+        template <typename Signature>
+        struct Invoker;
+
+        template <typename ReturnT, typename... Args>
+        struct Invoker<ReturnT(Args...)>
+        {
+            template <typename T>
+            static T unwrap_arg_(std::any const & arg)
+            {
+                if constexpr (std::is_reference_v<T>)
+                    return std::any_cast<std::reference_wrapper<std::remove_reference_t<T>>&>(const_cast<std::any&>(arg)).get();
+                else
+                    return std::any_cast<T>(arg);
+            }
+
+            static std::any call_(NodeT const & data, std::any* args)
+            { return call_impl_(data, args, std::index_sequence_for<Args...>{}); }
+
+            template <size_t... Is>
+            static std::any call_impl_(NodeT const & data, std::any* args, std::index_sequence<Is...>)
+            { return std::any(visit(data, unwrap_arg_<Args>(args[Is])...)); }
+        };
+
+        std::any invoke_(std::type_info const & sig, std::any* args) const override
+        {
+            std::any result;
+            auto&& found = false;
+
+            ((typeid(Signatures) == sig ?
+              (found = true, result = Invoker<Signatures>::call_(data_, args)) :
+              false), ...);
+
+            if (found) return result;
+            throw std::runtime_error("signature was not registered");
+        }
+
+        bool supports_signature_(std::type_info const & sig) const override
+        {
+            auto&& supported = false;
+            ((typeid(Signatures) == sig ? (supported = true) : false), ...);
+            return supported;
+        }
+    };
+
+    std::unique_ptr<IBaseNode> self_;
+
+public:
+    template <typename... Signatures>
+    struct Actions
+    {
+        template <typename NodeT>
+        static BasicNode create(NodeT&& node)
+        {
+            auto&& result = BasicNode{};
+            result.self_ = std::make_unique<NodeImpl<NodeT, Signatures...>>(std::move(node));
+            return result;
+        }
+    };
+
+    template <typename ReturnT>
+    friend ReturnT visit(BasicNode const & node)
+    {
+        using SignatureT = ReturnT();
+
+        if (not node.self_->supports_signature_(typeid(SignatureT)))
+            throw std::runtime_error("This node dont support this function");
+
+        std::any args[1];
+        return std::any_cast<ReturnT>(node.self_->invoke_(typeid(SignatureT), args));
+    }
+};
+
+struct NumberLiteral { int value; };
+struct Add           { BasicNode left; BasicNode right; };
+
+int visit(NumberLiteral const & node)
+{ return node.value; }
+
+int visit(Add const & node)
+{ return visit<int>(node.left) + visit<int>(node.right); }
+
+using calculable = int();
+
+} /* namespace legacy */
+
+//---------------------------------------------------------------------------------------------------------------
+
+using calculable = int();
+
+namespace last::node::visit_specializations
+{
+
+template <>
+int visit(NumberLiteral const & node)
+{ return node.value(); }
+
+template <>
+int visit(BinaryOperator const & node)
+{ return visit<int>(node.larg()) + visit<int>(node.rarg()); }
+
+} /* namespace last::node::visit_specializations */
+
+SPECIALIZE_CREATE(last::node::NumberLiteral , calculable)
+SPECIALIZE_CREATE(last::node::BinaryOperator, calculable)
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using namespace last::node;
+
+/* left = true: ((1 + 1) + 1) + ...; left = false: 1 + (1 + (1 + ...)) */
+BasicNode current_tree(size_t depth, bool left)
+{
+    auto&& tree = create(NumberLiteral{1});
+
+    for (size_t it = 0; it < depth; ++it)
+    {
+        auto&& one = create(NumberLiteral{1});
+        tree = left ? create(BinaryOperator{BinaryOperator::ADD, std::move(tree), std::move(one)})
+                    : create(BinaryOperator{BinaryOperator::ADD, std::move(one), std::move(tree)});
+    }
+
+    return tree;
+}
+
+legacy::BasicNode legacy_tree(size_t depth, bool left)
+{
+    using Actions = legacy::BasicNode::Actions<legacy::calculable>;
+
+    auto&& tree = Actions::create(legacy::NumberLiteral{1});
+
+    for (size_t it = 0; it < depth; ++it)
+    {
+        auto&& one = Actions::create(legacy::NumberLiteral{1});
+        tree = left ? Actions::create(legacy::Add{std::move(tree), std::move(one)})
+                    : Actions::create(legacy::Add{std::move(one), std::move(tree)});
+    }
+
+    return tree;
+}
+
+template <typename NodeT>
+void measure(std::string const & name, NodeT const & tree, size_t repeats, int expected)
+{
+    auto&& start = std::chrono::steady_clock::now();
+
+    long long sum = 0;
+    for (size_t it = 0; it < repeats; ++it)
+        sum += visit<int>(tree);
+
+    auto&& seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (sum != static_cast<long long>(expected) * static_cast<long long>(repeats))
+        throw std::runtime_error(name + ": wrong result");
+
+    std::cout << name << ": " << seconds << " s (" << seconds * 1e9 / (static_cast<double>(repeats) * (2 * expected - 1)) << " ns per visit)\n";
+}
+
+} /* namespace */
+
+//---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[]) try
+{
+    auto&& depth   = static_cast<size_t>(argc > 1 ? std::atoll(argv[1]) : 1000);
+    auto&& repeats = static_cast<size_t>(argc > 2 ? std::atoll(argv[2]) : 10000);
+    auto&& result  = static_cast<int>(depth + 1);
+
+    std::cout << "depth = " << depth << ", repeats = " << repeats << "\n";
+
+    for (auto&& left : {true, false})
+    {
+        std::cout << (left ? "left" : "right") << " deep tree\n";
+        measure("  legacy  (std::any + typeid)", legacy_tree(depth, left) , repeats, result);
+        measure("  current (tag + table)      ", current_tree(depth, left), repeats, result);
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (std::exception const & e)
+{
+    std::cerr << "Exception catched: " << e.what() << "\n";
+    return EXIT_FAILURE;
+}
@@ -13,6 +13,9 @@ SPECIALIZE_CREATE(last::node::Print           , __VA_ARGS__)
 SPECIALIZE_CREATE(last::node::Scan            , __VA_ARGS__)                                                                \
 SPECIALIZE_CREATE(last::node::UnaryOperator   , __VA_ARGS__)                                                                \
 SPECIALIZE_CREATE(last::node::BinaryOperator  , __VA_ARGS__)                                                                \
+SPECIALIZE_CREATE(last::node::ArrayDeclaration, __VA_ARGS__)                                                                \
+SPECIALIZE_CREATE(last::node::ArrayElement    , __VA_ARGS__)                                                                \
+SPECIALIZE_CREATE(last::node::ArrayAssignment , __VA_ARGS__)                                                                \
 SPECIALIZE_CREATE(last::node::If              , __VA_ARGS__)                                                                \
 SPECIALIZE_CREATE(last::node::Else            , __VA_ARGS__)                                                                \
 SPECIALIZE_CREATE(last::node::Condition       , __VA_ARGS__)                                                                \
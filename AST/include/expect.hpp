@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+
+/* checks of test executables: every check prints its result, main returns EXIT_FAILURE if any of them failed */
+
+namespace last::test
+{
+
+inline size_t failures = 0;
+
+inline void expect(bool condition, std::string_view test)
+{
+    std::cout << (condition ? "ok     " : "FAILED ") << test << "\n";
+    if (not condition) ++failures;
+}
+
+} /* namespace last::test */
@@ -10,16 +10,32 @@
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <cstdint>
 #include <boost/json.hpp>
 #endif /* not defined(THELAST_READ_AST_NO_INCLUDES) */
 
 
 namespace last
 {
-namespace node::__detail
+namespace node
 {
 
-BinaryOperator::BinaryOperatorT string_to_bin_op(std::string_view op)
+/*
+default factory for reading: node::create, specialized in the unit, which includes this file.
+any type with static create(NodeT) (for example, BasicNode::Actions<...>) may be passed instead.
+*/
+struct SpecializedCreate
+{
+    template <typename NodeT>
+    static BasicNode create(NodeT node)
+    { return last::node::create(std::move(node)); }
+};
+
+namespace __detail
+{
+
+inline BinaryOperator::BinaryOperatorT string_to_bin_op(std::string_view op)
 {
     using OpT = BinaryOperator::BinaryOperatorT;
 
@@ -37,7 +53,7 @@ BinaryOperator::BinaryOperatorT string_to_bin_op(std::string_view op)
     throw std::runtime_error("Unknown binary operator: " + std::string(op));
 }
 
-UnaryOperator::UnaryOperatorT string_to_un_op(std::string_view op)
+inline UnaryOperator::UnaryOperatorT string_to_un_op(std::string_view op)
 {
     using OpT = UnaryOperator::UnaryOperatorT;
     if (op == "-") return OpT::MINUS;
@@ -47,110 +63,301 @@ UnaryOperator::UnaryOperatorT string_to_un_op(std::string_view op)
     throw std::runtime_error("Unknown unary operator: " + std::string(op));
 }
 
-BasicNode node_from_json(const boost::json::value& jv)
+/* operator of array assignment: one of =, +=, -=, *=, /=, %= */
+inline BinaryOperator::BinaryOperatorT array_assignment_type(uint32_t type)
+{
+    if (type < BinaryOperator::ASGN or type > BinaryOperator::REMASGN)
+        throw std::runtime_error("Bad operator of array assignment: " + std::to_string(type));
+    return static_cast<BinaryOperator::BinaryOperatorT>(type);
+}
+
+template <typename Factory>
+BasicNode node_from_json(const boost::json::value& jv);
+
+template <typename Factory>
+BasicNode node_data_from_json(const boost::json::object& obj)
 {
-    auto&& obj = jv.as_object();
     auto&& kind = obj.at("kind").as_string();
 
     if (kind == traits::get_node_info<NumberLiteral, traits::NAME>())
     {
         auto&& value = static_cast<int>(obj.at(traits::get_node_info<NumberLiteral, traits::FIELD, 0>()).as_int64());
         auto&& node = NumberLiteral{std::move(value)};
-        return create(std::move(node));
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<StringLiteral, traits::NAME>())
     {
-        auto&& value = static_cast<std::string>(obj.at(traits::get_node_info<NumberLiteral, traits::FIELD, 0>()).as_string());
-        auto&& node = StringLiteral{std::move(value)};
-        return create(std::move(node));
+        auto&& value = obj.at(traits::get_node_info<NumberLiteral, traits::FIELD, 0>()).as_string();
+        auto&& node = StringLiteral{std::string_view{value}};
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<Variable, traits::NAME>())
     {
-        auto&& value = static_cast<std::string>(obj.at(traits::get_node_info<Variable, traits::FIELD, 0>()).as_string());
-        auto&& node = Variable{std::move(value)};
-        return create(std::move(node));
+        auto&& value = obj.at(traits::get_node_info<Variable, traits::FIELD, 0>()).as_string();
+        auto&& node = Variable{std::string_view{value}};
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<Scan, traits::NAME>())
     {
         auto&& node = Scan{};
-        return create(std::move(node));
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<Print, traits::NAME>())
     {
-        auto&& args = std::vector<BasicNode>{};
-        for (auto&& arg_jv : obj.at(traits::get_node_info<Print, traits::FIELD, 0>()).as_array())
-            args.push_back(node_from_json(arg_jv));
-        auto&& node = Print{std::move(args)};
-        return create(std::move(node));
+        auto&& args_jv = obj.at(traits::get_node_info<Print, traits::FIELD, 0>()).as_array();
+        auto&& node = Print{};
+        node.reserve(args_jv.size());
+        for (auto&& arg_jv : args_jv)
+            node.push_back(node_from_json<Factory>(arg_jv));
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<UnaryOperator, traits::NAME>())
     {
         auto&& type = string_to_un_op(obj.at(traits::get_node_info<UnaryOperator, traits::FIELD, 0>()).as_string());
-        auto&& arg = node_from_json(obj.at(traits::get_node_info<UnaryOperator, traits::FIELD, 1>()));
+        auto&& arg = node_from_json<Factory>(obj.at(traits::get_node_info<UnaryOperator, traits::FIELD, 1>()));
         auto&& node = UnaryOperator{type, std::move(arg)};
-        return create(std::move(node));
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<BinaryOperator, traits::NAME>())
     {
         auto&& type = string_to_bin_op(obj.at(traits::get_node_info<BinaryOperator, traits::FIELD, 0>()).as_string());
-        auto&& left = node_from_json(obj.at(traits::get_node_info<BinaryOperator, traits::FIELD, 1>()));
-        auto&& right = node_from_json(obj.at(traits::get_node_info<BinaryOperator, traits::FIELD, 2>()));
+        auto&& left = node_from_json<Factory>(obj.at(traits::get_node_info<BinaryOperator, traits::FIELD, 1>()));
+        auto&& right = node_from_json<Factory>(obj.at(traits::get_node_info<BinaryOperator, traits::FIELD, 2>()));
         auto&& node = BinaryOperator{type, std::move(left), std::move(right)};
-        return create(std::move(node));
+        return Factory::create(std::move(node));
+    }
+    if (kind == traits::get_node_info<ArrayDeclaration, traits::NAME>())
+    {
+        auto&& name  = obj.at(traits::get_node_info<ArrayDeclaration, traits::FIELD, 0>()).as_string();
+        auto&& value = node_from_json<Factory>(obj.at(traits::get_node_info<ArrayDeclaration, traits::FIELD, 1>()));
+        auto&& size  = node_from_json<Factory>(obj.at(traits::get_node_info<ArrayDeclaration, traits::FIELD, 2>()));
+        auto&& node = ArrayDeclaration{std::string_view{name}, std::move(value), std::move(size)};
+        return Factory::create(std::move(node));
+    }
+    if (kind == traits::get_node_info<ArrayElement, traits::NAME>())
+    {
+        auto&& name  = obj.at(traits::get_node_info<ArrayElement, traits::FIELD, 0>()).as_string();
+        auto&& index = node_from_json<Factory>(obj.at(traits::get_node_info<ArrayElement, traits::FIELD, 1>()));
+        auto&& node = ArrayElement{std::string_view{name}, std::move(index)};
+        return Factory::create(std::move(node));
+    }
+    if (kind == traits::get_node_info<ArrayAssignment, traits::NAME>())
+    {
+        auto&& type  = string_to_bin_op(obj.at(traits::get_node_info<ArrayAssignment, traits::FIELD, 0>()).as_string());
+        auto&& name  = obj.at(traits::get_node_info<ArrayAssignment, traits::FIELD, 1>()).as_string();
+        auto&& index = node_from_json<Factory>(obj.at(traits::get_node_info<ArrayAssignment, traits::FIELD, 2>()));
+        auto&& value = node_from_json<Factory>(obj.at(traits::get_node_info<ArrayAssignment, traits::FIELD, 3>()));
+        auto&& node = ArrayAssignment{array_assignment_type(type), std::string_view{name}, std::move(index), std::move(value)};
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<While, traits::NAME>())
     {
-        auto&& condition = node_from_json(obj.at(traits::get_node_info<While, traits::FIELD, 0>()));
-        auto&& body = node_from_json(obj.at(traits::get_node_info<While, traits::FIELD, 1>()));
+        auto&& condition = node_from_json<Factory>(obj.at(traits::get_node_info<While, traits::FIELD, 0>()));
+        auto&& body = node_from_json<Factory>(obj.at(traits::get_node_info<While, traits::FIELD, 1>()));
         auto&& node = While{std::move(condition), std::move(body)};
-        return create(std::move(node));
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<If, traits::NAME>())
     {
-        auto&& condition = node_from_json(obj.at(traits::get_node_info<If, traits::FIELD, 0>()));
-        auto&& body = node_from_json(obj.at(traits::get_node_info<If, traits::FIELD, 1>()));
+        auto&& condition = node_from_json<Factory>(obj.at(traits::get_node_info<If, traits::FIELD, 0>()));
+        auto&& body = node_from_json<Factory>(obj.at(traits::get_node_info<If, traits::FIELD, 1>()));
         auto&& node = If{std::move(condition), std::move(body)};
-        return create(std::move(node));
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<Else, traits::NAME>())
     {
-        auto&& body = node_from_json(obj.at(traits::get_node_info<Else, traits::FIELD, 0>()));
+        auto&& body = node_from_json<Factory>(obj.at(traits::get_node_info<Else, traits::FIELD, 0>()));
         auto&& node = Else{std::move(body)};
-        return create(std::move(node));
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<Scope, traits::NAME>())
     {
-        auto&& statements = std::vector<BasicNode>{};
-        for (auto&& stmt_jv : obj.at(traits::get_node_info<Scope, traits::FIELD, 0>()).as_array())
-            statements.push_back(node_from_json(stmt_jv));
-        auto&& node = Scope{std::move(statements)};
-        return create(std::move(node));
+        auto&& statements_jv = obj.at(traits::get_node_info<Scope, traits::FIELD, 0>()).as_array();
+        auto&& node = Scope{};
+        node.reserve(statements_jv.size());
+        for (auto&& stmt_jv : statements_jv)
+            node.push_back(node_from_json<Factory>(stmt_jv));
+        return Factory::create(std::move(node));
     }
     if (kind == traits::get_node_info<Condition, traits::NAME>())
     {
         auto&& node = Condition{};
         for (auto&& if_jv : obj.at(traits::get_node_info<Condition, traits::FIELD, 0>()).as_array())
-            node.add_condition(node_from_json(if_jv));
+            node.add_condition(node_from_json<Factory>(if_jv));
 
         if (obj.contains(traits::get_node_info<Condition, traits::FIELD, 1>()))
         {
-            auto&& else_node = node_from_json(obj.at(traits::get_node_info<Condition, traits::FIELD, 1>()));
+            auto&& else_node = node_from_json<Factory>(obj.at(traits::get_node_info<Condition, traits::FIELD, 1>()));
             node.set_else(std::move(else_node));
         }
 
-        return create(std::move(node));
+        return Factory::create(std::move(node));
     }
 
     throw std::runtime_error("Unsupported node kind during deserialization: " + std::string(kind));
 }
 
-} /* namespace node::__detail */
+inline uint32_t location_word(const boost::json::value& jv)
+{
+    auto&& value = jv.to_number<int64_t>();
+    if (value < 0 or value > UINT32_MAX)
+        throw std::runtime_error("Bad location of node: " + std::to_string(value));
+    return static_cast<uint32_t>(value);
+}
+
+/* location is optional: nodes, which were not parsed from source, have no location */
+template <typename Factory>
+BasicNode node_from_json(const boost::json::value& jv)
+{
+    auto&& obj = jv.as_object();
+    auto&& node = node_data_from_json<Factory>(obj);
+
+    if (auto&& location = obj.if_contains("location"))
+    {
+        auto&& words = location->as_array();
+        if (words.size() != 4)
+            throw std::runtime_error("Bad location of node: expected [line, column, end line, end column]");
+
+        node.set_location(Location{
+            .begin = Position{.line = location_word(words[0]), .column = location_word(words[1])},
+            .end   = Position{.line = location_word(words[2]), .column = location_word(words[3])}
+        });
+    }
+
+    return node;
+}
+
+/* count of children of scope or print. the last child must be in file, so a broken count isn`t reserved */
+inline uint32_t children_count(binary::NodeView node)
+{
+    auto&& count = node.operand(0);
+    if (count != 0) node.operand(count);
+    return count;
+}
+
+template <typename Factory>
+BasicNode node_from_binary(binary::NodeView node);
+
+template <typename Factory>
+BasicNode node_data_from_binary(binary::NodeView node)
+{
+    using binary::Kind;
+
+    switch (node.kind())
+    {
+        case Kind::NUMBER_LITERAL:
+        {
+            auto&& value = static_cast<int>(node.operand(0));
+            return Factory::create(NumberLiteral{value});
+        }
+        /* strings of image are already interned in order (see read), string id is symbol id */
+        case Kind::STRING_LITERAL:
+            return Factory::create(StringLiteral{Symbols::current()->at(node.operand(0))});
+        case Kind::VARIABLE:
+            return Factory::create(Variable{Symbols::current()->at(node.operand(0))});
+        case Kind::SCAN:
+            return Factory::create(Scan{});
+        case Kind::PRINT:
+        {
+            auto&& print = Print{};
+            print.reserve(children_count(node));
+            for (uint32_t it = 0, count = node.operand(0); it < count; ++it)
+                print.push_back(node_from_binary<Factory>(node.child(it + 1)));
+            return Factory::create(std::move(print));
+        }
+        case Kind::UNARY_OPERATOR:
+        {
+            auto&& type = node.operand(0);
+            if (type > UnaryOperator::NOT)
+                throw std::runtime_error("Unknown unary operator in binary ast: " + std::to_string(type));
+            auto&& arg = node_from_binary<Factory>(node.child(1));
+            return Factory::create(UnaryOperator{static_cast<UnaryOperator::UnaryOperatorT>(type), std::move(arg)});
+        }
+        case Kind::BINARY_OPERATOR:
+        {
+            auto&& type = node.operand(0);
+            if (type > BinaryOperator::REMASGN)
+                throw std::runtime_error("Unknown binary operator in binary ast: " + std::to_string(type));
+            auto&& left  = node_from_binary<Factory>(node.child(1));
+            auto&& right = node_from_binary<Factory>(node.child(2));
+            return Factory::create(BinaryOperator{static_cast<BinaryOperator::BinaryOperatorT>(type), std::move(left), std::move(right)});
+        }
+        case Kind::ARRAY_DECLARATION:
+        {
+            auto&& value = node_from_binary<Factory>(node.child(1));
+            auto&& size  = node_from_binary<Factory>(node.child(2));
+            return Factory::create(ArrayDeclaration{Symbols::current()->at(node.operand(0)), std::move(value), std::move(size)});
+        }
+        case Kind::ARRAY_ELEMENT:
+            return Factory::create(ArrayElement{Symbols::current()->at(node.operand(0)), node_from_binary<Factory>(node.child(1))});
+        case Kind::ARRAY_ASSIGNMENT:
+        {
+            auto&& type  = array_assignment_type(node.operand(0));
+            auto&& index = node_from_binary<Factory>(node.child(2));
+            auto&& value = node_from_binary<Factory>(node.child(3));
+            return Factory::create(ArrayAssignment{type, Symbols::current()->at(node.operand(1)), std::move(index), std::move(value)});
+        }
+        case Kind::WHILE:
+        {
+            auto&& condition = node_from_binary<Factory>(node.child(0));
+            auto&& body      = node_from_binary<Factory>(node.child(1));
+            return Factory::create(While{std::move(condition), std::move(body)});
+        }
+        case Kind::IF:
+        {
+            auto&& condition = node_from_binary<Factory>(node.child(0));
+            auto&& body      = node_from_binary<Factory>(node.child(1));
+            return Factory::create(If{std::move(condition), std::move(body)});
+        }
+        case Kind::ELSE:
+            return Factory::create(Else{node_from_binary<Factory>(node.child(0))});
+        case Kind::CONDITION:
+        {
+            auto&& condition = Condition{};
+            for (uint32_t it = 0, count = node.operand(1); it < count; ++it)
+                condition.add_condition(node_from_binary<Factory>(node.child(it + 2)));
+
+            if (node.operand(0) != 0)
+                condition.set_else(node_from_binary<Factory>(node.child(0)));
+
+            return Factory::create(std::move(condition));
+        }
+        case Kind::SCOPE:
+        {
+            auto&& scope = Scope{};
+            scope.reserve(children_count(node));
+            for (uint32_t it = 0, count = node.operand(0); it < count; ++it)
+                scope.push_back(node_from_binary<Factory>(node.child(it + 1)));
+            return Factory::create(std::move(scope));
+        }
+        default:
+            break;
+    }
+
+    throw std::runtime_error("Unsupported node kind during binary deserialization");
+}
+
+template <typename Factory>
+BasicNode node_from_binary(binary::NodeView node)
+{
+    auto&& result = node_data_from_binary<Factory>(node);
+
+    if (auto&& location = node.location(); not location.empty())
+        result.set_location(location);
+
+    return result;
+}
+
+} /* namespace __detail */
+} /* namespace node */
 
 namespace __detail
 {
 
+template <typename Factory = node::SpecializedCreate>
 AST read(std::string_view jsonData)
 {
+    auto&& timer = stats::Timer{"ast load"};
     auto&& jv = boost::json::parse(jsonData);
     auto&& jo = jv.as_object();
 
@@ -159,15 +366,53 @@ AST read(std::string_view jsonData)
     if (jo.at(kind).as_string() != "AST")
         throw std::runtime_error("Root JSON element is not a AST");
 
-    auto&& root = node::__detail::node_from_json(jo.at("root"));
+    /* all nodes of the tree are placed in one arena and all names in one symbol table, both are owned by the returned AST */
+    auto&& arena   = std::make_unique<node::Arena>();
+    auto&& symbols = std::make_shared<node::Symbols>();
+    auto&& root = [&]
+    {
+        auto&& use_arena   = node::Arena::Use{*arena};
+        auto&& use_symbols = node::Symbols::Use{symbols.get()};
+        return node::__detail::node_from_json<Factory>(jo.at("root"));
+    }();
 
-    return AST{std::move(root)};
+    return AST{std::move(root), std::move(arena), std::move(symbols)};
 }
 
 } /* namespace __detail */
 
+/* the tree doesn`t refer to image, so image may be destroyed right after reading */
+template <typename Factory = node::SpecializedCreate>
+AST read(binary::Image const & image)
+{
+    auto&& timer   = stats::Timer{"ast load"};
+    auto&& arena   = std::make_unique<node::Arena>();
+    auto&& symbols = std::make_shared<node::Symbols>();
+
+    /* string table of file becomes symbol table of tree: once, not per node */
+    for (uint32_t it = 0, count = image.strings_count(); it < count; ++it)
+        symbols->intern(image.string(it));
+
+    if (symbols->size() != image.strings_count())
+        throw std::runtime_error("Failed read ast from binary format: strings are not unique");
+
+    auto&& root = [&]
+    {
+        auto&& use_arena   = node::Arena::Use{*arena};
+        auto&& use_symbols = node::Symbols::Use{symbols.get()};
+        return node::__detail::node_from_binary<Factory>(image.root());
+    }();
+
+    return AST{std::move(root), std::move(arena), std::move(symbols)};
+}
+
+/* reads both formats: binary (last::write_binary) is recognized by its magic, everything else is json */
+template <typename Factory = node::SpecializedCreate>
 AST read(std::filesystem::path const & ast_json)
 {
+    if (binary::Image::is_binary(ast_json))
+        return read<Factory>(binary::Image{ast_json});
+
     auto&& in = std::ifstream{ast_json};
 
     if (in.fail())
@@ -176,8 +421,9 @@ AST read(std::filesystem::path const & ast_json)
     auto&& buffer = std::ostringstream{};
     buffer << in.rdbuf();
     auto&& jsonData = buffer.str();
+    stats::count(stats::Counter::BYTES_READ, jsonData.size());
 
-    return __detail::read(jsonData);
+    return __detail::read<Factory>(jsonData);
 }
 
 } /* namespace last */
\ No newline at end of file
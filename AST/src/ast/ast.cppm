@@ -1,6 +1,7 @@
 module;
 
 #include <memory>
+#include <utility>
 
 export module ast;
 
@@ -15,25 +16,48 @@ export
 class AST
 {
 private:
+    std::unique_ptr<node::Arena> arena_; /* declared before root_: nodes are destroyed before their memory */
+    std::shared_ptr<node::Symbols> symbols_; /* names of variables and string literals, shared with trees made from this one */
     node::BasicNode root_;
 
 public:
-    AST(node::BasicNode const & root) : /* too long, because all tree will copy */
-        root_(root)
-    {}
-    
     AST() = default;
 
     AST(node::BasicNode&& root) :
         root_(std::move(root))
     {}
 
-    
+    /* root (and its subtree) was created with node::Arena::Use{*arena} */
+    AST(node::BasicNode&& root, std::unique_ptr<node::Arena>&& arena) :
+        arena_(std::move(arena)), root_(std::move(root))
+    {}
+
+    /* and its names were interned with node::Symbols::Use{symbols.get()} */
+    AST(node::BasicNode&& root, std::unique_ptr<node::Arena>&& arena, std::shared_ptr<node::Symbols> symbols) :
+        arena_(std::move(arena)), symbols_(std::move(symbols)), root_(std::move(root))
+    {}
+
+    /* move only: moving the whole tree is O(1), copying it is never what you want */
+    AST(AST const &) = delete;
+    AST& operator=(AST const &) = delete;
+
+    AST(AST&&) noexcept = default;
+    AST& operator=(AST&& other) noexcept
+    {
+        if (this == &other) return *this;
+        root_    = std::move(other.root_); /* old root must die before its arena and symbols */
+        arena_   = std::move(other.arena_);
+        symbols_ = std::move(other.symbols_);
+        return *this;
+    }
 
 public:
     node::BasicNode const &root() const noexcept
     { return root_; }
 
+    /* nullptr: names are in the symbol table of process (tree was made without its own table) */
+    std::shared_ptr<node::Symbols> const &symbols() const noexcept
+    { return symbols_; }
 };
 
 } /* namespace last */
@@ -0,0 +1,633 @@
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module ast_binary;
+
+export import ast;
+
+import node_type_erasure;
+import ast_nodes;
+import last_stats;
+
+/*
+binary ast format (version 3). all values are native-endian uint32_t words.
+
+    [header][nodes][locations][string entries][string chars]
+
+header   : magic "LASTBIN\0", version, file size, root offset, strings offset, strings count, locations offset.
+node     : kind, then operands of this kind (see Kind). children are byte offsets of other nodes
+           from the start of file. children are always written before their parent,
+           so every child offset is less than offset of its parent.
+locations: entry = {node offset, begin line, begin column, end line, end column}, sorted by node offset.
+           only nodes with location have entries.
+strings  : entry = {offset of chars, size}. every string is stored once.
+
+file is used in place (mmap), reader doesn`t parse or copy it.
+*/
+
+namespace last::binary
+{
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+export constexpr auto MAGIC   = std::array<char, 8>{'L', 'A', 'S', 'T', 'B', 'I', 'N', '\0'};
+export constexpr auto VERSION = uint32_t{3};
+
+export
+enum class Kind : uint32_t
+{
+    SCOPE          , /* count, children[count]                  */
+    PRINT          , /* count, children[count]                  */
+    SCAN           , /*                                         */
+    VARIABLE       , /* string id of name                       */
+    NUMBER_LITERAL , /* value                                   */
+    STRING_LITERAL , /* string id of value                      */
+    UNARY_OPERATOR , /* operator, argument                      */
+    BINARY_OPERATOR, /* operator, left, right                   */
+    WHILE          , /* condition, body                         */
+    IF             , /* condition, body                         */
+    ELSE           , /* body                                    */
+    CONDITION      , /* else (0 if there is no else), count, ifs[count] */
+    ARRAY_DECLARATION, /* string id of name, value, size        */
+    ARRAY_ELEMENT    , /* string id of name, index              */
+    ARRAY_ASSIGNMENT , /* operator, string id of name, index, value */
+
+    KINDS_COUNT
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+struct Header
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t root;
+    uint32_t strings;
+    uint32_t strings_count;
+    uint32_t locations;
+};
+
+static_assert(sizeof(Header) % sizeof(uint32_t) == 0);
+
+struct StringEntry
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct LocationEntry
+{
+    uint32_t node;
+    uint32_t begin_line;
+    uint32_t begin_column;
+    uint32_t end_line;
+    uint32_t end_column;
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* serializes nodes in post order: children first */
+export
+class Writer final
+{
+private:
+    std::vector<uint32_t> words_ = std::vector<uint32_t>(sizeof(Header) / sizeof(uint32_t));
+    std::vector<std::string_view> strings_;
+    std::unordered_map<std::string_view, uint32_t> string_ids_;
+    std::unordered_map<node::Symbol, uint32_t, node::SymbolHash> symbol_ids_;
+    std::vector<LocationEntry> locations_;
+
+public:
+    /* returns offset of node */
+    uint32_t add_node(Kind kind, std::initializer_list<uint32_t> operands)
+    {
+        auto&& offset = current_offset_();
+        words_.push_back(static_cast<uint32_t>(kind));
+        words_.insert(words_.end(), operands);
+        return offset;
+    }
+
+    /* node with fixed operands and list of children */
+    uint32_t add_node(Kind kind, std::initializer_list<uint32_t> operands, std::vector<uint32_t> const & children)
+    {
+        auto&& offset = add_node(kind, operands);
+        words_.push_back(static_cast<uint32_t>(children.size()));
+        words_.insert(words_.end(), children.begin(), children.end());
+        return offset;
+    }
+
+    /* nodes are written in post order, so locations are added sorted by offset */
+    void set_location(uint32_t node, node::Location const & location)
+    {
+        locations_.push_back(LocationEntry{
+            node, location.begin.line, location.begin.column, location.end.line, location.end.column
+        });
+    }
+
+    /* string must live until finish() */
+    uint32_t add_string(std::string_view string)
+    {
+        auto&& [it, inserted] = string_ids_.try_emplace(string, static_cast<uint32_t>(strings_.size()));
+        if (inserted)
+            strings_.push_back(string);
+        return it->second;
+    }
+
+    /* names of nodes: string is hashed once per symbol, not once per node. symbol table must live until finish() */
+    uint32_t add_symbol(node::Symbol symbol)
+    {
+        auto&& [it, inserted] = symbol_ids_.try_emplace(symbol, 0);
+        if (inserted)
+            it->second = add_string(symbol.name());
+        return it->second;
+    }
+
+    std::vector<char> finish(uint32_t root) &&
+    {
+        auto&& locations = current_offset_();
+        auto&& strings   = locations + static_cast<uint32_t>(locations_.size() * sizeof(LocationEntry));
+        auto&& chars     = strings + static_cast<uint32_t>(strings_.size() * sizeof(StringEntry));
+
+        auto&& entries = std::vector<StringEntry>{};
+        entries.reserve(strings_.size());
+        for (auto&& string : strings_)
+        {
+            entries.push_back(StringEntry{chars, static_cast<uint32_t>(string.size())});
+            chars += static_cast<uint32_t>(string.size());
+        }
+
+        auto&& header = Header{
+            .magic         = MAGIC,
+            .version       = VERSION,
+            .size          = chars,
+            .root          = root,
+            .strings       = strings,
+            .strings_count = static_cast<uint32_t>(strings_.size()),
+            .locations     = locations
+        };
+
+        auto&& image = std::vector<char>(chars);
+        std::memcpy(image.data(), words_.data(), words_.size() * sizeof(uint32_t));
+        std::memcpy(image.data(), &header, sizeof(header));
+        /* data() of empty vector may be nullptr, which memcpy doesn`t accept even for 0 bytes */
+        if (not locations_.empty())
+            std::memcpy(image.data() + locations, locations_.data(), locations_.size() * sizeof(LocationEntry));
+        if (not entries.empty())
+            std::memcpy(image.data() + strings, entries.data(), entries.size() * sizeof(StringEntry));
+        for (size_t it = 0; it < strings_.size(); ++it)
+            std::memcpy(image.data() + entries[it].offset, strings_[it].data(), strings_[it].size());
+
+        return image;
+    }
+
+private:
+    uint32_t current_offset_() const
+    {
+        if (words_.size() * sizeof(uint32_t) > UINT32_MAX / 2)
+            throw std::runtime_error("ast is too big for binary format");
+        return static_cast<uint32_t>(words_.size() * sizeof(uint32_t));
+    }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* read only mapping of whole file */
+class MappedFile final
+{
+private:
+    void*  data_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(std::filesystem::path const & file)
+    {
+        auto&& fd = ::open(file.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("No such file: " + file.string() + ".\nFailed read ast from binary format.");
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 or info.st_size == 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Failed read ast from binary format: bad file: " + file.string());
+        }
+
+        auto&& size = static_cast<size_t>(info.st_size);
+        auto*  data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+            throw std::runtime_error("Failed read ast from binary format: mmap failed: " + file.string());
+
+        data_ = data;
+        size_ = size;
+
+        stats::count(stats::Counter::BYTES_READ, size);
+    }
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile& operator=(MappedFile const &) = delete;
+
+    MappedFile(MappedFile&& other) noexcept :
+        data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0))
+    {}
+
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    ~MappedFile()
+    {
+        if (data_)
+            ::munmap(data_, size_);
+    }
+
+public:
+    char const* data() const noexcept
+    { return static_cast<char const*>(data_); }
+
+    size_t size() const noexcept
+    { return size_; }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+export
+class Image;
+
+/* view of one node in image */
+export
+class NodeView final
+{
+private:
+    Image const* image_;
+    uint32_t     offset_;
+
+public:
+    NodeView(Image const & image, uint32_t offset) : image_(&image), offset_(offset)
+    {}
+
+public:
+    Kind     kind() const;
+    uint32_t operand(uint32_t index) const; /* index 0 is the first word after kind */
+    NodeView child(uint32_t index) const;   /* operand, which is offset of child node */
+
+    std::string_view string(uint32_t index) const; /* operand, which is string id */
+
+    node::Location location() const; /* empty, if node has no location */
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/*
+binary ast: mapped file or bytes in memory (to pass ast between frontend and backend in one process).
+all reads are bounds checked, so broken file leads to exception, not to crash.
+*/
+export
+class Image final
+{
+private:
+    MappedFile        file_;
+    std::vector<char> bytes_;
+    char const*       data_;
+    Header            header_;
+
+public:
+    explicit Image(std::filesystem::path const & file) :
+        file_(file), data_(file_.data())
+    { check_header_(file_.size()); }
+
+    explicit Image(std::vector<char>&& bytes) :
+        bytes_(std::move(bytes)), data_(bytes_.data())
+    { check_header_(bytes_.size()); }
+
+    /* data_ points into file_ or bytes_ */
+    Image(Image const &) = delete;
+    Image& operator=(Image const &) = delete;
+
+    /* checks magic only */
+    static bool is_binary(std::filesystem::path const & file)
+    {
+        auto&& in = std::ifstream{file, std::ios::binary};
+        auto&& magic = std::array<char, 8>{};
+        return in.read(magic.data(), magic.size()) and magic == MAGIC;
+    }
+
+public:
+    NodeView root() const
+    { return NodeView{*this, header_.root}; }
+
+    uint32_t word(uint64_t offset) const
+    {
+        if (offset % sizeof(uint32_t) != 0 or offset < sizeof(Header) or offset >= header_.locations)
+            throw std::runtime_error("Failed read ast from binary format: bad node offset");
+
+        auto&& value = uint32_t{};
+        std::memcpy(&value, data_ + offset, sizeof(value));
+        return value;
+    }
+
+    /* strings of file are unique, so reader interns them in order and string id is symbol id */
+    uint32_t strings_count() const noexcept
+    { return header_.strings_count; }
+
+    std::string_view string(uint32_t id) const
+    {
+        if (id >= header_.strings_count)
+            throw std::runtime_error("Failed read ast from binary format: bad string id");
+
+        auto&& entry = StringEntry{};
+        std::memcpy(&entry, data_ + header_.strings + id * sizeof(StringEntry), sizeof(entry));
+
+        if (entry.offset > header_.size or entry.size > header_.size - entry.offset)
+            throw std::runtime_error("Failed read ast from binary format: bad string");
+
+        return std::string_view{data_ + entry.offset, entry.size};
+    }
+
+    /* binary search in locations table */
+    node::Location location(uint32_t node) const
+    {
+        auto&& entry = LocationEntry{};
+        auto&& low  = size_t{0};
+        auto&& high = (header_.strings - header_.locations) / sizeof(LocationEntry);
+
+        while (low < high)
+        {
+            auto&& middle = low + (high - low) / 2;
+            std::memcpy(&entry, data_ + header_.locations + middle * sizeof(LocationEntry), sizeof(entry));
+
+            if (entry.node == node)
+            {
+                return node::Location{
+                    .begin = node::Position{.line = entry.begin_line, .column = entry.begin_column},
+                    .end   = node::Position{.line = entry.end_line  , .column = entry.end_column  }
+                };
+            }
+
+            if (entry.node < node) low  = middle + 1;
+            else                   high = middle;
+        }
+
+        return node::Location{};
+    }
+
+private:
+    void check_header_(size_t size)
+    {
+        if (size < sizeof(Header))
+            throw std::runtime_error("Failed read ast from binary format: file is too small");
+
+        std::memcpy(&header_, data_, sizeof(Header));
+
+        if (header_.magic != MAGIC)
+            throw std::runtime_error("Failed read ast from binary format: bad magic");
+
+        if (header_.version != VERSION)
+            throw std::runtime_error("Failed read ast from binary format: unsupported version " + std::to_string(header_.version));
+
+        if (header_.size != size or header_.strings > header_.size or
+            header_.strings_count > (header_.size - header_.strings) / sizeof(StringEntry) or
+            header_.locations < sizeof(Header) or header_.locations > header_.strings or
+            (header_.strings - header_.locations) % sizeof(LocationEntry) != 0)
+            throw std::runtime_error("Failed read ast from binary format: broken header");
+    }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+Kind NodeView::kind() const
+{
+    auto&& kind = image_->word(offset_);
+    if (kind >= static_cast<uint32_t>(Kind::KINDS_COUNT))
+        throw std::runtime_error("Failed read ast from binary format: unknown node kind " + std::to_string(kind));
+    return static_cast<Kind>(kind);
+}
+
+uint32_t NodeView::operand(uint32_t index) const
+{
+    return image_->word(uint64_t{offset_} + (uint64_t{index} + 1) * sizeof(uint32_t));
+}
+
+NodeView NodeView::child(uint32_t index) const
+{
+    auto&& offset = operand(index);
+
+    /* children are written before parent: it guarantees, that there are no cycles */
+    if (offset >= offset_)
+        throw std::runtime_error("Failed read ast from binary format: bad child offset");
+
+    return NodeView{*image_, offset};
+}
+
+std::string_view NodeView::string(uint32_t index) const
+{
+    return image_->string(operand(index));
+}
+
+node::Location NodeView::location() const
+{
+    return image_->location(offset_);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+} /* namespace last::binary */
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+namespace last::node
+{
+
+export using binary_writable = uint32_t(binary::Writer&);
+
+uint32_t write_binary(BasicNode const & node, binary::Writer& writer)
+{
+    auto&& offset = visit<uint32_t, binary::Writer&>(node, writer);
+
+    if (auto&& location = node.location(); not location.empty())
+        writer.set_location(offset, location);
+
+    return offset;
+}
+
+namespace visit_specializations
+{
+
+using binary::Kind;
+
+template <>
+uint32_t visit(Scope const & node, binary::Writer& writer)
+{
+    auto&& children = std::vector<uint32_t>{};
+    children.reserve(node.size());
+    for (auto&& statement : node)
+        children.push_back(write_binary(statement, writer));
+    return writer.add_node(Kind::SCOPE, {}, children);
+}
+
+template <>
+uint32_t visit(Print const & node, binary::Writer& writer)
+{
+    auto&& children = std::vector<uint32_t>{};
+    children.reserve(node.size());
+    for (auto&& arg : node)
+        children.push_back(write_binary(arg, writer));
+    return writer.add_node(Kind::PRINT, {}, children);
+}
+
+template <>
+uint32_t visit(Scan const & /* node */, binary::Writer& writer)
+{
+    return writer.add_node(Kind::SCAN, {});
+}
+
+template <>
+uint32_t visit(Variable const & node, binary::Writer& writer)
+{
+    return writer.add_node(Kind::VARIABLE, {writer.add_symbol(node.symbol())});
+}
+
+template <>
+uint32_t visit(NumberLiteral const & node, binary::Writer& writer)
+{
+    return writer.add_node(Kind::NUMBER_LITERAL, {static_cast<uint32_t>(node.value())});
+}
+
+template <>
+uint32_t visit(StringLiteral const & node, binary::Writer& writer)
+{
+    return writer.add_node(Kind::STRING_LITERAL, {writer.add_symbol(node.symbol())});
+}
+
+template <>
+uint32_t visit(UnaryOperator const & node, binary::Writer& writer)
+{
+    auto&& arg = write_binary(node.arg(), writer);
+    return writer.add_node(Kind::UNARY_OPERATOR, {static_cast<uint32_t>(node.type()), arg});
+}
+
+template <>
+uint32_t visit(BinaryOperator const & node, binary::Writer& writer)
+{
+    auto&& left  = write_binary(node.larg(), writer);
+    auto&& right = write_binary(node.rarg(), writer);
+    return writer.add_node(Kind::BINARY_OPERATOR, {static_cast<uint32_t>(node.type()), left, right});
+}
+
+template <>
+uint32_t visit(ArrayDeclaration const & node, binary::Writer& writer)
+{
+    auto&& value = write_binary(node.value(), writer);
+    auto&& size  = write_binary(node.size(), writer);
+    return writer.add_node(Kind::ARRAY_DECLARATION, {writer.add_symbol(node.symbol()), value, size});
+}
+
+template <>
+uint32_t visit(ArrayElement const & node, binary::Writer& writer)
+{
+    auto&& index = write_binary(node.index(), writer);
+    return writer.add_node(Kind::ARRAY_ELEMENT, {writer.add_symbol(node.symbol()), index});
+}
+
+template <>
+uint32_t visit(ArrayAssignment const & node, binary::Writer& writer)
+{
+    auto&& index = write_binary(node.index(), writer);
+    auto&& value = write_binary(node.value(), writer);
+    return writer.add_node(Kind::ARRAY_ASSIGNMENT, {static_cast<uint32_t>(node.type()), writer.add_symbol(node.symbol()), index, value});
+}
+
+template <>
+uint32_t visit(While const & node, binary::Writer& writer)
+{
+    auto&& condition = write_binary(node.condition(), writer);
+    auto&& body      = write_binary(node.body(), writer);
+    return writer.add_node(Kind::WHILE, {condition, body});
+}
+
+template <>
+uint32_t visit(If const & node, binary::Writer& writer)
+{
+    auto&& condition = write_binary(node.condition(), writer);
+    auto&& body      = write_binary(node.body(), writer);
+    return writer.add_node(Kind::IF, {condition, body});
+}
+
+template <>
+uint32_t visit(Else const & node, binary::Writer& writer)
+{
+    auto&& body = write_binary(node.body(), writer);
+    return writer.add_node(Kind::ELSE, {body});
+}
+
+template <>
+uint32_t visit(Condition const & node, binary::Writer& writer)
+{
+    auto&& ifs = std::vector<uint32_t>{};
+    ifs.reserve(node.get_ifs().size());
+    for (auto&& if_node : node.get_ifs())
+        ifs.push_back(write_binary(if_node, writer));
+
+    /* offset 0 is header, so it can`t be a node */
+    auto&& else_node = node.has_else() ? write_binary(node.get_else(), writer) : uint32_t{0};
+    return writer.add_node(Kind::CONDITION, {else_node}, ifs);
+}
+
+} /* namespace visit_specializations */
+} /* namespace last::node */
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+namespace last
+{
+
+/* in memory: bytes for binary::Image, which root is node (used to pass a part of tree) */
+export
+std::vector<char> write_binary(node::BasicNode const & node)
+{
+    auto&& timer  = stats::Timer{"ast serialization"};
+    auto&& writer = binary::Writer{};
+    auto&& root   = node::write_binary(node, writer);
+    return std::move(writer).finish(root);
+}
+
+/* in memory: bytes for binary::Image */
+export
+std::vector<char> write_binary(AST const & ast)
+{
+    return write_binary(ast.root());
+}
+
+export
+void write_binary(AST const & ast, std::filesystem::path const & file)
+{
+    auto&& image = write_binary(ast);
+
+    auto&& out = std::ofstream{file, std::ios::binary};
+
+    if (out.fail())
+        throw std::runtime_error("No such file: " + file.string() + ".\nFailed write ast in binary format.");
+
+    out.write(image.data(), static_cast<std::streamsize>(image.size()));
+    stats::count(stats::Counter::BYTES_WRITTEN, image.size());
+}
+
+} /* namespace last */
@@ -185,6 +185,46 @@ void visit(BinaryOperator const& node, unique_node_id_t unique_node_id, std::ofs
     graphic_dump::dump_and_link_with_parent(os, unique_node_id, node.rarg(), "right");
 }
 
+template <>
+void visit(ArrayDeclaration const& node, unique_node_id_t unique_node_id, std::ofstream& os)
+{
+    std::string label = "Array: " + std::string(node.name());
+    graphic_dump::create_node(os, unique_node_id, label, "style=filled, fillcolor=\"lightblue\"");
+
+    graphic_dump::dump_and_link_with_parent(os, unique_node_id, node.value(), "value");
+    graphic_dump::dump_and_link_with_parent(os, unique_node_id, node.size(), "size");
+}
+
+template <>
+void visit(ArrayElement const& node, unique_node_id_t unique_node_id, std::ofstream& os)
+{
+    std::string label = "Element: " + std::string(node.name());
+    graphic_dump::create_node(os, unique_node_id, label, "style=filled, fillcolor=\"lightblue\"");
+
+    graphic_dump::dump_and_link_with_parent(os, unique_node_id, node.index(), "index");
+}
+
+template <>
+void visit(ArrayAssignment const& node, unique_node_id_t unique_node_id, std::ofstream& os)
+{
+    std::string label = "Element: " + std::string(node.name()) + " ";
+    switch (node.type())
+    {
+        case BinaryOperator::ASGN:    label += "="; break;
+        case BinaryOperator::ADDASGN: label += "+="; break;
+        case BinaryOperator::SUBASGN: label += "-="; break;
+        case BinaryOperator::MULASGN: label += "*="; break;
+        case BinaryOperator::DIVASGN: label += "/="; break;
+        case BinaryOperator::REMASGN: label += "%="; break;
+        default:                       label += "??"; break;
+    }
+
+    graphic_dump::create_node(os, unique_node_id, label, "style=filled, fillcolor=\"lightyellow\"");
+
+    graphic_dump::dump_and_link_with_parent(os, unique_node_id, node.index(), "index");
+    graphic_dump::dump_and_link_with_parent(os, unique_node_id, node.value(), "value");
+}
+
 template <>
 void visit(While const& node, unique_node_id_t unique_node_id, std::ofstream& os)
 {
@@ -0,0 +1,1369 @@
+module;
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+export module ast_optimizer;
+
+export import ast;
+
+/*
+optimizations of the tree, which don`t depend on a backend.
+nodes are immutable, so every pass builds a new tree. new nodes are created by Factory
+(any type with static create(NodeT), like in last::read), so optimized tree has the same signatures as the original one.
+passes look at nodes with is_a: they work with a tree of any signatures.
+*/
+
+namespace last::optimizer
+{
+
+using node::BasicNode;
+using node::Scope;
+using node::Print;
+using node::Scan;
+using node::Variable;
+using node::NumberLiteral;
+using node::StringLiteral;
+using node::UnaryOperator;
+using node::BinaryOperator;
+using node::ArrayDeclaration;
+using node::ArrayElement;
+using node::ArrayAssignment;
+using node::While;
+using node::If;
+using node::Else;
+using node::Condition;
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::optional<int> literal(BasicNode const & node)
+{
+    if (not node.is_a<NumberLiteral>()) return std::nullopt;
+    return static_cast<NumberLiteral const &>(node).value();
+}
+
+bool is_assignment(BinaryOperator::BinaryOperatorT type)
+{
+    switch (type)
+    {
+        case BinaryOperator::ASGN:
+        case BinaryOperator::ADDASGN:
+        case BinaryOperator::SUBASGN:
+        case BinaryOperator::MULASGN:
+        case BinaryOperator::DIVASGN:
+        case BinaryOperator::REMASGN: return true;
+        default:                      return false;
+    }
+}
+
+/* x op= y is x = x op y */
+BinaryOperator::BinaryOperatorT arithmetic_of(BinaryOperator::BinaryOperatorT type)
+{
+    switch (type)
+    {
+        case BinaryOperator::ADDASGN: return BinaryOperator::ADD;
+        case BinaryOperator::SUBASGN: return BinaryOperator::SUB;
+        case BinaryOperator::MULASGN: return BinaryOperator::MUL;
+        case BinaryOperator::DIVASGN: return BinaryOperator::DIV;
+        case BinaryOperator::REMASGN: return BinaryOperator::REM;
+        default: throw std::logic_error("optimizer: not a compound assignment");
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+value of operator with constant arguments, as backends calculate it: int wraps around.
+nullopt - value is not known before execution: division by zero and INT_MIN / -1 trap in every backend.
+*/
+std::optional<int> fold(BinaryOperator::BinaryOperatorT type, int left, int right)
+{
+    auto&& wrap = [](unsigned value) { return static_cast<int>(value); };
+
+    switch (type)
+    {
+        case BinaryOperator::ADD:   return wrap(static_cast<unsigned>(left) + static_cast<unsigned>(right));
+        case BinaryOperator::SUB:   return wrap(static_cast<unsigned>(left) - static_cast<unsigned>(right));
+        case BinaryOperator::MUL:   return wrap(static_cast<unsigned>(left) * static_cast<unsigned>(right));
+        case BinaryOperator::ISAB:  return left >  right;
+        case BinaryOperator::ISABE: return left >= right;
+        case BinaryOperator::ISLS:  return left <  right;
+        case BinaryOperator::ISLSE: return left <= right;
+        case BinaryOperator::ISEQ:  return left == right;
+        case BinaryOperator::ISNE:  return left != right;
+        case BinaryOperator::AND:   return left and right;
+        case BinaryOperator::OR:    return left or  right;
+        case BinaryOperator::DIV:
+        case BinaryOperator::REM:
+        {
+            if (right == 0 or (left == std::numeric_limits<int>::min() and right == -1)) return std::nullopt;
+            return (type == BinaryOperator::DIV) ? left / right : left % right;
+        }
+        default: return std::nullopt;
+    }
+}
+
+std::optional<int> fold(UnaryOperator::UnaryOperatorT type, int arg)
+{
+    switch (type)
+    {
+        case UnaryOperator::MINUS: return static_cast<int>(0U - static_cast<unsigned>(arg));
+        case UnaryOperator::PLUS:  return arg;
+        case UnaryOperator::NOT:   return not arg;
+    }
+
+    return std::nullopt;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+expression has no side effects and can`t trap: it may be removed or calculated more than once.
+the only exception is read of variable, which was declared, but never assigned (0 and (x = 1) declares x): it traps.
+so pure expression may be removed or calculated earlier only if its variables are definitely assigned there (see collect_definitely_assigned).
+*/
+bool is_pure(BasicNode const & node)
+{
+    if (node.is_a<NumberLiteral>() or node.is_a<StringLiteral>() or node.is_a<Variable>()) return true;
+
+    if (node.is_a<UnaryOperator>())
+        return is_pure(static_cast<UnaryOperator const &>(node).arg());
+
+    if (not node.is_a<BinaryOperator>()) return false; /* scan and statements */
+
+    auto&& binary = static_cast<BinaryOperator const &>(node);
+    auto&& type   = binary.type();
+
+    if (is_assignment(type)) return false;
+
+    if (type == BinaryOperator::DIV or type == BinaryOperator::REM)
+    {
+        auto&& divisor = literal(binary.rarg());
+        if (not divisor or *divisor == 0 or *divisor == -1) return false;
+    }
+
+    return is_pure(binary.larg()) and is_pure(binary.rarg());
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* names of variables, which are assigned somewhere in the subtree */
+void collect_assigned(BasicNode const & node, std::unordered_set<std::string>& assigned)
+{
+    if (not node) return;
+
+    if (node.is_a<Scope>())
+    {
+        for (auto&& statement : static_cast<Scope const &>(node)) collect_assigned(statement, assigned);
+        return;
+    }
+
+    if (node.is_a<Print>())
+    {
+        for (auto&& arg : static_cast<Print const &>(node)) collect_assigned(arg, assigned);
+        return;
+    }
+
+    if (node.is_a<UnaryOperator>())
+        return collect_assigned(static_cast<UnaryOperator const &>(node).arg(), assigned);
+
+    if (node.is_a<BinaryOperator>())
+    {
+        auto&& binary = static_cast<BinaryOperator const &>(node);
+
+        if (is_assignment(binary.type()))
+            assigned.emplace(static_cast<Variable const &>(binary.larg()).name());
+        else
+            collect_assigned(binary.larg(), assigned);
+
+        return collect_assigned(binary.rarg(), assigned);
+    }
+
+    /* elements of arrays are not variables: only expressions inside are looked at */
+    if (node.is_a<ArrayDeclaration>())
+    {
+        auto&& declaration = static_cast<ArrayDeclaration const &>(node);
+        collect_assigned(declaration.value(), assigned);
+        return collect_assigned(declaration.size(), assigned);
+    }
+
+    if (node.is_a<ArrayElement>())
+        return collect_assigned(static_cast<ArrayElement const &>(node).index(), assigned);
+
+    if (node.is_a<ArrayAssignment>())
+    {
+        auto&& assignment = static_cast<ArrayAssignment const &>(node);
+        collect_assigned(assignment.index(), assigned);
+        return collect_assigned(assignment.value(), assigned);
+    }
+
+    if (node.is_a<While>())
+    {
+        auto&& loop = static_cast<While const &>(node);
+        collect_assigned(loop.condition(), assigned);
+        return collect_assigned(loop.body(), assigned);
+    }
+
+    if (node.is_a<Condition>())
+    {
+        auto&& condition = static_cast<Condition const &>(node);
+
+        for (auto&& if_node : condition.get_ifs())
+        {
+            auto&& if_statement = static_cast<If const &>(if_node);
+            collect_assigned(if_statement.condition(), assigned);
+            collect_assigned(if_statement.body(), assigned);
+        }
+
+        if (condition.has_else())
+            collect_assigned(static_cast<Else const &>(condition.get_else()).body(), assigned);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+names of variables, which are assigned on every execution of the statement (if it doesn`t trap).
+only the parts, which are always calculated, are looked at: right of 'and'/'or', body of while
+and branches of condition may be skipped. nested scope gives nothing: its new variables die with it.
+*/
+void collect_definitely_assigned(BasicNode const & node, std::unordered_set<std::string>& assigned)
+{
+    if (not node) return;
+
+    if (node.is_a<Print>())
+    {
+        for (auto&& arg : static_cast<Print const &>(node)) collect_definitely_assigned(arg, assigned);
+        return;
+    }
+
+    if (node.is_a<UnaryOperator>())
+        return collect_definitely_assigned(static_cast<UnaryOperator const &>(node).arg(), assigned);
+
+    if (node.is_a<BinaryOperator>())
+    {
+        auto&& binary = static_cast<BinaryOperator const &>(node);
+        auto&& type   = binary.type();
+
+        if (is_assignment(type))
+        {
+            collect_definitely_assigned(binary.rarg(), assigned);
+            assigned.emplace(static_cast<Variable const &>(binary.larg()).name());
+            return;
+        }
+
+        collect_definitely_assigned(binary.larg(), assigned);
+        if (type == BinaryOperator::AND or type == BinaryOperator::OR) return;
+
+        return collect_definitely_assigned(binary.rarg(), assigned);
+    }
+
+    if (node.is_a<ArrayDeclaration>())
+    {
+        auto&& declaration = static_cast<ArrayDeclaration const &>(node);
+        collect_definitely_assigned(declaration.value(), assigned);
+        return collect_definitely_assigned(declaration.size(), assigned);
+    }
+
+    if (node.is_a<ArrayElement>())
+        return collect_definitely_assigned(static_cast<ArrayElement const &>(node).index(), assigned);
+
+    if (node.is_a<ArrayAssignment>())
+    {
+        auto&& assignment = static_cast<ArrayAssignment const &>(node);
+        collect_definitely_assigned(assignment.index(), assigned);
+        return collect_definitely_assigned(assignment.value(), assigned);
+    }
+
+    if (node.is_a<While>())
+        return collect_definitely_assigned(static_cast<While const &>(node).condition(), assigned);
+
+    /* only the condition of the first if is always calculated */
+    if (node.is_a<Condition>())
+    {
+        auto&& ifs = static_cast<Condition const &>(node).get_ifs();
+        if (not ifs.empty()) collect_definitely_assigned(static_cast<If const &>(ifs.front()).condition(), assigned);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+export
+template <typename Factory>
+class Pass
+{
+  protected:
+    size_t changes_ = 0;
+
+  public:
+    virtual ~Pass() = default;
+
+    virtual std::string_view name() const = 0;
+
+    /* returns new tree. nodes are created in the current arena */
+    virtual BasicNode run(BasicNode const & root) = 0;
+
+    /* how many rewrites were done by the last run */
+    size_t changes() const noexcept
+    { return changes_; }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+base of passes: copies the tree through Factory.
+pass overrides visit for nodes, which it changes (and brings the rest with 'using Rewriter::visit').
+*/
+template <typename Factory, typename Derived>
+class Rewriter : public Pass<Factory>
+{
+  public:
+    BasicNode run(BasicNode const & root) override
+    {
+        this->changes_ = 0;
+        return rewrite(root);
+    }
+
+  protected:
+    template <typename NodeT>
+    static BasicNode create(NodeT node)
+    { return Factory::create(std::move(node)); }
+
+    static BasicNode empty_scope()
+    { return create(Scope{}); }
+
+    /* node, which replaces original, gets its location, if it has no own one */
+    static BasicNode located(BasicNode&& node, BasicNode const & original)
+    {
+        if (node and node.location().empty())
+            node.set_location(original.location());
+
+        return std::move(node);
+    }
+
+    BasicNode rewrite(BasicNode const & node)
+    { return located(dispatch_(node), node); }
+
+  private:
+    BasicNode dispatch_(BasicNode const & node)
+    {
+        auto&& self = static_cast<Derived&>(*this);
+
+        if (node.is_a<Scope>())          return self.visit(static_cast<Scope          const &>(node));
+        if (node.is_a<Print>())          return self.visit(static_cast<Print          const &>(node));
+        if (node.is_a<Scan>())           return self.visit(static_cast<Scan           const &>(node));
+        if (node.is_a<Variable>())       return self.visit(static_cast<Variable       const &>(node));
+        if (node.is_a<NumberLiteral>())  return self.visit(static_cast<NumberLiteral  const &>(node));
+        if (node.is_a<StringLiteral>())  return self.visit(static_cast<StringLiteral  const &>(node));
+        if (node.is_a<UnaryOperator>())  return self.visit(static_cast<UnaryOperator  const &>(node));
+        if (node.is_a<BinaryOperator>()) return self.visit(static_cast<BinaryOperator const &>(node));
+        if (node.is_a<ArrayDeclaration>()) return self.visit(static_cast<ArrayDeclaration const &>(node));
+        if (node.is_a<ArrayElement>())     return self.visit(static_cast<ArrayElement     const &>(node));
+        if (node.is_a<ArrayAssignment>())  return self.visit(static_cast<ArrayAssignment  const &>(node));
+        if (node.is_a<While>())          return self.visit(static_cast<While          const &>(node));
+        if (node.is_a<Condition>())      return self.visit(static_cast<Condition      const &>(node));
+
+        throw std::runtime_error("optimizer: unexpected node");
+    }
+
+  public:
+    BasicNode visit(Scope const & node)
+    {
+        auto&& statements = std::vector<BasicNode>{};
+        for (auto&& statement : node) statements.push_back(rewrite(statement));
+
+        return create(Scope{std::move(statements)});
+    }
+
+    BasicNode visit(Print const & node)
+    {
+        auto&& args = std::vector<BasicNode>{};
+        for (auto&& arg : node) args.push_back(rewrite(arg));
+
+        return create(Print{std::move(args)});
+    }
+
+    BasicNode visit([[maybe_unused]] Scan const & node)
+    { return create(Scan{}); }
+
+    BasicNode visit(Variable const & node)
+    { return create(Variable{node.symbol()}); }
+
+    BasicNode visit(NumberLiteral const & node)
+    { return create(NumberLiteral{node.value()}); }
+
+    BasicNode visit(StringLiteral const & node)
+    { return create(StringLiteral{node.symbol()}); }
+
+    BasicNode visit(UnaryOperator const & node)
+    { return create(UnaryOperator{node.type(), rewrite(node.arg())}); }
+
+    BasicNode visit(BinaryOperator const & node)
+    {
+        auto&& left = rewrite(node.larg());
+        return create(BinaryOperator{node.type(), std::move(left), rewrite(node.rarg())});
+    }
+
+    /* value is calculated before size, index - before value */
+    BasicNode visit(ArrayDeclaration const & node)
+    {
+        auto&& value = rewrite(node.value());
+        return create(ArrayDeclaration{node.symbol(), std::move(value), rewrite(node.size())});
+    }
+
+    BasicNode visit(ArrayElement const & node)
+    { return create(ArrayElement{node.symbol(), rewrite(node.index())}); }
+
+    BasicNode visit(ArrayAssignment const & node)
+    {
+        auto&& index = rewrite(node.index());
+        return create(ArrayAssignment{node.type(), node.symbol(), std::move(index), rewrite(node.value())});
+    }
+
+    BasicNode visit(While const & node)
+    {
+        auto&& condition = rewrite(node.condition());
+        return create(While{std::move(condition), rewrite(node.body())});
+    }
+
+    BasicNode visit(Condition const & node)
+    {
+        auto&& result = Condition{};
+
+        for (auto&& if_node : node.get_ifs())
+        {
+            auto&& if_statement = static_cast<If const &>(if_node);
+            auto&& condition = rewrite(if_statement.condition());
+            result.add_condition(located(create(If{std::move(condition), rewrite(if_statement.body())}), if_node));
+        }
+
+        if (node.has_else())
+            result.set_else(located(create(Else{rewrite(static_cast<Else const &>(node.get_else()).body())}), node.get_else()));
+
+        return create(std::move(result));
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+base of passes, which remove or move reads of variables: the read of never assigned variable traps, so it must stay.
+knows variables, which are definitely assigned at the current statement (see collect_definitely_assigned).
+statements of scope go through 'rewrite_statement': pass overrides it to drop or add statements.
+variables, assigned in the scope, are definitely assigned only till its end: nested bodies may be not executed.
+*/
+template <typename Factory, typename Derived>
+class DefiniteAssignmentRewriter : public Rewriter<Factory, Derived>
+{
+  private:
+    using Base = Rewriter<Factory, Derived>;
+
+    bool reads_defined(BasicNode const & node) const
+    {
+        if (node.is_a<Variable>())
+            return defined_.contains(std::string{static_cast<Variable const &>(node).name()});
+
+        if (node.is_a<UnaryOperator>())
+            return reads_defined(static_cast<UnaryOperator const &>(node).arg());
+
+        if (node.is_a<BinaryOperator>())
+        {
+            auto&& binary = static_cast<BinaryOperator const &>(node);
+            return reads_defined(binary.larg()) and reads_defined(binary.rarg());
+        }
+
+        return true;
+    }
+
+  protected:
+    std::unordered_set<std::string> defined_; /* variables, which are definitely assigned at the current statement */
+
+    /* pure expression, which reads only definitely assigned variables: it can`t trap, so it may be removed */
+    bool is_removable(BasicNode const & node) const
+    { return is_pure(node) and reads_defined(node); }
+
+  public:
+    using Base::visit;
+
+    BasicNode run(BasicNode const & root) override
+    {
+        defined_.clear();
+        return Base::run(root);
+    }
+
+    void rewrite_statement(BasicNode const & statement, std::vector<BasicNode>& statements)
+    { statements.push_back(this->rewrite(statement)); }
+
+    BasicNode visit(Scope const & node)
+    {
+        auto&& outer_defined = std::unordered_set<std::string>{defined_};
+        auto&& statements    = std::vector<BasicNode>{};
+
+        for (auto&& statement : node)
+        {
+            static_cast<Derived&>(*this).rewrite_statement(statement, statements);
+            collect_definitely_assigned(statement, defined_);
+        }
+
+        defined_ = std::move(outer_defined);
+        return this->create(Scope{std::move(statements)});
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* operators with constant arguments become literals. 'and'/'or' with constant left (or pure left and constant right) too */
+export
+template <typename Factory>
+class ConstantFolding final : public DefiniteAssignmentRewriter<Factory, ConstantFolding<Factory>>
+{
+  private:
+    using Base = DefiniteAssignmentRewriter<Factory, ConstantFolding<Factory>>;
+    using Base::create;
+    using Base::rewrite;
+
+  public:
+    using Base::visit;
+
+    std::string_view name() const override
+    { return "constant-folding"; }
+
+    BasicNode visit(UnaryOperator const & node)
+    {
+        auto&& arg = rewrite(node.arg());
+
+        if (auto&& value = literal(arg))
+        {
+            ++this->changes_;
+            return create(NumberLiteral{*fold(node.type(), *value)});
+        }
+
+        return create(UnaryOperator{node.type(), std::move(arg)});
+    }
+
+    BasicNode visit(BinaryOperator const & node)
+    {
+        auto&& left  = rewrite(node.larg());
+        auto&& right = rewrite(node.rarg());
+        auto&& type  = node.type();
+
+        if (is_assignment(type))
+            return create(BinaryOperator{type, std::move(left), std::move(right)});
+
+        auto&& left_value  = literal(left);
+        auto&& right_value = literal(right);
+
+        if (left_value and right_value)
+        {
+            if (auto&& value = fold(type, *left_value, *right_value))
+            {
+                ++this->changes_;
+                return create(NumberLiteral{*value});
+            }
+        }
+
+        if (type != BinaryOperator::AND and type != BinaryOperator::OR)
+            return create(BinaryOperator{type, std::move(left), std::move(right)});
+
+        /* 'and' is decided by false, 'or' - by true */
+        auto&& decisive = (type == BinaryOperator::OR);
+
+        /* right is not calculated at all, or its truth is the result */
+        if (left_value)
+        {
+            ++this->changes_;
+            if (static_cast<bool>(*left_value) == decisive) return create(NumberLiteral{decisive});
+            return create(BinaryOperator{BinaryOperator::ISNE, std::move(right), create(NumberLiteral{0})});
+        }
+
+        if (right_value)
+        {
+            if (static_cast<bool>(*right_value) != decisive)
+            {
+                ++this->changes_;
+                return create(BinaryOperator{BinaryOperator::ISNE, std::move(left), create(NumberLiteral{0})});
+            }
+
+            if (this->is_removable(left))
+            {
+                ++this->changes_;
+                return create(NumberLiteral{decisive});
+            }
+        }
+
+        return create(BinaryOperator{type, std::move(left), std::move(right)});
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* identities: x + 0, x * 1, 0 - x, x * 0, -(-x), !(a < b)... */
+export
+template <typename Factory>
+class AlgebraicSimplification final : public DefiniteAssignmentRewriter<Factory, AlgebraicSimplification<Factory>>
+{
+  private:
+    using Base = DefiniteAssignmentRewriter<Factory, AlgebraicSimplification<Factory>>;
+    using Base::create;
+    using Base::rewrite;
+
+    BasicNode changed(BasicNode&& node)
+    {
+        ++this->changes_;
+        return std::move(node);
+    }
+
+    static std::optional<BinaryOperator::BinaryOperatorT> inverse(BinaryOperator::BinaryOperatorT type)
+    {
+        switch (type)
+        {
+            case BinaryOperator::ISAB:  return BinaryOperator::ISLSE;
+            case BinaryOperator::ISABE: return BinaryOperator::ISLS;
+            case BinaryOperator::ISLS:  return BinaryOperator::ISABE;
+            case BinaryOperator::ISLSE: return BinaryOperator::ISAB;
+            case BinaryOperator::ISEQ:  return BinaryOperator::ISNE;
+            case BinaryOperator::ISNE:  return BinaryOperator::ISEQ;
+            default:                    return std::nullopt;
+        }
+    }
+
+    /* comparisons and logical operators give 0 or 1 */
+    static bool is_boolean(BasicNode const & node)
+    {
+        if (node.is_a<UnaryOperator>()) return static_cast<UnaryOperator const &>(node).type() == UnaryOperator::NOT;
+        if (not node.is_a<BinaryOperator>()) return false;
+
+        auto&& type = static_cast<BinaryOperator const &>(node).type();
+        return inverse(type) or type == BinaryOperator::AND or type == BinaryOperator::OR;
+    }
+
+    static bool same_variable(BasicNode const & left, BasicNode const & right)
+    {
+        return left.is_a<Variable>() and right.is_a<Variable>() and
+               static_cast<Variable const &>(left).name() == static_cast<Variable const &>(right).name();
+    }
+
+  public:
+    using Base::visit;
+
+    std::string_view name() const override
+    { return "algebraic-simplification"; }
+
+    BasicNode visit(UnaryOperator const & node)
+    {
+        auto&& arg = rewrite(node.arg());
+
+        if (node.type() == UnaryOperator::PLUS) return changed(std::move(arg));
+
+        if (node.type() == UnaryOperator::MINUS and arg.template is_a<UnaryOperator>())
+        {
+            auto&& inner = static_cast<UnaryOperator const &>(arg);
+            if (inner.type() == UnaryOperator::MINUS) return changed(BasicNode{inner.arg()});
+        }
+
+        /* comparison is one operator: !(a < b) is a >= b */
+        if (node.type() == UnaryOperator::NOT and arg.template is_a<BinaryOperator>())
+        {
+            auto&& comparison = static_cast<BinaryOperator const &>(arg);
+            if (auto&& type = inverse(comparison.type()))
+                return changed(create(BinaryOperator{*type, comparison.larg(), comparison.rarg()}));
+        }
+
+        return create(UnaryOperator{node.type(), std::move(arg)});
+    }
+
+    BasicNode visit(BinaryOperator const & node)
+    {
+        auto&& left  = rewrite(node.larg());
+        auto&& right = rewrite(node.rarg());
+        auto&& type  = node.type();
+
+        auto&& left_value  = literal(left);
+        auto&& right_value = literal(right);
+
+        switch (type)
+        {
+            case BinaryOperator::ADD:
+                if (right_value == 0) return changed(std::move(left));
+                if (left_value  == 0) return changed(std::move(right));
+                break;
+
+            case BinaryOperator::SUB:
+                if (right_value == 0) return changed(std::move(left));
+                if (left_value  == 0) return changed(create(UnaryOperator{UnaryOperator::MINUS, std::move(right)}));
+                if (same_variable(left, right) and this->is_removable(left)) return changed(create(NumberLiteral{0}));
+                break;
+
+            case BinaryOperator::MUL:
+                if (right_value == 1) return changed(std::move(left));
+                if (left_value  == 1) return changed(std::move(right));
+                if (right_value == -1) return changed(create(UnaryOperator{UnaryOperator::MINUS, std::move(left)}));
+                if (left_value  == -1) return changed(create(UnaryOperator{UnaryOperator::MINUS, std::move(right)}));
+                if ((right_value == 0 and this->is_removable(left)) or (left_value == 0 and this->is_removable(right)))
+                    return changed(create(NumberLiteral{0}));
+                break;
+
+            case BinaryOperator::DIV:
+                if (right_value == 1) return changed(std::move(left));
+                break;
+
+            case BinaryOperator::REM:
+                if (right_value == 1 and this->is_removable(left)) return changed(create(NumberLiteral{0}));
+                break;
+
+            /* 'and' with constant gives b != 0, for boolean b it`s b itself */
+            case BinaryOperator::ISNE:
+                if (right_value == 0 and is_boolean(left))  return changed(std::move(left));
+                if (left_value  == 0 and is_boolean(right)) return changed(std::move(right));
+                break;
+
+            case BinaryOperator::ISEQ:
+                if (right_value == 0 and is_boolean(left))  return changed(create(UnaryOperator{UnaryOperator::NOT, std::move(left)}));
+                if (left_value  == 0 and is_boolean(right)) return changed(create(UnaryOperator{UnaryOperator::NOT, std::move(right)}));
+                break;
+
+            /* x += 0 and x *= 1 don`t change x: only its value is left */
+            case BinaryOperator::ADDASGN:
+            case BinaryOperator::SUBASGN:
+                if (right_value == 0) return changed(std::move(left));
+                break;
+
+            case BinaryOperator::MULASGN:
+            case BinaryOperator::DIVASGN:
+                if (right_value == 1) return changed(std::move(left));
+                break;
+
+            default:
+                break;
+        }
+
+        return create(BinaryOperator{type, std::move(left), std::move(right)});
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+removes code, which is never executed or does nothing:
+branches of Condition with constant conditions, while with false condition, statements without side effects and traps.
+*/
+export
+template <typename Factory>
+class DeadCodeElimination final : public DefiniteAssignmentRewriter<Factory, DeadCodeElimination<Factory>>
+{
+  private:
+    using Base = DefiniteAssignmentRewriter<Factory, DeadCodeElimination<Factory>>;
+    using Base::create;
+    using Base::rewrite;
+    using Base::empty_scope;
+
+    static bool is_statement(BasicNode const & node)
+    { return node.is_a<Scope>() or node.is_a<Print>() or node.is_a<While>() or node.is_a<Condition>(); }
+
+  public:
+    using Base::visit;
+
+    std::string_view name() const override
+    { return "dead-code-elimination"; }
+
+    /* value of expression statement is dropped: if it has no side effects, it`s not needed at all */
+    void rewrite_statement(BasicNode const & statement, std::vector<BasicNode>& statements)
+    {
+        if (not is_statement(statement) and this->is_removable(statement))
+        {
+            ++this->changes_;
+            return;
+        }
+
+        statements.push_back(rewrite(statement));
+    }
+
+    BasicNode visit(While const & node)
+    {
+        auto&& condition = rewrite(node.condition());
+
+        if (literal(condition) == 0)
+        {
+            ++this->changes_;
+            return empty_scope();
+        }
+
+        return create(While{std::move(condition), rewrite(node.body())});
+    }
+
+    /* body of if is a scope, so it can replace the whole condition */
+    BasicNode visit(Condition const & node)
+    {
+        auto&& ifs       = std::vector<BasicNode>{};
+        auto&& else_body = BasicNode{};
+
+        for (auto&& if_node : node.get_ifs())
+        {
+            auto&& if_statement = static_cast<If const &>(if_node);
+            auto&& condition = rewrite(if_statement.condition());
+            auto&& value = literal(condition);
+
+            if (value == 0)
+            {
+                ++this->changes_;
+                continue;
+            }
+
+            /* always true: it`s the else of the rest */
+            if (value)
+            {
+                ++this->changes_;
+                else_body = rewrite(if_statement.body());
+                break;
+            }
+
+            ifs.push_back(create(If{std::move(condition), rewrite(if_statement.body())}));
+        }
+
+        auto&& decided = static_cast<bool>(else_body);
+
+        if (not decided and node.has_else())
+            else_body = rewrite(static_cast<Else const &>(node.get_else()).body());
+
+        if (ifs.empty())
+            return else_body ? std::move(else_body) : empty_scope();
+
+        auto&& result = Condition{};
+        for (auto&& if_node : ifs) result.add_condition(std::move(if_node));
+        if (else_body) result.set_else(create(Else{std::move(else_body)}));
+
+        return create(std::move(result));
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* removes empty scopes from statements: the parser creates one for every ';' */
+export
+template <typename Factory>
+class EmptyScopeElimination final : public Rewriter<Factory, EmptyScopeElimination<Factory>>
+{
+  private:
+    using Base = Rewriter<Factory, EmptyScopeElimination<Factory>>;
+    using Base::create;
+    using Base::rewrite;
+
+  public:
+    using Base::visit;
+
+    std::string_view name() const override
+    { return "empty-scope-elimination"; }
+
+    /* bodies of while and if stay: they are scopes even if empty */
+    BasicNode visit(Scope const & node)
+    {
+        auto&& statements = std::vector<BasicNode>{};
+
+        for (auto&& statement : node)
+        {
+            auto&& result = rewrite(statement);
+
+            if (result.template is_a<Scope>() and static_cast<Scope const &>(result).size() == 0)
+            {
+                ++this->changes_;
+                continue;
+            }
+
+            statements.push_back(std::move(result));
+        }
+
+        return create(Scope{std::move(statements)});
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+reads of variables with known constant value become literals.
+values are known after assignment of constant and are forgotten, when a variable can be changed in other way:
+in loops, in one branch of condition, in right of 'and'/'or', by scan.
+*/
+export
+template <typename Factory>
+class ConstantPropagation final : public Rewriter<Factory, ConstantPropagation<Factory>>
+{
+  private:
+    using Base = Rewriter<Factory, ConstantPropagation<Factory>>;
+    using Base::create;
+    using Base::rewrite;
+
+    using Values = std::unordered_map<std::string, int>;
+
+    Values values_;
+    std::vector<std::vector<std::string>> scopes_; /* variables declared in every open scope */
+    std::unordered_set<std::string> declared_;
+
+    void declare(std::string_view name)
+    {
+        auto&& [it, inserted] = declared_.emplace(name);
+        if (inserted and not scopes_.empty()) scopes_.back().push_back(*it);
+    }
+
+    /* keeps only values, which are the same in both ways */
+    static void meet(Values& values, Values const & other)
+    {
+        std::erase_if(values, [&other](auto&& entry)
+        {
+            auto&& it = other.find(entry.first);
+            return it == other.end() or it->second != entry.second;
+        });
+    }
+
+    void set(std::string_view name, std::optional<int> value)
+    {
+        auto&& key = std::string{name};
+
+        if (value) values_[key] = *value;
+        else       values_.erase(key);
+    }
+
+  public:
+    using Base::visit;
+
+    std::string_view name() const override
+    { return "constant-propagation"; }
+
+    BasicNode run(BasicNode const & root) override
+    {
+        values_.clear();
+        scopes_.clear();
+        declared_.clear();
+        return Base::run(root);
+    }
+
+    BasicNode visit(Scope const & node)
+    {
+        scopes_.emplace_back();
+
+        auto&& result = Base::visit(node);
+
+        for (auto&& name : scopes_.back())
+        {
+            values_.erase(name);
+            declared_.erase(name);
+        }
+
+        scopes_.pop_back();
+        return result;
+    }
+
+    BasicNode visit(Variable const & node)
+    {
+        auto&& it = values_.find(std::string{node.name()});
+        if (it == values_.end()) return Base::visit(node);
+
+        ++this->changes_;
+        return create(NumberLiteral{it->second});
+    }
+
+    BasicNode visit(BinaryOperator const & node)
+    {
+        auto&& type = node.type();
+
+        if (type == BinaryOperator::AND or type == BinaryOperator::OR)
+        {
+            auto&& left = rewrite(node.larg());
+
+            /* right may be not calculated */
+            auto&& before = Values{values_};
+            auto&& right  = rewrite(node.rarg());
+            meet(values_, before);
+
+            return create(BinaryOperator{type, std::move(left), std::move(right)});
+        }
+
+        if (not is_assignment(type)) return Base::visit(node);
+
+        auto&& variable = static_cast<Variable const &>(node.larg()).symbol();
+        auto&& name     = variable.name();
+        auto&& right    = rewrite(node.rarg());
+
+        declare(name);
+
+        if (type == BinaryOperator::ASGN)
+        {
+            set(name, literal(right));
+            return create(BinaryOperator{type, create(Variable{variable}), std::move(right)});
+        }
+
+        auto&& it = values_.find(std::string{name});
+        auto&& right_value = literal(right);
+
+        /* x op= c with known x is x = value */
+        if (it != values_.end() and right_value)
+        {
+            if (auto&& value = fold(arithmetic_of(type), it->second, *right_value))
+            {
+                ++this->changes_;
+                it->second = *value;
+                return create(BinaryOperator{BinaryOperator::ASGN, create(Variable{variable}), create(NumberLiteral{*value})});
+            }
+        }
+
+        set(name, std::nullopt);
+        return create(BinaryOperator{type, create(Variable{variable}), std::move(right)});
+    }
+
+    BasicNode visit(While const & node)
+    {
+        /* condition and body see values from previous iterations */
+        auto&& assigned = std::unordered_set<std::string>{};
+        collect_assigned(node.condition(), assigned);
+        collect_assigned(node.body(), assigned);
+
+        for (auto&& name : assigned) values_.erase(name);
+
+        auto&& condition = rewrite(node.condition());
+
+        /* loop exits after condition */
+        auto&& after_condition = Values{values_};
+        auto&& body = rewrite(node.body());
+        values_ = std::move(after_condition);
+
+        return create(While{std::move(condition), std::move(body)});
+    }
+
+    BasicNode visit(Condition const & node)
+    {
+        auto&& result = Condition{};
+        auto&& merged = std::optional<Values>{};
+
+        auto&& merge = [&merged](Values const & values)
+        {
+            if (not merged) merged = values;
+            else            meet(*merged, values);
+        };
+
+        /* condition of every if is calculated after conditions of previous ifs */
+        for (auto&& if_node : node.get_ifs())
+        {
+            auto&& if_statement = static_cast<If const &>(if_node);
+            auto&& condition = rewrite(if_statement.condition());
+
+            auto&& after_condition = Values{values_};
+            auto&& body = rewrite(if_statement.body());
+            merge(values_);
+            values_ = std::move(after_condition);
+
+            result.add_condition(create(If{std::move(condition), std::move(body)}));
+        }
+
+        if (node.has_else())
+            result.set_else(create(Else{rewrite(static_cast<Else const &>(node.get_else()).body())}));
+
+        /* without else, the last condition can be false */
+        merge(values_);
+        values_ = std::move(*merged);
+
+        return create(std::move(result));
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+pure expressions of while, which use only variables not changed in the loop, are calculated once before it.
+value is saved in a new variable, declared in the scope of the loop: names of such variables can`t be written in program.
+hoisted expression is calculated even if the loop runs zero times or doesn`t reach it, so its variables
+must be definitely assigned before the loop: otherwise the read of never assigned variable would trap there.
+*/
+export
+template <typename Factory>
+class LoopInvariantHoisting final : public DefiniteAssignmentRewriter<Factory, LoopInvariantHoisting<Factory>>
+{
+  private:
+    using Base = DefiniteAssignmentRewriter<Factory, LoopInvariantHoisting<Factory>>;
+    using Base::create;
+    using Base::rewrite;
+    using Base::located;
+
+    /* replaces invariant expressions of one loop with reads of new variables */
+    class Hoister final : public Rewriter<Factory, Hoister>
+    {
+      private:
+        using HoisterBase = Rewriter<Factory, Hoister>;
+        using HoisterBase::create;
+        using HoisterBase::located;
+
+        std::unordered_set<std::string> const & assigned_;
+        std::unordered_set<std::string> const & defined_; /* definitely assigned before the loop */
+        size_t& temporaries_;
+
+        bool is_invariant(BasicNode const & node, bool& uses_variable) const
+        {
+            if (node.is_a<NumberLiteral>()) return true;
+
+            if (node.is_a<Variable>())
+            {
+                uses_variable = true;
+
+                auto&& name = std::string{static_cast<Variable const &>(node).name()};
+                return not assigned_.contains(name) and defined_.contains(name);
+            }
+
+            if (node.is_a<UnaryOperator>())
+                return is_invariant(static_cast<UnaryOperator const &>(node).arg(), uses_variable);
+
+            if (node.is_a<BinaryOperator>())
+            {
+                auto&& binary = static_cast<BinaryOperator const &>(node);
+                return is_pure(node) and is_invariant(binary.larg(), uses_variable) and is_invariant(binary.rarg(), uses_variable);
+            }
+
+            return false;
+        }
+
+        /* operator, which uses variables and gives the same value on every iteration */
+        bool is_hoistable(BasicNode const & node) const
+        {
+            auto&& uses_variable = false;
+            return (node.is_a<UnaryOperator>() or node.is_a<BinaryOperator>()) and is_invariant(node, uses_variable) and uses_variable;
+        }
+
+      public:
+        std::vector<BasicNode> hoisted;
+
+        Hoister(std::unordered_set<std::string> const & assigned, std::unordered_set<std::string> const & defined, size_t& temporaries) :
+        assigned_(assigned), defined_(defined), temporaries_(temporaries)
+        {}
+
+        using HoisterBase::visit;
+        using HoisterBase::rewrite;
+
+        std::string_view name() const override
+        { return "loop-invariant-hoisting"; }
+
+        BasicNode replace(BasicNode const & node)
+        {
+            if (not is_hoistable(node)) return rewrite(node);
+
+            /* '.' is not allowed in names of program: no conflicts with its variables */
+            auto&& temporary = node::Symbols::intern_current("licm." + std::to_string(temporaries_++));
+
+            auto&& variable = located(create(Variable{temporary}), node);
+            hoisted.push_back(located(create(BinaryOperator{BinaryOperator::ASGN, std::move(variable), BasicNode{node}}), node));
+            return located(create(Variable{temporary}), node);
+        }
+
+        BasicNode visit(UnaryOperator const & node)
+        { return create(UnaryOperator{node.type(), replace(node.arg())}); }
+
+        BasicNode visit(BinaryOperator const & node)
+        {
+            if (is_assignment(node.type()))
+                return create(BinaryOperator{node.type(), rewrite(node.larg()), replace(node.rarg())});
+
+            auto&& left = replace(node.larg());
+            return create(BinaryOperator{node.type(), std::move(left), replace(node.rarg())});
+        }
+
+        /* elements are read and written in the loop, but their indices and values may be invariant */
+        BasicNode visit(ArrayDeclaration const & node)
+        {
+            auto&& value = replace(node.value());
+            return create(ArrayDeclaration{node.symbol(), std::move(value), replace(node.size())});
+        }
+
+        BasicNode visit(ArrayElement const & node)
+        { return create(ArrayElement{node.symbol(), replace(node.index())}); }
+
+        BasicNode visit(ArrayAssignment const & node)
+        {
+            auto&& index = replace(node.index());
+            return create(ArrayAssignment{node.type(), node.symbol(), std::move(index), replace(node.value())});
+        }
+
+        BasicNode visit(Print const & node)
+        {
+            auto&& args = std::vector<BasicNode>{};
+            for (auto&& arg : node) args.push_back(replace(arg));
+
+            return create(Print{std::move(args)});
+        }
+
+        BasicNode visit(While const & node)
+        {
+            auto&& condition = replace(node.condition());
+            return create(While{std::move(condition), rewrite(node.body())});
+        }
+
+        BasicNode visit(Condition const & node)
+        {
+            auto&& result = Condition{};
+
+            for (auto&& if_node : node.get_ifs())
+            {
+                auto&& if_statement = static_cast<If const &>(if_node);
+                auto&& condition = replace(if_statement.condition());
+                result.add_condition(located(create(If{std::move(condition), rewrite(if_statement.body())}), if_node));
+            }
+
+            if (node.has_else())
+                result.set_else(located(create(Else{rewrite(static_cast<Else const &>(node.get_else()).body())}), node.get_else()));
+
+            return create(std::move(result));
+        }
+    };
+
+    size_t temporaries_ = 0; /* not reset between runs: names stay unique in the whole program */
+
+    /* hoisted assignments are placed in statements of the scope, which contains the loop. returns the loop without them */
+    BasicNode hoist(While const & loop, std::vector<BasicNode>& statements)
+    {
+        auto&& assigned = std::unordered_set<std::string>{};
+        collect_assigned(loop.condition(), assigned);
+        collect_assigned(loop.body(), assigned);
+
+        auto&& hoister   = Hoister{assigned, this->defined_, temporaries_};
+        auto&& condition = hoister.replace(loop.condition());
+        auto&& body      = hoister.run(loop.body());
+
+        this->changes_ += hoister.hoisted.size();
+
+        for (auto&& assignment : hoister.hoisted) statements.push_back(std::move(assignment));
+        return create(While{std::move(condition), std::move(body)});
+    }
+
+  public:
+    using Base::visit;
+
+    std::string_view name() const override
+    { return "loop-invariant-hoisting"; }
+
+    /*
+    outer loops are processed first: expressions, which are invariant in several nested loops, go out of all of them at once.
+    the rest of inner loop is processed with the body of outer one.
+    */
+    void rewrite_statement(BasicNode const & statement, std::vector<BasicNode>& statements)
+    {
+        if (not statement.is_a<While>()) return statements.push_back(rewrite(statement));
+
+        auto&& loop = hoist(static_cast<While const &>(statement), statements);
+        statements.push_back(located(Base::visit(static_cast<While const &>(loop)), statement));
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* runs passes one after another, while they change the tree (but not more than max_iterations times) */
+export
+template <typename Factory>
+class PassManager
+{
+  private:
+    std::vector<std::unique_ptr<Pass<Factory>>> passes_;
+    size_t max_iterations_ = 4;
+
+  public:
+    template <template <typename> typename PassT>
+    PassManager& add()
+    {
+        passes_.push_back(std::make_unique<PassT<Factory>>());
+        return *this;
+    }
+
+    PassManager& add(std::unique_ptr<Pass<Factory>>&& pass)
+    {
+        passes_.push_back(std::move(pass));
+        return *this;
+    }
+
+    void set_max_iterations(size_t max_iterations) noexcept
+    { max_iterations_ = max_iterations; }
+
+    bool empty() const noexcept
+    { return passes_.empty(); }
+
+    /* every pass builds the new tree in its own arena, the previous tree and its arena are released.
+       symbol table is shared by all trees: names of the new one are the names of the old one (and temporaries) */
+    AST run(AST&& ast)
+    {
+        for (auto&& iteration = size_t{0}; iteration < max_iterations_; ++iteration)
+        {
+            auto&& changes = size_t{0};
+
+            for (auto&& pass : passes_)
+            {
+                auto&& arena   = std::make_unique<node::Arena>();
+                auto&& symbols = ast.symbols();
+                auto&& root    = [&]
+                {
+                    auto&& use_arena   = node::Arena::Use{*arena};
+                    auto&& use_symbols = node::Symbols::Use{symbols.get()};
+                    return pass->run(ast.root());
+                }();
+
+                ast = AST{std::move(root), std::move(arena), symbols};
+                changes += pass->changes();
+
+                LOGINFO("paracl: optimizer: {}: {} changes", pass->name(), pass->changes());
+            }
+
+            if (changes == 0) break;
+        }
+
+        return std::move(ast);
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+-O0: nothing.
+-O1: local simplifications: folding, identities, dead branches, empty scopes.
+-O2: plus constant propagation through variables and hoisting of loop invariants.
+*/
+export
+template <typename Factory>
+PassManager<Factory> pipeline(unsigned level)
+{
+    auto&& manager = PassManager<Factory>{};
+    if (level == 0) return manager;
+
+    if (level >= 2) manager.template add<ConstantPropagation>();
+
+    manager.template add<ConstantFolding>()
+           .template add<AlgebraicSimplification>()
+           .template add<DeadCodeElimination>();
+
+    if (level >= 2) manager.template add<LoopInvariantHoisting>();
+
+    manager.template add<EmptyScopeElimination>();
+    return manager;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+export
+template <typename Factory>
+AST optimize(AST&& ast, unsigned level)
+{
+    if (level > 2)
+        throw std::invalid_argument("optimizer: level " + std::to_string(level) + " is not supported (expected 0, 1 or 2)");
+
+    auto&& manager = pipeline<Factory>(level);
+    if (manager.empty()) return std::move(ast);
+
+    return manager.run(std::move(ast));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace last::optimizer */
+//---------------------------------------------------------------------------------------------------------------
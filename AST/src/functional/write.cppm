@@ -13,6 +13,7 @@ export import ast;
 import node_type_erasure;
 import ast_nodes;
 import node_traits;
+import last_stats;
 
 namespace last
 {
@@ -22,10 +23,49 @@ namespace node
 
 export using writable = boost::json::value();
 
+/* location is written only if node has it: "location": [line, column, end line, end column] */
 auto write(BasicNode const & node)
     -> decltype(visit<boost::json::value>(node))
 {
-    return visit<boost::json::value>(node);
+    auto&& value = visit<boost::json::value>(node);
+
+    if (auto&& location = node.location(); not location.empty())
+    {
+        value.as_object()["location"] = boost::json::array{
+            location.begin.line, location.begin.column, location.end.line, location.end.column
+        };
+    }
+
+    return value;
+}
+
+/* binary operators and array assignments write their operator in the same way */
+std::string_view binary_operator_name(BinaryOperator::BinaryOperatorT type)
+{
+    using OpT = BinaryOperator::BinaryOperatorT;
+    switch (type)
+    {
+        case OpT::ADD:      return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ADD>();
+        case OpT::SUB:      return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::SUB>();
+        case OpT::MUL:      return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::MUL>();
+        case OpT::DIV:      return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::DIV>();
+        case OpT::REM:      return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::REM>();
+        case OpT::AND:      return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::AND>();
+        case OpT::OR:       return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::OR>();
+        case OpT::ISAB:     return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISAB>();
+        case OpT::ISABE:    return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISABE>();
+        case OpT::ISLS:     return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISLS>();
+        case OpT::ISLSE:    return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISLSE>();
+        case OpT::ISEQ:     return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISEQ>();
+        case OpT::ISNE:     return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISNE>();
+        case OpT::ASGN:     return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ASGN>();
+        case OpT::ADDASGN:  return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ADDASGN>();
+        case OpT::SUBASGN:  return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::SUBASGN>();
+        case OpT::MULASGN:  return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::MULASGN>();
+        case OpT::DIVASGN:  return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::DIVASGN>();
+        case OpT::REMASGN:  return traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::REMASGN>();
+    }
+    return {};
 }
 
 namespace visit_specializations
@@ -104,36 +144,45 @@ boost::json::value visit(const BinaryOperator& node)
     auto&& obj = boost::json::object{};
     obj["kind"] = traits::get_node_info<BinaryOperator, traits::NAME>();
 
-    auto&& op = std::string_view{};
-    using OpT = BinaryOperator::BinaryOperatorT;
-    switch (node.type())
-    {
-        case OpT::ADD:      op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ADD>(); break;
-        case OpT::SUB:      op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::SUB>(); break;
-        case OpT::MUL:      op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::MUL>(); break;
-        case OpT::DIV:      op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::DIV>(); break;
-        case OpT::REM:      op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::REM>(); break;
-        case OpT::AND:      op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::AND>(); break;
-        case OpT::OR:       op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::OR>(); break;
-        case OpT::ISAB:     op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISAB>(); break;
-        case OpT::ISABE:    op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISABE>(); break;
-        case OpT::ISLS:     op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISLS>(); break;
-        case OpT::ISLSE:    op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISLSE>(); break;
-        case OpT::ISEQ:     op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISEQ>(); break;
-        case OpT::ISNE:     op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ISNE>(); break;
-        case OpT::ASGN:     op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ASGN>(); break;
-        case OpT::ADDASGN:  op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::ADDASGN>(); break;
-        case OpT::SUBASGN:  op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::SUBASGN>(); break;
-        case OpT::MULASGN:  op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::MULASGN>(); break;
-        case OpT::DIVASGN:  op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::DIVASGN>(); break;
-        case OpT::REMASGN:  op = traits::get_node_info<BinaryOperator, traits::OPERATOR_NAME, BinaryOperator::REMASGN>(); break;
-    }
-    obj[traits::get_node_info<BinaryOperator, traits::FIELD, 0>()] = op;
+    obj[traits::get_node_info<BinaryOperator, traits::FIELD, 0>()] = binary_operator_name(node.type());
     obj[traits::get_node_info<BinaryOperator, traits::FIELD, 1>()] = write(node.larg());
     obj[traits::get_node_info<BinaryOperator, traits::FIELD, 2>()] = write(node.rarg());
     return obj;
 }
 
+template <>
+boost::json::value visit(const ArrayDeclaration& node)
+{
+    auto&& obj = boost::json::object{};
+    obj["kind"] = traits::get_node_info<ArrayDeclaration, traits::NAME>();
+    obj[traits::get_node_info<ArrayDeclaration, traits::FIELD, 0>()] = std::string{node.name()};
+    obj[traits::get_node_info<ArrayDeclaration, traits::FIELD, 1>()] = write(node.value());
+    obj[traits::get_node_info<ArrayDeclaration, traits::FIELD, 2>()] = write(node.size());
+    return obj;
+}
+
+template <>
+boost::json::value visit(const ArrayElement& node)
+{
+    auto&& obj = boost::json::object{};
+    obj["kind"] = traits::get_node_info<ArrayElement, traits::NAME>();
+    obj[traits::get_node_info<ArrayElement, traits::FIELD, 0>()] = std::string{node.name()};
+    obj[traits::get_node_info<ArrayElement, traits::FIELD, 1>()] = write(node.index());
+    return obj;
+}
+
+template <>
+boost::json::value visit(const ArrayAssignment& node)
+{
+    auto&& obj = boost::json::object{};
+    obj["kind"] = traits::get_node_info<ArrayAssignment, traits::NAME>();
+    obj[traits::get_node_info<ArrayAssignment, traits::FIELD, 0>()] = binary_operator_name(node.type());
+    obj[traits::get_node_info<ArrayAssignment, traits::FIELD, 1>()] = std::string{node.name()};
+    obj[traits::get_node_info<ArrayAssignment, traits::FIELD, 2>()] = write(node.index());
+    obj[traits::get_node_info<ArrayAssignment, traits::FIELD, 3>()] = write(node.value());
+    return obj;
+}
+
 template <>
 boost::json::value visit(const While& node)
 {
@@ -213,14 +262,16 @@ boost::json::value write(AST const & ast)
 export
 void write(AST const & ast, std::filesystem::path const & file)
 {
-    auto&& json_ast = write(ast);
+    auto&& timer = stats::Timer{"ast serialization"};
+    auto&& text  = boost::json::serialize(write(ast));
 
     auto&& out = std::ofstream{file};
 
     if(out.fail())
         throw std::runtime_error("No such file: " + file.string() + ".\nFailed write ast in json format.");
     
-    out << boost::json::serialize(json_ast);
+    out << text;
+    stats::count(stats::Counter::BYTES_WRITTEN, text.size());
 
     out.close();
 }
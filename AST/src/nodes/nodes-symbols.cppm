@@ -0,0 +1,163 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+export module node_symbols;
+
+namespace last::node
+{
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* one interned string: text is stored in the table, id is its index there */
+struct SymbolEntry
+{
+    std::string_view name;
+    uint32_t         id;
+};
+
+class Symbols;
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/*
+name of variable or value of string literal, interned in the symbol table of its tree.
+it`s one pointer: copying is free, and equal strings of one table are the same symbol,
+so nametables compare symbols and hash their ids instead of strings.
+*/
+export
+class Symbol final
+{
+private:
+    SymbolEntry const* entry_ = nullptr;
+
+    explicit Symbol(SymbolEntry const* entry) noexcept : entry_(entry) {}
+
+    friend class Symbols;
+
+public:
+    Symbol() = default;
+
+    /* ids of one table are 0, 1, 2, ... in order of interning */
+    uint32_t id() const noexcept
+    { return entry_ ? entry_->id : UINT32_MAX; }
+
+    std::string_view name() const noexcept
+    { return entry_ ? entry_->name : std::string_view{}; }
+
+    friend bool operator==(Symbol lhs, Symbol rhs) noexcept
+    { return lhs.entry_ == rhs.entry_; }
+};
+
+/* for unordered containers: ids are small and unique in one table */
+export
+struct SymbolHash
+{
+    size_t operator()(Symbol symbol) const noexcept
+    { return symbol.id(); }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/*
+symbol table of one tree (last::AST owns it, like the arena of its nodes).
+while Symbols::Use object is alive, names of nodes created in this thread from strings are interned in this table.
+nodes created outside of any table (tests, hand made trees) use the table of process, which is never released.
+*/
+export
+class Symbols final
+{
+private:
+    static constexpr size_t INITIAL_SIZE = 16 * 1024;
+
+    std::pmr::monotonic_buffer_resource text_{INITIAL_SIZE};
+    std::deque<SymbolEntry> entries_; /* deque: entries never move, symbols point to them */
+    std::unordered_map<std::string_view, SymbolEntry const*> index_;
+
+    static inline thread_local Symbols* current_ = nullptr;
+
+public:
+    Symbols() = default;
+    Symbols(Symbols const &) = delete;
+    Symbols& operator=(Symbols const &) = delete;
+
+    Symbol intern(std::string_view name)
+    {
+        if (auto&& found = index_.find(name); found != index_.end())
+            return Symbol{found->second};
+
+        if (entries_.size() == UINT32_MAX)
+            throw std::runtime_error("too many symbols in one tree");
+
+        auto* text = static_cast<char*>(text_.allocate(name.size() + 1, 1));
+        std::memcpy(text, name.data(), name.size());
+        text[name.size()] = '\0';
+
+        auto&& entry = entries_.emplace_back(SymbolEntry{std::string_view{text, name.size()}, static_cast<uint32_t>(entries_.size())});
+        index_.emplace(entry.name, &entry);
+        return Symbol{&entry};
+    }
+
+    std::optional<Symbol> find(std::string_view name) const
+    {
+        auto&& found = index_.find(name);
+        if (found == index_.end()) return std::nullopt;
+        return Symbol{found->second};
+    }
+
+    Symbol at(uint32_t id) const
+    {
+        if (id >= entries_.size())
+            throw std::out_of_range("symbol id " + std::to_string(id) + " is out of table");
+        return Symbol{&entries_[id]};
+    }
+
+    size_t size() const noexcept
+    { return entries_.size(); }
+
+public:
+    static Symbols* current() noexcept
+    { return current_; }
+
+    /* in the current table of this thread or in the table of process */
+    static Symbol intern_current(std::string_view name)
+    {
+        if (current_) return current_->intern(name);
+
+        static auto&& mutex = std::mutex{};
+        static auto* process = new Symbols{}; /* not destroyed: nodes of static objects may refer to it */
+
+        auto&& lock = std::lock_guard{mutex};
+        return process->intern(name);
+    }
+
+    /* nullptr: table of process */
+    class Use final
+    {
+    private:
+        Symbols* previous_;
+    public:
+        explicit Use(Symbols* symbols) noexcept : previous_(current_)
+        { current_ = symbols; }
+
+        ~Use()
+        { current_ = previous_; }
+
+        Use(Use const &) = delete;
+        Use& operator=(Use const &) = delete;
+    };
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+} /* namespace last::node */
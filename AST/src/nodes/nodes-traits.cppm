@@ -407,6 +407,123 @@ struct NodeTraits<BinaryOperator, NodeInfo::OPERATOR_NAME, BinaryOperator::REMAS
 };
 
 
+//--------------------------------------------------------------------------------------------------------------------------------------
+// ARRAY DECLARATION
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+template <>
+struct NodeTraits<ArrayDeclaration, NodeInfo::NAME>
+{
+    using type = const char *;
+    static constexpr type value = STRINGIFY(ArrayDeclaration);
+};
+
+template <>
+struct NodeTraits<ArrayDeclaration, NodeInfo::FIELDS>
+{
+    using type = size_t;
+    static constexpr type value = 3;
+};
+
+template <>
+struct NodeTraits<ArrayDeclaration, NodeInfo::FIELD, 0>
+{
+    using type = const char *;
+    static constexpr type value = "name";
+};
+
+template <>
+struct NodeTraits<ArrayDeclaration, NodeInfo::FIELD, 1>
+{
+    using type = const char *;
+    static constexpr type value = "value";
+};
+
+template <>
+struct NodeTraits<ArrayDeclaration, NodeInfo::FIELD, 2>
+{
+    using type = const char *;
+    static constexpr type value = "size";
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+// ARRAY ELEMENT
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+template <>
+struct NodeTraits<ArrayElement, NodeInfo::NAME>
+{
+    using type = const char *;
+    static constexpr type value = STRINGIFY(ArrayElement);
+};
+
+template <>
+struct NodeTraits<ArrayElement, NodeInfo::FIELDS>
+{
+    using type = size_t;
+    static constexpr type value = 2;
+};
+
+template <>
+struct NodeTraits<ArrayElement, NodeInfo::FIELD, 0>
+{
+    using type = const char *;
+    static constexpr type value = "name";
+};
+
+template <>
+struct NodeTraits<ArrayElement, NodeInfo::FIELD, 1>
+{
+    using type = const char *;
+    static constexpr type value = "index";
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+// ARRAY ASSIGNMENT (operator names are the same as of BinaryOperator)
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+template <>
+struct NodeTraits<ArrayAssignment, NodeInfo::NAME>
+{
+    using type = const char *;
+    static constexpr type value = STRINGIFY(ArrayAssignment);
+};
+
+template <>
+struct NodeTraits<ArrayAssignment, NodeInfo::FIELDS>
+{
+    using type = size_t;
+    static constexpr type value = 4;
+};
+
+template <>
+struct NodeTraits<ArrayAssignment, NodeInfo::FIELD, 0>
+{
+    using type = const char *;
+    static constexpr type value = "type";
+};
+
+template <>
+struct NodeTraits<ArrayAssignment, NodeInfo::FIELD, 1>
+{
+    using type = const char *;
+    static constexpr type value = "name";
+};
+
+template <>
+struct NodeTraits<ArrayAssignment, NodeInfo::FIELD, 2>
+{
+    using type = const char *;
+    static constexpr type value = "index";
+};
+
+template <>
+struct NodeTraits<ArrayAssignment, NodeInfo::FIELD, 3>
+{
+    using type = const char *;
+    static constexpr type value = "value";
+};
+
 //--------------------------------------------------------------------------------------------------------------------------------------
 // WHILE
 //--------------------------------------------------------------------------------------------------------------------------------------
@@ -1,14 +1,22 @@
 module;
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
 #include <stdexcept>
-#include <any>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <typeinfo>
 
 export module node_type_erasure;
 
+import last_stats;
+
 namespace last::node
 {
 
@@ -25,21 +33,149 @@ ReturnT visit(NodeT const &, Args...)
 
 //--------------------------------------------------------------------------------------------------------------------------------------
 
+/* position in source: lines and columns are counted from 1, line 0 - position is unknown */
+export
+struct Position
+{
+    uint32_t line   = 0;
+    uint32_t column = 0;
+};
+
+/*
+text of node in source: [begin, end), like yy::location of parser.
+nodes, which are not parsed from source (built by optimizer, tests, etc.), may have no location.
+*/
+export
+struct Location
+{
+    Position begin;
+    Position end;
+
+    bool empty() const noexcept
+    { return begin.line == 0; }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/*
+bump allocator for nodes.
+while Arena::Use object is alive, every node created in this thread is placed in the arena.
+memory is released only with the arena, so the arena must outlive all its nodes
+(last::AST owns the arena of its tree).
+*/
+export
+class Arena final
+{
+private:
+    static constexpr size_t INITIAL_SIZE = 64 * 1024;
+
+    std::pmr::monotonic_buffer_resource memory_{INITIAL_SIZE};
+    static inline thread_local Arena* current_ = nullptr;
+
+public:
+    Arena() = default;
+    Arena(Arena const &) = delete;
+    Arena& operator=(Arena const &) = delete;
+
+    void* allocate(size_t size, size_t alignment)
+    { return memory_.allocate(size, alignment); }
+
+    static Arena* current() noexcept
+    { return current_; }
+
+    class Use final
+    {
+    private:
+        Arena* previous_;
+    public:
+        explicit Use(Arena& arena) noexcept : previous_(current_)
+        { current_ = &arena; }
+
+        ~Use()
+        { current_ = previous_; }
+
+        Use(Use const &) = delete;
+        Use& operator=(Use const &) = delete;
+    };
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
 export
 class BasicNode
 {
 private:
     struct IBaseNode
     {
+        size_t      tag_;      /* index in dispatch tables, the same for all nodes with the same NodeImpl type */
+        char const* type_key_; /* unique address for every NodeT: is_a without typeid */
+        bool        in_arena_ = false;
+        Location    location_;
+
+        IBaseNode(size_t tag, char const* type_key) : tag_(tag), type_key_(type_key) {}
         virtual ~IBaseNode() = default;
-        virtual std::unique_ptr<IBaseNode> clone_() const = 0;
+        virtual IBaseNode* clone_() const = 0;
+    };
+
+    /* nodes from arena are only destroyed: their memory belongs to arena */
+    struct Deleter
+    {
+        void operator()(IBaseNode* node) const noexcept
+        {
+            if (not node->in_arena_)
+                return delete node;
+
+            node->~IBaseNode();
+        }
+    };
+
+    /* places new node in the current arena (if it is) or in heap */
+    template <typename ImplT, typename... Args>
+    static IBaseNode* allocate_(Args&&... args)
+    {
+        auto* arena = Arena::current();
+
+        auto* node = arena ? new (arena->allocate(sizeof(ImplT), alignof(ImplT))) ImplT(std::forward<Args>(args)...)
+                           : new ImplT(std::forward<Args>(args)...);
+
+        /* clone copies the flag of the original node, so set it in both cases */
+        node->in_arena_ = (arena != nullptr);
+        return node;
+    }
+
+    /*
+    dispatch table for one signature: tag of node -> function, which calls visit specialization.
+    it`s filled, when the first node of some NodeImpl type is created.
+    array is constant initialized, so it can be used from static initializers and never reallocates.
+    */
+    static constexpr size_t MAX_NODE_TAGS = 256;
 
-        virtual std::type_info const & type_() const = 0;
+    template <typename Signature>
+    struct Table;
 
-        virtual std::any invoke_(const std::type_info& sig, std::any* args) const = 0;
-        virtual bool supports_signature_(const std::type_info& sig) const = 0;
+    template <typename ReturnT, typename... Args>
+    struct Table<ReturnT(Args...)>
+    {
+        using Function = ReturnT(*)(IBaseNode const &, Args...);
+        static inline std::array<Function, MAX_NODE_TAGS> functions{};
     };
 
+    template <typename NodeT>
+    static constexpr char node_type_key_ = 0;
+
+    static size_t new_tag_()
+    {
+        static auto&& mutex = std::mutex{};
+        static size_t tags = 0;
+
+        auto&& lock = std::lock_guard{mutex};
+
+        if (tags == MAX_NODE_TAGS)
+            throw std::runtime_error("too many node types: increase BasicNode::MAX_NODE_TAGS");
+
+        return tags++;
+    }
+
     template<typename NodeT, typename... Signatures>
     requires (std::is_function_v<Signatures> && ...)
     struct NodeImpl final : public IBaseNode
@@ -52,116 +188,43 @@ private:
         template<typename ReturnT, typename... Args>
         struct Invoker<ReturnT(Args...)>
         {
-            static std::any call_(const NodeT& data, std::any* args) try
-            { return call_impl_(data, args, std::index_sequence_for<Args...>{}); }
-            catch (const std::bad_any_cast& e)
+            static ReturnT call_(IBaseNode const & self, Args... args)
             {
-                throw std::runtime_error(
-                    std::string("Type mismatch in arguments for signature ") + 
-                    typeid(ReturnT(Args...)).name() + ": " + e.what()
+                return visit_specializations::template visit<NodeT, ReturnT, Args...>(
+                    static_cast<NodeImpl const &>(self).data_,
+                    std::forward<Args>(args)...
                 );
             }
-
-            template<typename T>
-            static T unwrap_arg_(const std::any& arg)
-            {
-                if constexpr (std::is_reference_v<T>)
-                {
-                    using WrappedType = std::reference_wrapper<std::remove_reference_t<T>>;
-                    auto&& wrapper = std::any_cast<WrappedType&>(const_cast<std::any&>(arg));
-                    return wrapper.get();
-                }
-                else
-                    return std::any_cast<T>(arg);
-            }
-
-            template<size_t... Is>
-            static std::any call_impl_(const NodeT& data, std::any* args, std::index_sequence<Is...>)
-            {
-                if constexpr (std::is_void_v<ReturnT>)
-                {
-                    visit_specializations::template visit<NodeT, ReturnT, Args...>(
-                        data, 
-                        unwrap_arg_<Args>(args[Is])...
-                    );
-                    return std::any{};
-                }
-                else
-                {
-                    auto&& result = visit_specializations::template visit<NodeT, ReturnT, Args...>(
-                        data, 
-                        unwrap_arg_<Args>(args[Is])...
-                    );
-                    return std::any(std::move(result));
-                }
-            }
         };
 
-        std::type_info const & type_() const override
-        { return typeid(NodeT); }
-
-        template<size_t... Is>
-        bool supports_signature_impl_(const std::type_info& sig, std::index_sequence<Is...>) const
-        {
-            bool supported = false;
-            ((typeid(Signatures) == sig ? (supported = true) : false), ...);
-            return supported;
-        }
-
-        template<size_t... Is>
-        std::any invoke_impl_(const std::type_info& sig, std::any* args,
-                             std::index_sequence<Is...>) const
+        /* registers NodeImpl in dispatch tables of all its signatures only once */
+        static size_t tag_of_type_()
         {
-            std::any result;
-            auto&& found = false;
-
-            ((typeid(Signatures) == sig ? 
-              (found = true, result = invoke_one_<Signatures>(args)) : 
-              false), ...);
-
-            if (found) return result;
+            static auto const tag = []
+            {
+                auto&& tag = new_tag_();
+                ((Table<Signatures>::functions[tag] = &Invoker<Signatures>::call_), ...);
+                return tag;
+            }();
 
-            std::string supported;
-            ((supported += typeid(Signatures).name(), supported += " "), ...);
-            throw std::runtime_error(
-                std::string("Signature ") + sig.name() + 
-                " was not register for this node. supported:: " + supported
-            );
+            return tag;
         }
 
-        template<typename Signature>
-        std::any invoke_one_(std::any* args) const
-        { return Invoker<Signature>::call_(data_, args); }
-
     public:
-        explicit NodeImpl(NodeT&& node) : data_(std::forward<NodeT>(node)) {}
+        explicit NodeImpl(NodeT&& node) :
+        IBaseNode(tag_of_type_(), &node_type_key_<NodeT>), data_(std::forward<NodeT>(node)) {}
 
-        std::unique_ptr<IBaseNode> clone_() const override
+        /* children are copied by copy ctor of data_, so every node of subtree is counted */
+        IBaseNode* clone_() const override
         {
-            return std::unique_ptr<IBaseNode>(
-                std::make_unique<NodeImpl>(*this).release()
-            );
+            stats::count(stats::Counter::NODES_CLONED);
+            return allocate_<NodeImpl>(*this);
         }
-
-        std::any invoke_(const std::type_info& sig, std::any* args) const override
-        { return invoke_impl_(sig, args, std::index_sequence_for<Signatures...>{}); }
-
-        bool supports_signature_(const std::type_info& sig) const override
-        { return supports_signature_impl_(sig, std::index_sequence_for<Signatures...>{}); }
     };
 
-    std::unique_ptr<IBaseNode> self_ = nullptr;
+    std::unique_ptr<IBaseNode, Deleter> self_ = nullptr;
 
-    explicit BasicNode(std::unique_ptr<IBaseNode> self) : self_(std::move(self)) {}
-
-    template<typename T>
-    static std::any pack_arg_(T&& arg)
-    {
-        if constexpr (std::is_lvalue_reference_v<T>)
-            return std::ref(arg);
-        else
-            return std::any(std::forward<T>(arg));
-    }
+    explicit BasicNode(IBaseNode* self) : self_(self) {}
 
 public:
     /*
@@ -177,8 +240,8 @@ public:
         template<typename NodeT>
         static BasicNode create(NodeT&& node)
         {
-            auto&& impl = std::make_unique<NodeImpl<NodeT, Signatures...>>(std::forward<NodeT>(node));
-            return BasicNode(std::unique_ptr<IBaseNode>(impl.release()));
+            stats::count(stats::Counter::NODES_CREATED);
+            return BasicNode(allocate_<NodeImpl<NodeT, Signatures...>>(std::forward<NodeT>(node)));
         }
     };
 
@@ -189,40 +252,21 @@ public:
     template<typename ReturnT, typename... Args>
     friend ReturnT visit(BasicNode const & node, Args... args)
     {
-        if (not node.self_)
+        if (not node.self_) [[unlikely]]
             throw std::runtime_error("visite node, which is not constructible (node.self_ is nullptr)");
 
         using SignatureT = ReturnT(Args...);
 
-        if (not node.self_->supports_signature_(typeid(SignatureT))) 
+        auto&& function = Table<SignatureT>::functions[node.self_->tag_];
+
+        if (not function) [[unlikely]]
         {
             throw std::runtime_error(
                 std::string("This node dont support this function: ") + typeid(SignatureT).name()
             );
         }
 
-        std::any arg_array[] = {pack_arg_(std::forward<Args>(args))...};
-        auto&& result = node.self_->invoke_(
-            typeid(SignatureT),
-            arg_array
-        );
-
-        if constexpr (not std::is_void_v<ReturnT>)
-        {
-        try
-        {
-            return std::any_cast<ReturnT>(result);
-        }
-        catch (const std::bad_any_cast& e)
-        {
-            throw std::runtime_error(
-                std::string("Return type mismatch: expected ") + 
-                typeid(ReturnT).name() + 
-                " but got " + 
-                result.type().name()
-            );
-        }
-        }
+        return function(*node.self_, std::forward<Args>(args)...);
     }
 
     /*
@@ -233,6 +277,7 @@ public:
     BasicNode() = default;
 
     /* copy ctor/assign */
+    /* deep copy of the subtree. tree is moved everywhere, where it`s possible */
     BasicNode(BasicNode const& other) 
         : self_(other.self_ ? other.self_->clone_() : nullptr)
     {}
@@ -240,7 +285,7 @@ public:
     BasicNode& operator=(BasicNode const& other)
     {
         if (this == &other) return *this;
-        self_ = other.self_ ? other.self_->clone_() : nullptr;
+        self_.reset(other.self_ ? other.self_->clone_() : nullptr);
         return *this;
     }
 
@@ -256,13 +301,25 @@ public:
     {
         return
             (self_) and
-            (self_->supports_signature_(typeid(Signatures)) && ...);
+            ((Table<Signatures>::functions[self_->tag_] != nullptr) && ...);
     }
 
     /* check is the real node type T */
     template <typename T>
     bool is_a() const
-    { return (typeid(T) == self_->type_()); }
+    { return (self_->type_key_ == &node_type_key_<T>); }
+
+    /* location of node in source: it isn`t a part of node data, so visit functions don`t see it */
+    Location location() const noexcept
+    { return self_ ? self_->location_ : Location{}; }
+
+    void set_location(Location const & location)
+    {
+        if (not self_)
+            throw std::runtime_error("set location of node, which is not constructible (node.self_ is nullptr)");
+
+        self_->location_ = location;
+    }
 
     /* check that self is not nullptr */
     /* implicit */ operator bool() const noexcept
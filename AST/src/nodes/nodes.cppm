@@ -2,6 +2,9 @@ module;
 
 #include <utility>
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -11,31 +14,223 @@ module;
 export module ast_nodes;
 
 export import node_type_erasure;
+export import node_symbols;
 
 namespace last::node
 {
 
 //--------------------------------------------------------------------------------------------------------------------------------------
 
+/*
+children of Scope, Print and Condition: contiguous array of nodes with 32-bit size and capacity.
+like nodes, the array takes memory from the current arena (see Arena::Use) or from heap,
+so a tree of read or parser is in arena together with its lists of statements.
+arena doesn`t reuse memory, so growth leaves the old array in it: reserve, when the count is known,
+or collect nodes in std::vector and move them here.
+TODO: children of arena trees as 32-bit index spans. element is an 8-byte owning BasicNode for now:
+an index is resolved only through the arena, and trees outlive Arena::Use, so Children would have to keep the arena itself.
+*/
 export
-class Scope final : private std::vector<BasicNode>
+class Children
 {
+private:
+    BasicNode* data_     = nullptr;
+    uint32_t   size_     = 0;
+    uint32_t   capacity_ : 31 = 0;
+    uint32_t   in_arena_ : 1  = 0;
+
+    static constexpr size_t MAX_SIZE = (size_t{1} << 31) - 1;
+
+    /* storage for count nodes without constructing them */
+    static BasicNode* allocate_(size_t count, bool& in_arena)
+    {
+        if (count > MAX_SIZE)
+            throw std::length_error("too many children of node: " + std::to_string(count));
+
+        auto* arena = Arena::current();
+        in_arena = (arena != nullptr);
+
+        auto* memory = arena ? arena->allocate(count * sizeof(BasicNode), alignof(BasicNode))
+                             : ::operator new(count * sizeof(BasicNode));
+
+        return static_cast<BasicNode*>(memory);
+    }
+
+    void release_() noexcept
+    {
+        for (auto&& it = uint32_t{0}; it != size_; ++it)
+            data_[it].~BasicNode();
+
+        if (not in_arena_)
+            ::operator delete(data_);
+    }
+
+    /* moves nodes to new storage. new node (if any) is constructed first: args may refer to the old ones */
+    template <typename... Args>
+    void reallocate_(size_t capacity, Args&&... args)
+    {
+        auto&& in_arena = false;
+        auto* data = allocate_(capacity, in_arena);
+
+        if constexpr (sizeof...(Args) > 0)
+        {
+            try
+            {
+                new (data + size_) BasicNode(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                if (not in_arena) ::operator delete(data);
+                throw;
+            }
+        }
+
+        for (auto&& it = uint32_t{0}; it != size_; ++it)
+            new (data + it) BasicNode(std::move(data_[it]));
+
+        auto&& size = size_;
+        release_();
+
+        data_     = data;
+        size_     = size;
+        capacity_ = static_cast<uint32_t>(capacity);
+        in_arena_ = in_arena;
+    }
+
+    template <typename It>
+    void copy_(It first, size_t count)
+    {
+        if (count == 0) return;
+
+        reallocate_(count);
+        for (; size_ != count; ++size_, ++first)
+            new (data_ + size_) BasicNode(*first);
+    }
+
 public:
-    using std::vector<BasicNode>::emplace_back;
-    using std::vector<BasicNode>::push_back;
-    using std::vector<BasicNode>::begin;
-    using std::vector<BasicNode>::end;
-    using std::vector<BasicNode>::size;
+    using value_type     = BasicNode;
+    using iterator       = BasicNode*;
+    using const_iterator = BasicNode const*;
+
+    Children() = default;
+
+    explicit Children(size_t size)
+    {
+        if (size == 0) return;
+
+        reallocate_(size);
+        for (; size_ != size; ++size_)
+            new (data_ + size_) BasicNode{};
+    }
+
+    Children(std::vector<BasicNode>&& nodes)
+    {
+        if (nodes.empty()) return;
+
+        reallocate_(nodes.size());
+        for (auto&& node : nodes)
+            new (data_ + size_++) BasicNode(std::move(node));
+    }
+
+    Children(std::vector<BasicNode> const & nodes)
+    { copy_(nodes.begin(), nodes.size()); }
+
+    Children(std::initializer_list<BasicNode> il)
+    { copy_(il.begin(), il.size()); }
+
+    /* deep copy of all children, as copy of BasicNode */
+    Children(Children const & other)
+    { copy_(other.begin(), other.size()); }
+
+    Children(Children&& other) noexcept :
+    data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+    capacity_(other.capacity_), in_arena_(other.in_arena_)
+    { other.capacity_ = 0; }
+
+    Children& operator=(Children other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+
+        /* bit fields are swapped by values */
+        uint32_t capacity = capacity_;
+        uint32_t in_arena = in_arena_;
+        capacity_ = other.capacity_;
+        in_arena_ = other.in_arena_;
+        other.capacity_ = capacity;
+        other.in_arena_ = in_arena;
+
+        return *this;
+    }
+
+    ~Children()
+    { release_(); }
+
+public:
+    void reserve(size_t capacity)
+    {
+        if (capacity > capacity_)
+            reallocate_(capacity);
+    }
+
+    template <typename... Args>
+    BasicNode& emplace_back(Args&&... args)
+    {
+        if (size_ == capacity_)
+            reallocate_(capacity_ ? size_t{capacity_} * 2 : 1, std::forward<Args>(args)...);
+        else
+            new (data_ + size_) BasicNode(std::forward<Args>(args)...);
+
+        return data_[size_++];
+    }
+
+    void push_back(BasicNode const & node)
+    { emplace_back(node); }
+
+    void push_back(BasicNode&& node)
+    { emplace_back(std::move(node)); }
+
+    iterator begin() noexcept { return data_; }
+    iterator end()   noexcept { return data_ + size_; }
+
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end()   const noexcept { return data_ + size_; }
+
+    size_t size() const noexcept
+    { return size_; }
+
+    bool empty() const noexcept
+    { return size_ == 0; }
+
+    BasicNode&       operator[](size_t index)       noexcept { return data_[index]; }
+    BasicNode const& operator[](size_t index) const noexcept { return data_[index]; }
+
+    BasicNode const& front() const noexcept { return data_[0]; }
+    BasicNode const& back()  const noexcept { return data_[size_ - 1]; }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+export
+class Scope final : private Children
+{
+public:
+    using Children::emplace_back;
+    using Children::push_back;
+    using Children::reserve;
+    using Children::begin;
+    using Children::end;
+    using Children::size;
 
 public:
     Scope() = default;
-    Scope(size_t size) : std::vector<BasicNode>(size)
+    Scope(size_t size) : Children(size)
     {}
 
-    Scope(std::vector<BasicNode>&& nodes) : std::vector<BasicNode>(nodes)
+    Scope(std::vector<BasicNode>&& nodes) : Children(std::move(nodes))
     {}
 
-    Scope(std::initializer_list<BasicNode> il) : std::vector<BasicNode>(il)
+    Scope(std::initializer_list<BasicNode> il) : Children(il)
     {}
 };
 
@@ -45,35 +240,43 @@ export
 class Variable final
 {
 private:
-    std::string name_;
+    Symbol name_;
 public:
-    Variable(std::string&& name) : name_(std::move(name)) /* variale must own his value */
+    Variable(Symbol name) noexcept : name_(name)
+    {}
+
+    /* interned in the current symbol table (see Symbols::Use) */
+    Variable(std::string_view name) : name_(Symbols::intern_current(name))
     {}
 public:
     std::string_view name() const & noexcept
+    { return name_.name(); }
+
+    Symbol symbol() const noexcept
     { return name_; }
 };
 
 //--------------------------------------------------------------------------------------------------------------------------------------
 
 export
-class Print final : private std::vector<BasicNode>
+class Print final : private Children
 {
 public:
-    using std::vector<BasicNode>::emplace_back;
-    using std::vector<BasicNode>::push_back;
-    using std::vector<BasicNode>::begin;
-    using std::vector<BasicNode>::end;
-    using std::vector<BasicNode>::size;
-    using std::vector<BasicNode>::operator[];
-    using std::vector<BasicNode>::iterator;
-    using std::vector<BasicNode>::const_iterator;
+    using Children::emplace_back;
+    using Children::push_back;
+    using Children::reserve;
+    using Children::begin;
+    using Children::end;
+    using Children::size;
+    using Children::operator[];
+    using Children::iterator;
+    using Children::const_iterator;
 
 public:
     Print() = default;
-    Print(std::vector<BasicNode>&& args) : std::vector<BasicNode>(std::move(args))
+    Print(std::vector<BasicNode>&& args) : Children(std::move(args))
     {}
-    Print(std::initializer_list<BasicNode> il) : std::vector<BasicNode>(il)
+    Print(std::initializer_list<BasicNode> il) : Children(il)
     {}
 };
 
@@ -196,13 +399,136 @@ export
 class StringLiteral final
 {
 private:
-    std::string value_;
+    Symbol value_;
 public:
-    StringLiteral(std::string&& value) : /* string literal must own his value */
-    value_(value)
+    StringLiteral(Symbol value) noexcept : value_(value)
+    {}
+
+    /* interned in the current symbol table (see Symbols::Use) */
+    StringLiteral(std::string_view value) : value_(Symbols::intern_current(value))
     {}
 public:
     std::string_view value() const & noexcept
+    { return value_.name(); }
+
+    Symbol symbol() const noexcept
+    { return value_; }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/*
+name = repeat(value, size): array of 'size' elements, every one is 'value'.
+elements are stored contiguously. size is an expression, so it may be a literal or '?'.
+*/
+export
+class ArrayDeclaration final
+{
+private:
+    Symbol name_;
+    BasicNode value_;
+    BasicNode size_;
+public:
+    ArrayDeclaration(Symbol name, BasicNode const &value, BasicNode const &size) :
+    name_(name), value_(value), size_(size)
+    {}
+
+    ArrayDeclaration(Symbol name, BasicNode&& value, BasicNode&& size) :
+    name_(name), value_(std::move(value)), size_(std::move(size))
+    {}
+
+    /* interned in the current symbol table (see Symbols::Use) */
+    ArrayDeclaration(std::string_view name, BasicNode&& value, BasicNode&& size) :
+    name_(Symbols::intern_current(name)), value_(std::move(value)), size_(std::move(size))
+    {}
+
+public:
+    std::string_view name() const & noexcept
+    { return name_.name(); }
+
+    Symbol symbol() const noexcept
+    { return name_; }
+
+    BasicNode const &value() const & noexcept
+    { return value_; }
+
+    BasicNode const &size() const & noexcept
+    { return size_; }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* name[index] as expression */
+export
+class ArrayElement final
+{
+private:
+    Symbol name_;
+    BasicNode index_;
+public:
+    ArrayElement(Symbol name, BasicNode const &index) :
+    name_(name), index_(index)
+    {}
+
+    ArrayElement(Symbol name, BasicNode&& index) :
+    name_(name), index_(std::move(index))
+    {}
+
+    /* interned in the current symbol table (see Symbols::Use) */
+    ArrayElement(std::string_view name, BasicNode&& index) :
+    name_(Symbols::intern_current(name)), index_(std::move(index))
+    {}
+
+public:
+    std::string_view name() const & noexcept
+    { return name_.name(); }
+
+    Symbol symbol() const noexcept
+    { return name_; }
+
+    BasicNode const &index() const & noexcept
+    { return index_; }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* name[index] = value, name[index] += value, ... as statement. type is one of BinaryOperator::ASGN ... REMASGN */
+export
+class ArrayAssignment final
+{
+private:
+    Symbol name_;
+    BasicNode index_;
+    BasicNode value_;
+    BinaryOperator::BinaryOperatorT type_;
+public:
+    ArrayAssignment(BinaryOperator::BinaryOperatorT type, Symbol name, BasicNode const &index, BasicNode const &value) :
+    name_(name), index_(index), value_(value), type_(type)
+    {}
+
+    ArrayAssignment(BinaryOperator::BinaryOperatorT type, Symbol name, BasicNode&& index, BasicNode&& value) :
+    name_(name), index_(std::move(index)), value_(std::move(value)), type_(type)
+    {}
+
+    /* interned in the current symbol table (see Symbols::Use) */
+    ArrayAssignment(BinaryOperator::BinaryOperatorT type, std::string_view name, BasicNode&& index, BasicNode&& value) :
+    name_(Symbols::intern_current(name)), index_(std::move(index)), value_(std::move(value)), type_(type)
+    {}
+
+public:
+    BinaryOperator::BinaryOperatorT type() const noexcept
+    { return type_; }
+
+    std::string_view name() const & noexcept
+    { return name_.name(); }
+
+    Symbol symbol() const noexcept
+    { return name_; }
+
+    BasicNode const &index() const & noexcept
+    { return index_; }
+
+    BasicNode const &value() const & noexcept
     { return value_; }
 };
 
@@ -288,7 +614,7 @@ export
 class Condition final
 {
 private:
-    std::vector<BasicNode> ifs_;
+    Children ifs_;
     BasicNode else_;
 public:
     Condition() = default;
@@ -303,7 +629,7 @@ public:
 
 public:
     void add_condition(BasicNode&& condition)
-    { ifs_.push_back(condition); }
+    { ifs_.push_back(std::move(condition)); }
 
     void set_else(BasicNode&& else_а_как_вот_это_назвать)
     { else_ = std::move(else_а_как_вот_это_назвать); }
@@ -312,7 +638,7 @@ public:
     { return else_; }
 public:
 
-    std::vector<BasicNode> const &get_ifs() const & noexcept
+    Children const &get_ifs() const & noexcept
     { return ifs_; }
 
     BasicNode const &get_else() const & noexcept
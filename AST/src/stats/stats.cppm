@@ -0,0 +1,328 @@
+module;
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module last_stats;
+
+/*
+--time-report, --stats and --time-trace of paraclf, paracli and paraclc.
+phases are measured by scoped timers, events are counted by counters. both cost one branch, while nothing is collected.
+options are passed to child processes (--via-files) through environment, so the whole pipeline is measured:
+every process prints its own report, and all of them write events to the same trace.
+*/
+
+namespace last::stats
+{
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+export
+enum class Counter : size_t
+{
+    NODES_CREATED,     /* BasicNode::Actions::create: parser, reader and optimizer */
+    NODES_CLONED,      /* deep copies of BasicNode, node by node */
+    NAMETABLE_LOOKUPS, /* variable is searched by name: resolver of interpreter and nametable of compiler */
+    SCOPES_PUSHED,     /* resolver and runtime nametable of interpreter, nametable of compiler */
+    BYTES_READ,        /* sources and ast files */
+    BYTES_WRITTEN,     /* ast files */
+
+    COUNT
+};
+
+constexpr auto counter_names = std::array<std::string_view, static_cast<size_t>(Counter::COUNT)>{
+    "nodes created", "nodes cloned", "nametable lookups", "scopes pushed", "bytes read", "bytes written"
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* what is collected and where it goes: options of command line */
+export
+struct Options
+{
+    bool        time_report = false; /* phases to stderr at exit */
+    bool        stats       = false; /* counters to stderr at exit */
+    std::string time_trace;          /* chrome trace event json (chrome://tracing, perfetto) */
+};
+
+/* inherited by child processes */
+constexpr auto TIME_REPORT_ENV = "PARACL_TIME_REPORT";
+constexpr auto STATS_ENV       = "PARACL_STATS";
+constexpr auto TIME_TRACE_ENV  = "PARACL_TIME_TRACE";
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* one measured phase: microseconds of steady clock, which is the same for all processes of the machine */
+struct Event
+{
+    std::string_view name;
+    int64_t          start;
+    int64_t          duration;
+    int32_t          thread;
+};
+
+/* set once by start, before any thread is created */
+inline bool collecting_ = false;
+
+inline std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::COUNT)> counters_{};
+
+struct Collector
+{
+    std::mutex         mutex;
+    std::vector<Event> events;
+    Options            options;
+    std::string        tool;
+    int64_t            start = 0;
+};
+
+Collector& collector()
+{
+    static auto&& collector = Collector{};
+    return collector;
+}
+
+int64_t now() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+export
+inline bool collecting() noexcept
+{ return collecting_; }
+
+export
+inline void count(Counter counter, uint64_t value = 1) noexcept
+{
+    if (collecting_) [[unlikely]]
+        counters_[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+void record(std::string_view name, int64_t start, int64_t finish)
+{
+    auto&& state = collector();
+    auto&& lock  = std::lock_guard{state.mutex};
+    state.events.push_back(Event{name, start, finish - start, static_cast<int32_t>(::gettid())});
+}
+
+/* phase from construction to destruction. name must outlive the process (string literal) */
+export
+class Timer final
+{
+  private:
+    std::string_view name_;
+    int64_t          start_ = 0;
+
+  public:
+    explicit Timer(std::string_view name) noexcept :
+    name_(name)
+    {
+        if (collecting_) [[unlikely]] start_ = now();
+    }
+
+    Timer(Timer const &) = delete;
+    Timer& operator=(Timer const &) = delete;
+
+    ~Timer()
+    {
+        if (collecting_) [[unlikely]] record(name_, start_, now());
+    }
+};
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* phases in order of the first call: calls and total time of every one */
+void print_time_report(Collector const & state, int64_t wall)
+{
+    struct Phase
+    {
+        std::string_view name;
+        size_t           calls = 0;
+        int64_t          total = 0;
+    };
+
+    auto&& phases = std::vector<Phase>{};
+
+    for (auto&& event : state.events)
+    {
+        auto&& it = phases.begin();
+        while (it != phases.end() and it->name != event.name) ++it;
+
+        if (it == phases.end()) it = phases.insert(it, Phase{event.name});
+
+        ++it->calls;
+        it->total += event.duration;
+    }
+
+    std::fprintf(stderr, "%s: time report (pid %d)\n", state.tool.c_str(), static_cast<int>(::getpid()));
+    std::fprintf(stderr, "  %-28s %8s %12s %8s\n", "phase", "calls", "total, ms", "share");
+
+    for (auto&& phase : phases)
+    {
+        std::fprintf(stderr, "  %-28.*s %8zu %12.3f %7.1f%%\n", static_cast<int>(phase.name.size()), phase.name.data(),
+                     phase.calls, static_cast<double>(phase.total) / 1000,
+                     (wall == 0) ? 0.0 : 100.0 * static_cast<double>(phase.total) / static_cast<double>(wall));
+    }
+
+    std::fprintf(stderr, "  %-28s %8s %12.3f\n", "wall time", "", static_cast<double>(wall) / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+void print_stats(Collector const & state)
+{
+    std::fprintf(stderr, "%s: stats (pid %d)\n", state.tool.c_str(), static_cast<int>(::getpid()));
+
+    for (auto&& it = size_t{0}; it != counter_names.size(); ++it)
+    {
+        std::fprintf(stderr, "  %-28.*s %20llu\n", static_cast<int>(counter_names[it].size()), counter_names[it].data(),
+                     static_cast<unsigned long long>(counters_[it].load(std::memory_order_relaxed)));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/*
+trace is always a valid json array, which ends with "\n]\n".
+the next process (under lock of the file) replaces this end with its own events, so processes of one pipeline share one timeline.
+*/
+void write_trace(Collector const & state)
+{
+    auto&& pid  = static_cast<int>(::getpid());
+    auto&& json = std::string{};
+
+    auto&& append_event = [&](std::string_view event)
+    {
+        json += json.empty() ? "\n" : ",\n";
+        json += event;
+    };
+
+    auto&& buffer = std::array<char, 512>{};
+
+    std::snprintf(buffer.data(), buffer.size(), R"({"name":"process_name","ph":"M","pid":%d,"tid":%d,"args":{"name":"%s"}})",
+                  pid, pid, state.tool.c_str());
+    append_event(buffer.data());
+
+    for (auto&& event : state.events)
+    {
+        std::snprintf(buffer.data(), buffer.size(),
+                      R"({"name":"%.*s","cat":"%s","ph":"X","ts":%lld,"dur":%lld,"pid":%d,"tid":%d})",
+                      static_cast<int>(event.name.size()), event.name.data(), state.tool.c_str(),
+                      static_cast<long long>(event.start), static_cast<long long>(event.duration), pid, event.thread);
+        append_event(buffer.data());
+    }
+
+    auto&& fd = ::open(state.options.time_trace.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        std::fprintf(stderr, "%s: failed to open time trace '%s'\n", state.tool.c_str(), state.options.time_trace.c_str());
+        return;
+    }
+
+    ::flock(fd, LOCK_EX);
+
+    static constexpr auto end = std::string_view{"\n]\n"};
+
+    struct stat info{};
+    ::fstat(fd, &info);
+
+    auto&& size = static_cast<size_t>(info.st_size);
+    auto&& offset = off_t{0};
+
+    if (size < end.size() + 1)
+        json = "[" + json; /* the first process */
+    else
+    {
+        json = "," + json;
+        offset = static_cast<off_t>(size - end.size());
+    }
+
+    json += end;
+
+    if (::pwrite(fd, json.data(), json.size(), offset) != static_cast<ssize_t>(json.size()))
+        std::fprintf(stderr, "%s: failed to write time trace '%s'\n", state.tool.c_str(), state.options.time_trace.c_str());
+
+    ::close(fd); /* releases the lock */
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+void finish()
+{
+    auto&& state = collector();
+    auto&& wall  = now() - state.start;
+
+    auto&& lock = std::lock_guard{state.mutex};
+
+    if (state.options.time_report)        print_time_report(state, wall);
+    if (state.options.stats)              print_stats(state);
+    if (not state.options.time_trace.empty()) write_trace(state);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/*
+called by main of tool before any work (and any thread).
+options, which are not given, are taken from environment (process is a part of pipeline),
+given ones are put there for child processes. reports are printed and trace is written at exit.
+*/
+export
+void start(std::string_view tool, Options options)
+{
+    auto&& inherited_trace = false;
+
+    if (not options.time_report) options.time_report = (std::getenv(TIME_REPORT_ENV) != nullptr);
+    if (not options.stats)       options.stats       = (std::getenv(STATS_ENV) != nullptr);
+
+    if (options.time_trace.empty())
+    {
+        auto&& trace = std::getenv(TIME_TRACE_ENV);
+        if (trace) options.time_trace = trace;
+        inherited_trace = (trace != nullptr);
+    }
+
+    if (not (options.time_report or options.stats or not options.time_trace.empty())) return;
+
+    if (options.time_report) ::setenv(TIME_REPORT_ENV, "1", 1);
+    if (options.stats)       ::setenv(STATS_ENV, "1", 1);
+
+    if (not options.time_trace.empty() and not inherited_trace)
+    {
+        /* children may work in another directory, and the trace of previous run is dropped */
+        options.time_trace = std::filesystem::absolute(options.time_trace).string();
+        std::filesystem::remove(options.time_trace);
+        ::setenv(TIME_TRACE_ENV, options.time_trace.c_str(), 1);
+    }
+
+    auto&& state = collector();
+    state.options = std::move(options);
+    state.tool    = tool;
+    state.start   = now();
+
+    collecting_ = true;
+
+    /* collector is constructed before registration, so it`s destroyed after finish */
+    std::atexit(finish);
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+} /* namespace last::stats */
@@ -6,6 +6,9 @@ export import node_type_erasure;
 export import ast;
 // export import ast_read;
 export import ast_write;
+export import ast_binary;
 // export import ast_write_2;
 export import ast_graph_dump;
-export import last_info;
\ No newline at end of file
+export import ast_optimizer;
+export import last_info;
+export import last_stats;
\ No newline at end of file
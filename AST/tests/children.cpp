@@ -0,0 +1,149 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <boost/json.hpp>
+#include <boost/json/object.hpp>
+
+import thelast;
+
+
+#include "create-basic-node.hpp"
+#include "expect.hpp"
+
+
+using namespace ::last::node;
+using namespace ::last;
+using ::last::test::expect;
+using ::last::test::failures;
+
+CREATE_SAME(writable, binary_writable)
+#include "read-ast.hpp"
+
+/* children of Scope, Print and Condition: in arena or in heap, after growth, copies and reading of wide trees */
+
+namespace
+{
+
+/* numbers 0, 1, ..., count - 1 in order */
+template <typename ContainerT>
+bool numbers(ContainerT const & children, size_t count)
+{
+    if (children.size() != count) return false;
+
+    auto&& expected = 0;
+    for (auto&& child : children)
+        if (static_cast<NumberLiteral const &>(child).value() != expected++) return false;
+
+    return true;
+}
+
+BasicNode wide_scope(size_t count)
+{
+    auto&& scope = Scope{};
+    for (auto&& it = size_t{0}; it != count; ++it)
+        scope.push_back(create(NumberLiteral{static_cast<int>(it)}));
+
+    return create(std::move(scope));
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+void test_grows_in_arena()
+{
+    auto&& arena = std::make_unique<Arena>();
+    auto&& root = [&arena]
+    {
+        auto&& use_arena = Arena::Use{*arena};
+        return wide_scope(1000);
+    }();
+
+    expect(numbers(static_cast<Scope const &>(root), 1000), "1000 statements pushed to scope in arena");
+}
+
+/* copy of tree is made by the current arena, here heap: it doesn`t refer to the arena of original */
+void test_copy_outlives_arena()
+{
+    auto&& copy = BasicNode{};
+    {
+        auto&& arena = std::make_unique<Arena>();
+        auto&& root = [&arena]
+        {
+            auto&& use_arena = Arena::Use{*arena};
+            return wide_scope(100);
+        }();
+
+        copy = root;
+    }
+
+    expect(numbers(static_cast<Scope const &>(copy), 100), "copy of scope in heap outlives arena of original");
+}
+
+void test_condition_branches()
+{
+    auto&& arena = std::make_unique<Arena>();
+    auto&& use_arena = Arena::Use{*arena};
+
+    auto&& condition = Condition{};
+    for (auto&& it = 0; it != 10; ++it)
+        condition.add_condition(create(If{create(NumberLiteral{it}), create(Scope{})}));
+
+    auto&& ifs = condition.get_ifs();
+    auto&& ok = (ifs.size() == 10);
+    for (auto&& it = size_t{0}; ok and it != ifs.size(); ++it)
+        ok = static_cast<NumberLiteral const &>(static_cast<If const &>(ifs[it]).condition()).value() == static_cast<int>(it);
+
+    expect(ok, "10 branches added to condition in arena");
+}
+
+/* { 0; 1; ...; 4999; print 0, 1, 2; } after json and binary */
+void test_read_wide_tree()
+{
+    auto&& scope = Scope{};
+    for (auto&& it = 0; it != 5000; ++it)
+        scope.push_back(create(NumberLiteral{it}));
+    scope.push_back(create(Print{create(NumberLiteral{0}), create(NumberLiteral{1}), create(NumberLiteral{2})}));
+
+    auto&& ast = AST{create(std::move(scope))};
+
+    for (auto&& [format, file] : { std::pair{"json", "children.json"}, std::pair{"binary", "children.bin"} })
+    {
+        if (std::string_view{format} == "json") write(ast, file);
+        else                                    write_binary(ast, file);
+
+        auto&& read_ast = read(std::filesystem::path{file});
+        auto&& statements = static_cast<Scope const &>(read_ast.root());
+
+        auto&& ok = (statements.size() == 5001);
+        if (ok)
+        {
+            auto&& print = static_cast<Print const &>(*(statements.end() - 1));
+            ok = numbers(print, 3) and numbers(std::vector<BasicNode>{statements.begin(), statements.end() - 1}, 5000);
+        }
+
+        expect(ok, std::string{"5000 statements and print of 3 arguments after "} + format);
+    }
+}
+
+} /* namespace */
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+int main() try
+{
+    test_grows_in_arena();
+    test_copy_outlives_arena();
+    test_condition_branches();
+    test_read_wide_tree();
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (std::exception const & e)
+{
+    std::cerr << "exception: " << e.what() << "\n";
+    return EXIT_FAILURE;
+}
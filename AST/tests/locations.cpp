@@ -0,0 +1,212 @@
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <boost/json.hpp>
+#include <boost/json/object.hpp>
+
+import thelast;
+
+
+#include "create-basic-node.hpp"
+#include "expect.hpp"
+
+
+using namespace ::last::node;
+using namespace ::last;
+using ::last::test::expect;
+using ::last::test::failures;
+
+CREATE_SAME(writable, binary_writable)
+#include "read-ast.hpp"
+
+/* locations of nodes must be the same after writing the tree to json or binary format and reading it back */
+
+namespace
+{
+
+using O = BinaryOperator;
+
+/* every node gets its own place in source, so a location moved to other node is seen too */
+uint32_t next_line = 1;
+
+BasicNode located(BasicNode&& node)
+{
+    node.set_location(Location{.begin = {next_line, 2}, .end = {next_line, 7}});
+    ++next_line;
+    return std::move(node);
+}
+
+/* kinds and locations of nodes in preorder */
+void flatten(BasicNode const & node, std::vector<std::pair<std::string, Location>>& out)
+{
+    if (not node) return;
+
+    auto&& add = [&out, &node](std::string kind) { out.emplace_back(std::move(kind), node.location()); };
+
+    if (node.is_a<Scope>())
+    {
+        add("scope");
+        for (auto&& statement : static_cast<Scope const &>(node)) flatten(statement, out);
+    }
+    else if (node.is_a<Print>())
+    {
+        add("print");
+        for (auto&& arg : static_cast<Print const &>(node)) flatten(arg, out);
+    }
+    else if (node.is_a<Scan>())          add("scan");
+    else if (node.is_a<Variable>())      add("variable " + std::string{static_cast<Variable const &>(node).name()});
+    else if (node.is_a<NumberLiteral>()) add("number " + std::to_string(static_cast<NumberLiteral const &>(node).value()));
+    else if (node.is_a<StringLiteral>()) add("string " + std::string{static_cast<StringLiteral const &>(node).value()});
+    else if (node.is_a<UnaryOperator>())
+    {
+        add("unary");
+        flatten(static_cast<UnaryOperator const &>(node).arg(), out);
+    }
+    else if (node.is_a<BinaryOperator>())
+    {
+        auto&& binary = static_cast<BinaryOperator const &>(node);
+        add("binary " + std::to_string(binary.type()));
+        flatten(binary.larg(), out);
+        flatten(binary.rarg(), out);
+    }
+    else if (node.is_a<ArrayDeclaration>())
+    {
+        auto&& declaration = static_cast<ArrayDeclaration const &>(node);
+        add("array " + std::string{declaration.name()});
+        flatten(declaration.value(), out);
+        flatten(declaration.size(), out);
+    }
+    else if (node.is_a<ArrayElement>())
+    {
+        add("element");
+        flatten(static_cast<ArrayElement const &>(node).index(), out);
+    }
+    else if (node.is_a<ArrayAssignment>())
+    {
+        auto&& assignment = static_cast<ArrayAssignment const &>(node);
+        add("element assignment");
+        flatten(assignment.index(), out);
+        flatten(assignment.value(), out);
+    }
+    else if (node.is_a<While>())
+    {
+        auto&& loop = static_cast<While const &>(node);
+        add("while");
+        flatten(loop.condition(), out);
+        flatten(loop.body(), out);
+    }
+    else if (node.is_a<If>())
+    {
+        auto&& if_statement = static_cast<If const &>(node);
+        add("if");
+        flatten(if_statement.condition(), out);
+        flatten(if_statement.body(), out);
+    }
+    else if (node.is_a<Else>())
+    {
+        add("else");
+        flatten(static_cast<Else const &>(node).body(), out);
+    }
+    else if (node.is_a<Condition>())
+    {
+        auto&& condition = static_cast<Condition const &>(node);
+        add("condition");
+        for (auto&& if_node : condition.get_ifs()) flatten(if_node, out);
+        flatten(condition.get_else(), out);
+    }
+    else add("unknown");
+}
+
+/*
+{
+    i = 0;
+    while (i < 3) { a[i] = ?; i += 1; }
+    if (-i) print "x", a[0]; else print i;
+}
+nodes without location are mixed in: they must stay without it.
+*/
+BasicNode program()
+{
+    auto&& counter = located(create(BinaryOperator{O::ASGN, located(create(Variable{"i"})), located(create(NumberLiteral{0}))}));
+    auto&& array   = located(create(ArrayDeclaration{"a", located(create(NumberLiteral{0})), located(create(NumberLiteral{3}))}));
+
+    auto&& body = located(create(Scope{
+        located(create(ArrayAssignment{O::ASGN, "a", located(create(Variable{"i"})), located(create(Scan{}))})),
+        located(create(BinaryOperator{O::ADDASGN, located(create(Variable{"i"})), create(NumberLiteral{1})})),
+    }));
+
+    auto&& loop = located(create(While{located(create(BinaryOperator{O::ISLS, located(create(Variable{"i"})), located(create(NumberLiteral{3}))})),
+                                       std::move(body)}));
+
+    auto&& then = located(create(Print{located(create(StringLiteral{"x"})), located(create(ArrayElement{"a", create(NumberLiteral{0})}))}));
+    auto&& if_node = located(create(If{located(create(UnaryOperator{UnaryOperator::MINUS, located(create(Variable{"i"}))})), std::move(then)}));
+    auto&& else_node = located(create(Else{create(Print{located(create(Variable{"i"}))})}));
+
+    auto&& condition = located(create(Condition{{std::move(if_node)}, std::move(else_node)}));
+
+    return create(Scope{std::move(counter), std::move(array), std::move(loop), std::move(condition)});
+}
+
+bool same(std::vector<std::pair<std::string, Location>> const & expected, std::vector<std::pair<std::string, Location>> const & actual)
+{
+    if (expected.size() != actual.size())
+    {
+        std::cout << "  " << expected.size() << " nodes are expected, " << actual.size() << " are read\n";
+        return false;
+    }
+
+    auto&& result = true;
+
+    for (auto&& it = size_t{0}; it != expected.size(); ++it)
+    {
+        auto&& [kind, location] = expected[it];
+        auto&& [read_kind, read_location] = actual[it];
+
+        auto&& equal = kind == read_kind
+                       and location.begin.line == read_location.begin.line and location.begin.column == read_location.begin.column
+                       and location.end.line   == read_location.end.line   and location.end.column   == read_location.end.column;
+
+        if (equal) continue;
+
+        std::cout << "  node " << it << ": " << kind << " at " << location.begin.line << ":" << location.begin.column
+                  << ", read " << read_kind << " at " << read_location.begin.line << ":" << read_location.begin.column << "\n";
+        result = false;
+    }
+
+    return result;
+}
+
+} /* namespace */
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+int main() try
+{
+    auto&& ast = AST{program()};
+
+    auto&& expected = std::vector<std::pair<std::string, Location>>{};
+    flatten(ast.root(), expected);
+
+    for (auto&& [format, file] : { std::pair{"json", "locations.json"}, std::pair{"binary", "locations.bin"} })
+    {
+        if (std::string_view{format} == "json") write(ast, file);
+        else                                    write_binary(ast, file);
+
+        auto&& actual = std::vector<std::pair<std::string, Location>>{};
+        flatten(read(std::filesystem::path{file}).root(), actual);
+
+        expect(same(expected, actual), "locations of " + std::to_string(expected.size()) + " nodes after " + format);
+    }
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (std::exception const & e)
+{
+    std::cerr << "exception: " << e.what() << "\n";
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,284 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <boost/json.hpp>
+
+import thelast;
+
+
+#include "create-basic-node.hpp"
+#include "expect.hpp"
+
+
+using namespace ::last::node;
+using namespace ::last;
+using ::last::test::expect;
+using ::last::test::failures;
+
+CREATE_SAME(writable, binary_writable)
+
+/* unit tests of passes of last::optimizer: every test builds a tree, runs one pass and looks at the result */
+
+namespace
+{
+
+struct Factory
+{
+    template <typename NodeT>
+    static BasicNode create(NodeT node)
+    { return last::node::create(std::move(node)); }
+};
+
+using O = BinaryOperator;
+
+BasicNode variable(std::string_view name)
+{ return create(Variable{name}); }
+
+BasicNode number(int value)
+{ return create(NumberLiteral{value}); }
+
+BasicNode binary(O::BinaryOperatorT type, BasicNode&& left, BasicNode&& right)
+{ return create(BinaryOperator{type, std::move(left), std::move(right)}); }
+
+BasicNode assign(std::string_view name, BasicNode&& value)
+{ return binary(O::ASGN, variable(name), std::move(value)); }
+
+BasicNode scope(std::vector<BasicNode>&& statements)
+{ return create(Scope{std::move(statements)}); }
+
+BasicNode loop(BasicNode&& condition, std::vector<BasicNode>&& body)
+{ return create(While{std::move(condition), scope(std::move(body))}); }
+
+BasicNode condition(BasicNode&& condition, std::vector<BasicNode>&& body)
+{ return create(Condition{{create(If{std::move(condition), scope(std::move(body))})}, BasicNode{}}); }
+
+BasicNode print(BasicNode&& arg)
+{
+    auto&& args = std::vector<BasicNode>{};
+    args.push_back(std::move(arg));
+    return create(Print{std::move(args)});
+}
+
+BasicNode hoist(BasicNode const & root)
+{ return optimizer::LoopInvariantHoisting<Factory>{}.run(root); }
+
+BasicNode fold(BasicNode const & root)
+{ return optimizer::ConstantFolding<Factory>{}.run(root); }
+
+BasicNode simplify(BasicNode const & root)
+{ return optimizer::AlgebraicSimplification<Factory>{}.run(root); }
+
+BasicNode eliminate(BasicNode const & root)
+{ return optimizer::DeadCodeElimination<Factory>{}.run(root); }
+
+/* n = ?; n and (q = 1); - q is declared, but not definitely assigned */
+std::vector<BasicNode> declare_q(std::vector<BasicNode>&& rest)
+{
+    auto&& statements = std::vector<BasicNode>{};
+    statements.push_back(assign("n", create(Scan{})));
+    statements.push_back(binary(O::AND, variable("n"), assign("q", number(1))));
+    for (auto&& statement : rest) statements.push_back(std::move(statement));
+
+    return statements;
+}
+
+/* argument of print, which is the last statement of scope */
+BasicNode const & printed(BasicNode const & node)
+{
+    auto&& statements = static_cast<Scope const &>(node);
+    return *static_cast<Print const &>(*(statements.end() - 1)).begin();
+}
+
+/* number of assignments to temporaries of hoisting among the statements of scope */
+size_t hoisted(BasicNode const & node)
+{
+    auto&& count = size_t{0};
+
+    for (auto&& statement : static_cast<Scope const &>(node))
+    {
+        if (not statement.is_a<BinaryOperator>()) continue;
+
+        auto&& assignment = static_cast<BinaryOperator const &>(statement);
+        if (assignment.type() == O::ASGN and static_cast<Variable const &>(assignment.larg()).name().starts_with("licm."))
+            ++count;
+    }
+
+    return count;
+}
+
+/* body of the first while among the statements of scope */
+BasicNode const & body_of_loop(BasicNode const & node)
+{
+    for (auto&& statement : static_cast<Scope const &>(node))
+        if (statement.is_a<While>()) return static_cast<While const &>(statement).body();
+
+    throw std::runtime_error("no while in scope");
+}
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+/* m = 3; i = 0; while (i < 5) { s = m * 2; i += 1; } */
+void test_hoists_invariant()
+{
+    auto&& root = hoist(scope({
+        assign("m", number(3)),
+        assign("i", number(0)),
+        loop(binary(O::ISLS, variable("i"), number(5)), {
+            assign("s", binary(O::MUL, variable("m"), number(2))),
+            binary(O::ADDASGN, variable("i"), number(1)),
+        }),
+    }));
+
+    expect(hoisted(root) == 1, "m * 2 is hoisted");
+}
+
+/* n = ?; n and (q = 1); i = 0; while (i < n) { i = i + q * 2; } */
+void test_keeps_not_assigned_in_and()
+{
+    auto&& root = hoist(scope({
+        assign("n", create(Scan{})),
+        binary(O::AND, variable("n"), assign("q", number(1))),
+        assign("i", number(0)),
+        loop(binary(O::ISLS, variable("i"), variable("n")), {
+            assign("i", binary(O::ADD, variable("i"), binary(O::MUL, variable("q"), number(2)))),
+        }),
+    }));
+
+    expect(hoisted(root) == 0, "q * 2 is kept: q is assigned only in right of 'and'");
+}
+
+/* n = ?; if (n) { q = 1; } i = 0; while (i < n) { i = i + q * 2; } */
+void test_keeps_assigned_in_branch()
+{
+    auto&& root = hoist(scope({
+        assign("n", create(Scan{})),
+        condition(variable("n"), { assign("q", number(1)) }),
+        assign("i", number(0)),
+        loop(binary(O::ISLS, variable("i"), variable("n")), {
+            assign("i", binary(O::ADD, variable("i"), binary(O::MUL, variable("q"), number(2)))),
+        }),
+    }));
+
+    expect(hoisted(root) == 0, "q * 2 is kept: q is assigned only in body of if");
+}
+
+/* n = ?; i = 0; while (i < n) { q = 1; i += 1; } j = 0; while (j < n) { j = j + q * 2; } */
+void test_keeps_assigned_in_previous_loop()
+{
+    auto&& root = hoist(scope({
+        assign("n", create(Scan{})),
+        assign("i", number(0)),
+        loop(binary(O::ISLS, variable("i"), variable("n")), {
+            assign("q", number(1)),
+            binary(O::ADDASGN, variable("i"), number(1)),
+        }),
+        assign("j", number(0)),
+        loop(binary(O::ISLS, variable("j"), variable("n")), {
+            assign("j", binary(O::ADD, variable("j"), binary(O::MUL, variable("q"), number(2)))),
+        }),
+    }));
+
+    expect(hoisted(root) == 0, "q * 2 is kept: q is assigned only in body of previous loop");
+}
+
+/* n = ?; i = 0; while (i < n) { k = i * 3; j = 0; while (j < n) { j = j + k * 2; } i += 1; } */
+void test_hoists_from_inner_loop_to_outer_body()
+{
+    auto&& root = hoist(scope({
+        assign("n", create(Scan{})),
+        assign("i", number(0)),
+        loop(binary(O::ISLS, variable("i"), variable("n")), {
+            assign("k", binary(O::MUL, variable("i"), number(3))),
+            assign("j", number(0)),
+            loop(binary(O::ISLS, variable("j"), variable("n")), {
+                assign("j", binary(O::ADD, variable("j"), binary(O::MUL, variable("k"), number(2)))),
+            }),
+            binary(O::ADDASGN, variable("i"), number(1)),
+        }),
+    }));
+
+    expect(hoisted(root) == 0, "k * 2 doesn`t leave the outer loop: k is assigned in it");
+    expect(hoisted(body_of_loop(root)) == 1, "k * 2 is hoisted before the inner loop");
+}
+
+/* n = ?; i = 0; while (i < n) { i = i + n / 0; } */
+void test_keeps_trapping_division()
+{
+    auto&& root = hoist(scope({
+        assign("n", create(Scan{})),
+        assign("i", number(0)),
+        loop(binary(O::ISLS, variable("i"), variable("n")), {
+            assign("i", binary(O::ADD, variable("i"), binary(O::DIV, variable("n"), number(0)))),
+        }),
+    }));
+
+    expect(hoisted(root) == 0, "n / 0 is kept: it traps");
+}
+
+/* n = ?; n and (q = 1); print q - q; print q * 0; print q % 1; */
+void test_keeps_reads_of_not_assigned()
+{
+    for (auto&& type : { O::SUB, O::MUL, O::REM })
+    {
+        auto&& right = (type == O::SUB) ? variable("q") : number((type == O::MUL) ? 0 : 1);
+        auto&& root  = simplify(scope(declare_q({ print(binary(type, variable("q"), std::move(right))) })));
+
+        expect(printed(root).is_a<BinaryOperator>(), "operator with q is kept: q may be not assigned, its read traps");
+    }
+}
+
+/* q = 1; print q - q; */
+void test_simplifies_reads_of_assigned()
+{
+    auto&& root = simplify(scope({
+        assign("q", number(1)),
+        print(binary(O::SUB, variable("q"), variable("q"))),
+    }));
+
+    expect(printed(root).is_a<NumberLiteral>(), "q - q is 0: q is assigned");
+}
+
+/* n = ?; n and (q = 1); print q or 1; */
+void test_keeps_not_assigned_in_decided_or()
+{
+    auto&& root = fold(scope(declare_q({ print(binary(O::OR, variable("q"), number(1))) })));
+    expect(printed(root).is_a<BinaryOperator>(), "q or 1 is kept: q may be not assigned");
+}
+
+/* n = ?; n and (q = 1); q; and q = 1; q; */
+void test_keeps_statement_reading_not_assigned()
+{
+    auto&& kept = eliminate(scope(declare_q({ variable("q") })));
+    expect(static_cast<Scope const &>(kept).size() == 3, "statement q is kept: q may be not assigned");
+
+    auto&& dropped = eliminate(scope({ assign("q", number(1)), variable("q") }));
+    expect(static_cast<Scope const &>(dropped).size() == 1, "statement q is removed: q is assigned");
+}
+
+} /* namespace */
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+int main() try
+{
+    test_hoists_invariant();
+    test_keeps_not_assigned_in_and();
+    test_keeps_assigned_in_branch();
+    test_keeps_assigned_in_previous_loop();
+    test_hoists_from_inner_loop_to_outer_body();
+    test_keeps_trapping_division();
+    test_keeps_reads_of_not_assigned();
+    test_simplifies_reads_of_assigned();
+    test_keeps_not_assigned_in_decided_or();
+    test_keeps_statement_reading_not_assigned();
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (std::exception const & e)
+{
+    std::cerr << "exception: " << e.what() << "\n";
+    return EXIT_FAILURE;
+}
@@ -66,6 +66,18 @@ void visit([[maybe_unused]] UnaryOperator const & uo)
 template <>
 void visit([[maybe_unused]] While const & uo)
 { std::cout << "While{}\n";}
+
+template <>
+void visit(ArrayDeclaration const & a)
+{ std::cout << "ArrayDeclaration{" << a.name() << "}" << std::endl; }
+
+template <>
+void visit(ArrayElement const & a)
+{ std::cout << "ArrayElement{" << a.name() << "}" << std::endl; }
+
+template <>
+void visit(ArrayAssignment const & a)
+{ std::cout << "ArrayAssignment{" << a.name() << "}" << std::endl; }
 }
 
 namespace last::node::visit_specializations
@@ -118,12 +130,24 @@ template <>
 void visit(While const & v, int& i)
 { std::cout << "While{" << "} " << ++i << std::endl; }
 
+template <>
+void visit(ArrayDeclaration const & v, int& i)
+{ std::cout << "ArrayDeclaration{" << v.name() << "} " << ++i << std::endl; }
+
+template <>
+void visit(ArrayElement const & v, int& i)
+{ std::cout << "ArrayElement{" << v.name() << "} " << ++i << std::endl; }
+
+template <>
+void visit(ArrayAssignment const & v, int& i)
+{ std::cout << "ArrayAssignment{" << v.name() << "} " << ++i << std::endl; }
+
 }
 
 using printable = void();
 using printable_and_countable = void(int&);
 
-CREATE_SAME(printable, printable_and_countable, writable, dumpable)
+CREATE_SAME(printable, printable_and_countable, writable, dumpable, binary_writable)
 #include "read-ast.hpp"
 
 void print(BasicNode const & node)
@@ -188,6 +212,12 @@ int main() try
     auto&& nast5 = create(Print{n1, n2, n82, n8});
     nast4.push_back(nast5);
 
+    auto&& array = create(ArrayDeclaration{"array", create(NumberLiteral{0}), create(Scan{})});
+    auto&& element = create(ArrayAssignment{BinaryOperator::ADDASGN, "array", create(NumberLiteral{1}), create(ArrayElement{"array", create(NumberLiteral{0})})});
+    print_and_count(element, i);
+    nast4.push_back(array);
+    nast4.push_back(element);
+
     auto&& root = create(std::move(nast4));
     auto&& ast = AST{std::move(root)};
     write(ast, "ast.json");
@@ -197,6 +227,11 @@ int main() try
     write(ast, "ast.2.json");
     dump(readed_ast, "ast.2.dot", "readed-ast.svg");
 
+    write_binary(ast, "ast.bin");
+    auto&& readed_binary_ast = read("ast.bin");
+    write(readed_binary_ast, "ast.3.json");
+    dump(readed_binary_ast, "ast.3.dot", "readed-binary-ast.svg");
+
     auto&& name = create(Variable{"artem_lobachev"});
     auto&& num = create(NumberLiteral{999});
     auto&& num2 = create(NumberLiteral{13});
@@ -0,0 +1,210 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/SHA256.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module compile_cache;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace compiler::cache
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+persistent cache of executables, built by paraclc.
+entry is addressed by sha256 of source text and codegen signature, so changed program or options never hit old entry.
+one directory can be shared by several paraclc processes: entries are written to temporary file and renamed.
+*/
+export
+class Cache
+{
+  private:
+    std::filesystem::path directory_;
+    std::uintmax_t size_limit_;
+
+  public:
+    Cache(std::filesystem::path directory, std::uintmax_t size_limit) :
+    directory_(std::move(directory)), size_limit_(size_limit)
+    {}
+
+  public:
+    /* $PARACL_CACHE_DIR, else $XDG_CACHE_HOME/paracl, else $HOME/.cache/paracl */
+    static std::filesystem::path default_directory();
+
+    static std::string key(std::string_view source, std::string_view signature);
+
+    std::filesystem::path const & directory() const & noexcept
+    { return directory_; }
+
+    /* true - executable is copied from cache */
+    bool fetch(std::string const & key, std::filesystem::path const & executable) const;
+
+    /* errors are not fatal: program is already compiled, it`s only not cached. false - not stored */
+    bool store(std::string const & key, std::filesystem::path const & executable) const;
+
+  private:
+    std::filesystem::path entry_(std::string const & key) const
+    { return directory_ / (key + ".exe"); }
+
+    void evict_() const;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::filesystem::path Cache::default_directory()
+{
+    if (auto&& directory = std::getenv("PARACL_CACHE_DIR"); directory and *directory)
+        return directory;
+
+    if (auto&& xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache and *xdg_cache)
+        return std::filesystem::path{xdg_cache} / "paracl";
+
+    if (auto&& home = std::getenv("HOME"); home and *home)
+        return std::filesystem::path{home} / ".cache" / "paracl";
+
+    return std::filesystem::temp_directory_path() / "paracl-cache";
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::string Cache::key(std::string_view source, std::string_view signature)
+{
+    auto&& hasher = llvm::SHA256{};
+
+    /* sizes are hashed too: otherwise bytes could move from one part to another without changing the key */
+    auto&& hash_part = [&hasher](std::string_view part)
+    {
+        hasher.update(std::to_string(part.size()) + ":");
+        hasher.update(llvm::StringRef{part.data(), part.size()});
+    };
+
+    hash_part(signature);
+    hash_part(source);
+
+    auto&& digest = hasher.final();
+    return llvm::toHex(digest, /* LowerCase = */ true);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+bool Cache::fetch(std::string const & key, std::filesystem::path const & executable) const
+{
+    auto&& entry = entry_(key);
+    auto&& ec = std::error_code{};
+
+    if (not std::filesystem::is_regular_file(entry, ec)) return false;
+
+    std::filesystem::remove(executable, ec);
+
+    /*
+    copy, not hardlink: user may change executable in place (strip, patchelf, debugger),
+    and with hardlink it would silently change cache entry for every next build too.
+    */
+    std::filesystem::copy_file(entry, executable, std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) return false;
+
+    /* recently used entries are evicted last */
+    std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), ec);
+
+    LOGINFO("paraclc: cache: hit {}", key);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+bool Cache::store(std::string const & key, std::filesystem::path const & executable) const
+{
+    auto&& ec = std::error_code{};
+
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) return false;
+
+    auto&& random = std::random_device{};
+    auto&& temporary = directory_ / ("tmp-" + key + "-" + std::to_string(random()));
+
+    std::filesystem::copy_file(executable, temporary, ec);
+    if (ec) return false;
+
+    /* rename is atomic: concurrent paraclc sees whole entry or nothing */
+    std::filesystem::rename(temporary, entry_(key), ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+
+    evict_();
+
+    LOGINFO("paraclc: cache: stored {}", key);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Cache::evict_() const
+{
+    struct Entry
+    {
+        std::filesystem::path path;
+        std::uintmax_t size;
+        std::filesystem::file_time_type last_use;
+    };
+
+    auto&& entries = std::vector<Entry>{};
+    auto&& total_size = std::uintmax_t{0};
+    auto&& ec = std::error_code{};
+
+    for (auto&& file : std::filesystem::directory_iterator{directory_, ec})
+    {
+        /* temporary files belong to paraclc processes, which are storing their entries now */
+        if (file.path().extension() != ".exe") continue;
+
+        auto&& size = file.file_size(ec);
+        if (ec) { ec.clear(); continue; }
+
+        auto&& last_use = file.last_write_time(ec);
+        if (ec) { ec.clear(); continue; }
+
+        entries.push_back(Entry{file.path(), size, last_use});
+        total_size += size;
+    }
+
+    if (total_size <= size_limit_) return;
+
+    std::ranges::sort(entries, {}, &Entry::last_use);
+
+    for (auto&& entry : entries)
+    {
+        if (total_size <= size_limit_) break;
+
+        if (std::filesystem::remove(entry.path, ec))
+            total_size -= entry.size;
+
+        ec.clear();
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace compiler::cache */
+//---------------------------------------------------------------------------------------------------------------
@@ -1,31 +1,377 @@
 module;
 
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/CodeGen.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SHA256.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+#include <llvm/TargetParser/Host.h>
+
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <cstdlib>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#if not defined(PARACL_LINKER)
+#error "Please define 'PARACL_LINKER' for this unit."
+#endif /* not defined(PARACL_LINKER) */
+
+#if not defined(PARACL_RUNTIME)
+#error "Please define 'PARACL_RUNTIME' for this unit."
+#endif /* not defined(PARACL_RUNTIME) */
+
+#if not defined(PARACL_COMPILER_VERSION)
+#error "Please define 'PARACL_COMPILER_VERSION' for this unit."
+#endif /* not defined(PARACL_COMPILER_VERSION) */
 
 export module compiler;
 
 import llvm_ir_translator;
+import optimizer;
+import pgo;
+import thelast;
 
 namespace compiler
 {
-export void compile([[maybe_unused]] std::filesystem::path const & ast_json, std::filesystem::path const & executable)
+
+/* what paraclc does with translated module */
+export
+struct CompileOptions
+{
+    unsigned    optimization_level = 3;
+    std::string target_cpu         = "generic"; /* 'native' - cpu of this machine */
+    bool        verbose            = false;
+
+    std::filesystem::path instrument_file; /* not empty: program counts branches and writes counters there at exit */
+    std::filesystem::path profile_file;    /* not empty: branches get weights from this profile (of instrumented build) */
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+pgo::Options pgo_options(CompileOptions const & options)
+{
+    auto&& result = pgo::Options{};
+
+    if (not options.instrument_file.empty())
+        result.instrument = std::filesystem::absolute(options.instrument_file);
+
+    if (not options.profile_file.empty())
+        result.use = pgo::read_profile(options.profile_file);
+
+    if (options.verbose and result.instrument)
+        std::clog << "paraclc: instrumented build, profile: " << result.instrument->string() << "\n";
+
+    if (options.verbose and result.use)
+        std::clog << "paraclc: profile " << options.profile_file.string() << ", " << result.use->counters.size() << " counters\n";
+
+    return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+llvm::CodeGenOpt::Level to_codegen_level(unsigned optimization_level)
+{
+    switch (optimization_level)
+    {
+        case 0:  return llvm::CodeGenOpt::None;
+        case 1:  return llvm::CodeGenOpt::Less;
+        case 2:  return llvm::CodeGenOpt::Default;
+        default: return llvm::CodeGenOpt::Aggressive;
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* '+feature,-feature,...' of cpu of this machine */
+std::string host_features()
+{
+    auto&& features = llvm::StringMap<bool>{};
+    if (not llvm::sys::getHostCPUFeatures(features)) return "";
+
+    auto&& result = std::string{};
+    for (auto&& feature : features)
+    {
+        if (not result.empty()) result += ',';
+        result += (feature.getValue() ? '+' : '-');
+        result += feature.getKey().str();
+    }
+
+    return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* what code is generated for: 'native' is resolved here to the name and features of host cpu */
+struct Target
+{
+    std::string triple;
+    std::string cpu;
+    std::string features;
+};
+
+Target resolve_target(CompileOptions const & options)
+{
+    if (options.target_cpu != "native")
+        return Target{llvm::sys::getDefaultTargetTriple(), options.target_cpu, ""};
+
+    return Target{llvm::sys::getDefaultTargetTriple(), llvm::sys::getHostCPUName().str(), host_features()};
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+llvm target of compilations with the same options: llvm is initialized and target is resolved once.
+it`s shared by threads of paraclc -j: each of them creates its own target machine (Codegen).
+*/
+export
+class Toolchain final
+{
+  private:
+    Target target_;
+    llvm::Target const * llvm_target_ = nullptr;
+    unsigned optimization_level_;
+
+  public:
+    explicit Toolchain(CompileOptions const & options);
+
+    /* target machine is not thread safe: one per thread */
+    std::unique_ptr<llvm::TargetMachine> create_target_machine() const;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+Toolchain::Toolchain(CompileOptions const & options) :
+target_(resolve_target(options)), optimization_level_(options.optimization_level)
+{
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    auto&& error = std::string{};
+    llvm_target_ = llvm::TargetRegistry::lookupTarget(target_.triple, error);
+
+    if (not llvm_target_)
+        throw std::runtime_error("Failed to find target '" + target_.triple + "': " + error);
+
+    if (options.verbose)
+        std::clog << "paraclc: target " << target_.triple << ", cpu " << target_.cpu << ", -O" << optimization_level_ << "\n";
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::unique_ptr<llvm::TargetMachine> Toolchain::create_target_machine() const
+{
+    /* PIC: executable is linked by system compiler driver, which makes PIE by default */
+    auto&& target_machine = std::unique_ptr<llvm::TargetMachine>{llvm_target_->createTargetMachine(
+        target_.triple, target_.cpu, target_.features, llvm::TargetOptions{}, llvm::Reloc::PIC_, std::nullopt,
+        to_codegen_level(optimization_level_)
+    )};
+
+    if (not target_machine)
+        throw std::runtime_error("Failed to create target machine for '" + target_.triple + "' (cpu '" + target_.cpu + "')");
+
+    return target_machine;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void emit_object(llvm::Module & module, llvm::TargetMachine & target_machine, std::filesystem::path const & object_file)
+{
+    auto&& ec = std::error_code{};
+    auto&& out = llvm::raw_fd_ostream{object_file.string(), ec, llvm::sys::fs::OF_None};
+
+    if (ec)
+        throw std::runtime_error("Failed to open '" + object_file.string() + "': " + ec.message());
+
+    auto&& pass_manager = llvm::legacy::PassManager{};
+
+    if (target_machine.addPassesToEmitFile(pass_manager, out, nullptr, llvm::CGFT_ObjectFile))
+        throw std::runtime_error("Target machine can`t emit object file");
+
+    pass_manager.run(module);
+    out.flush();
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* program needs only paracl-rt and libc, so it`s linked by C compiler driver without c++ runtime */
+void link_executable(std::filesystem::path const & object_file, std::filesystem::path const & executable)
+{
+    auto&& link_command = std::ostringstream{};
+    link_command << PARACL_LINKER " " << object_file.string() << " " PARACL_RUNTIME " -o " << executable.string();
+
+    auto&& link_command_exit_code = std::system(link_command.str().c_str());
+
+    if (link_command_exit_code == EXIT_SUCCESS) return;
+
+    throw std::runtime_error("Failed link '" + executable.string() + "' with exit code " + std::to_string(link_command_exit_code));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void build_executable(llvm::Module & module, std::filesystem::path const & executable, CompileOptions const & options,
+                      llvm::TargetMachine & target_machine)
 {
-    auto&& tmp_ir_file = std::filesystem::path{executable};
-    tmp_ir_file.replace_extension(".ll");
+    module.setDataLayout(target_machine.createDataLayout());
+    module.setTargetTriple(target_machine.getTargetTriple().str());
 
-    llvm_ir_translator::generate_llvm_ir(ast_json, tmp_ir_file);
+    {
+        auto&& timer = last::stats::Timer{"llvm optimization"};
+        optimizer::optimize(module, options.optimization_level, &target_machine);
+    }
 
-    auto&& compile_commmand = std::ostringstream{};
-    compile_commmand << "clang++ -O3 " << tmp_ir_file.string() << " -o " << executable.string() << " 2>/dev/null";
+    auto&& object_file = std::filesystem::path{executable};
+    object_file.replace_extension(".o");
 
-    auto&& compile_command_exit_code = std::system(compile_commmand.str().c_str());
+    {
+        auto&& timer = last::stats::Timer{"code generation"};
+        emit_object(module, target_machine, object_file);
+    }
+
+    {
+        auto&& timer = last::stats::Timer{"linking"};
+        link_executable(object_file, executable);
+    }
+
+    std::filesystem::remove(object_file);
+}
 
-    if (compile_command_exit_code == EXIT_SUCCESS) return;
+//---------------------------------------------------------------------------------------------------------------
 
-    throw std::runtime_error("Failed generate '" + executable.string() + "' with exit code " + std::to_string(compile_command_exit_code));
+/*
+build of compiler: sha256 of executable of this process and of paracl-rt, which is linked into programs.
+frontend, translator, optimizer and ast library are linked into the executable statically, so every rebuild of them
+changes the id. version of project and time of cmake configuration stay the same after incremental rebuild.
+*/
+std::string const & build_id()
+{
+    static auto const id = []
+    {
+        auto&& hasher = llvm::SHA256{};
+
+        for (auto&& file : { llvm::sys::fs::getMainExecutable(nullptr, nullptr), std::string{PARACL_RUNTIME} })
+        {
+            auto&& buffer = llvm::MemoryBuffer::getFile(file, /* IsText = */ false, /* RequiresNullTerminator = */ false);
+            if (not buffer)
+                throw std::runtime_error("Can`t read '" + file + "' for build id of compiler: " + buffer.getError().message());
+
+            hasher.update((*buffer)->getBuffer());
+        }
+
+        return llvm::toHex(hasher.final(), /* LowerCase = */ true);
+    }();
+
+    return id;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+everything besides the program, that affects produced executable: build of compiler and runtime, llvm, target and linker.
+two compilations of the same source with the same signature give the same executable (used by compile cache).
+*/
+export std::string codegen_signature(CompileOptions const & options)
+{
+    auto&& target = resolve_target(options);
+
+    auto&& signature = std::ostringstream{};
+    signature << "paraclc " PARACL_COMPILER_VERSION "\n"
+              << "build " << build_id() << "\n"
+              << "llvm " LLVM_VERSION_STRING "\n"
+              << "triple " << target.triple   << "\n"
+              << "cpu "    << target.cpu      << "\n"
+              << "features " << target.features << "\n"
+              << "O"       << options.optimization_level << "\n"
+              << "linker " PARACL_LINKER "\n";
+
+    /* path of profile is compiled into instrumented program, and weights of branches come from profile */
+    if (not options.instrument_file.empty())
+        signature << "instrument " << std::filesystem::absolute(options.instrument_file).string() << "\n";
+
+    if (not options.profile_file.empty())
+    {
+        auto&& profile = pgo::read_profile(options.profile_file);
+
+        signature << "profile " << profile.checksum;
+        for (auto&& counter : profile.counters) signature << " " << counter;
+        signature << "\n";
+    }
+
+    return signature.str();
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+compilations of one thread: ir translation, optimization and code generation of program after program
+with the same target machine. every program gets its own llvm context, so codegens of different threads share nothing.
+*/
+export
+class Codegen final
+{
+  private:
+    std::unique_ptr<llvm::TargetMachine> target_machine_;
+
+  public:
+    explicit Codegen(Toolchain const & toolchain) :
+    target_machine_(toolchain.create_target_machine())
+    {}
+
+    /* ast from file: text or binary format */
+    void compile(std::filesystem::path const & ast, std::filesystem::path const & executable, CompileOptions const & options)
+    {
+        auto&& context = llvm::LLVMContext{};
+        auto&& module  = llvm_ir_translator::translate(ast, context, pgo_options(options));
+
+        build(*module, executable, options);
+    }
+
+    /* ast from frontend in the same process */
+    void compile(last::binary::Image const & image, std::filesystem::path const & source, std::filesystem::path const & executable,
+                 CompileOptions const & options)
+    {
+        auto&& context = llvm::LLVMContext{};
+        auto&& module  = llvm_ir_translator::translate(image, source.string(), context, pgo_options(options));
+
+        build(*module, executable, options);
+    }
+
+    /* module, translated by caller: optimization, object file and linking (paracl-bench measures translation apart) */
+    void build(llvm::Module & module, std::filesystem::path const & executable, CompileOptions const & options)
+    {
+        build_executable(module, executable, options, *target_machine_);
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* ast from file: text or binary format */
+export void compile(std::filesystem::path const & ast, std::filesystem::path const & executable, CompileOptions const & options = {})
+{
+    Codegen{Toolchain{options}}.compile(ast, executable, options);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* ast from frontend in the same process */
+export void compile(last::binary::Image const & image, std::filesystem::path const & source, std::filesystem::path const & executable,
+                    CompileOptions const & options = {})
+{
+    Codegen{Toolchain{options}}.compile(image, source, executable, options);
 }
 
 } /* namespace compiler */
@@ -0,0 +1,225 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <llvm/ExecutionEngine/JITSymbol.h>
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "paracl-rt.h"
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module jit;
+
+//---------------------------------------------------------------------------------------------------------------
+
+import llvm_ir_translator;
+import optimizer;
+import thelast;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace compiler::jit
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+void check(llvm::Error error)
+{
+    if (error)
+        throw std::runtime_error("jit: " + llvm::toString(std::move(error)));
+}
+
+template <typename T>
+T unwrap(llvm::Expected<T> value)
+{
+    if (not value)
+        throw std::runtime_error("jit: " + llvm::toString(value.takeError()));
+
+    return std::move(*value);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* target machine for cpu of this process: jitted code is optimized for it */
+struct Host
+{
+    llvm::orc::JITTargetMachineBuilder target_machine_builder;
+    std::unique_ptr<llvm::TargetMachine> target_machine;
+};
+
+Host detect_host()
+{
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+
+    auto&& target_machine_builder = unwrap(llvm::orc::JITTargetMachineBuilder::detectHost());
+    auto&& target_machine         = unwrap(target_machine_builder.createTargetMachine());
+
+    return Host{std::move(target_machine_builder), std::move(target_machine)};
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+paracl-rt is linked into host process (paracl), its functions are given to jitted code by address:
+they are not exported by executable, so they can`t be found by search in process.
+*/
+void define_runtime(llvm::orc::LLJIT& jit)
+{
+    auto&& symbols = llvm::orc::SymbolMap{};
+
+    auto&& define = [&jit, &symbols](char const * name, auto* function)
+    {
+        symbols[jit.mangleAndIntern(name)] =
+            llvm::orc::ExecutorSymbolDef{llvm::orc::ExecutorAddr::fromPtr(function), llvm::JITSymbolFlags::Exported};
+    };
+
+    define("prt_write_int", &prt_write_int);
+    define("prt_write_str", &prt_write_str);
+    define("prt_newline"  , &prt_newline  );
+    define("prt_read_int" , &prt_read_int );
+    define("prt_flush"    , &prt_flush    );
+
+    define("prt_array_new"   , &prt_array_new   );
+    define("prt_array_delete", &prt_array_delete);
+    define("prt_out_of_range", &prt_out_of_range);
+
+    check(jit.getMainJITDylib().define(llvm::orc::absoluteSymbols(std::move(symbols))));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* libc functions are resolved from host process */
+std::unique_ptr<llvm::orc::LLJIT> create_jit(llvm::orc::JITTargetMachineBuilder target_machine_builder)
+{
+    auto&& jit = unwrap(
+        llvm::orc::LLJITBuilder{}
+            .setJITTargetMachineBuilder(std::move(target_machine_builder))
+            .create()
+    );
+
+    define_runtime(*jit);
+
+    auto&& global_prefix = jit->getDataLayout().getGlobalPrefix();
+    jit->getMainJITDylib().addGenerator(
+        unwrap(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(global_prefix))
+    );
+
+    return jit;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void add_module(llvm::orc::LLJIT& jit, llvm::TargetMachine& target_machine, unsigned opt_level,
+                std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context)
+{
+    module->setDataLayout(target_machine.createDataLayout());
+    module->setTargetTriple(target_machine.getTargetTriple().str());
+
+    optimizer::optimize(*module, opt_level, &target_machine);
+
+    check(jit.addIRModule(llvm::orc::ThreadSafeModule{std::move(module), std::move(context)}));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* output policy of jitted code: it must be the same as policy of host (see --flush of paracl) */
+export
+void set_line_buffered(bool line_buffered)
+{
+    prt_set_line_buffered(line_buffered ? 1 : 0);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* translates ast to llvm module, optimizes it for host cpu and runs 'main' right in this process */
+export
+int run(last::binary::Image const & image, std::string const & module_name, unsigned opt_level = 2)
+{
+    auto&& host = detect_host();
+
+    LOGINFO("paracl: jit: translating '{}' for {}", module_name, host.target_machine->getTargetTriple().str());
+
+    auto&& context = std::make_unique<llvm::LLVMContext>();
+    auto&& module  = llvm_ir_translator::translate(image, module_name, *context);
+
+    auto&& jit = create_jit(std::move(host.target_machine_builder));
+    add_module(*jit, *host.target_machine, opt_level, std::move(module), std::move(context));
+
+    auto&& main = unwrap(jit->lookup("main")).toPtr<int()>();
+
+    LOGINFO("paracl: jit: running main");
+
+    auto&& exit_code = main();
+
+    /* jitted code prints through runtime buffer and host stdio: flush them before paracl exits or prints errors */
+    prt_flush();
+    std::fflush(stdout);
+
+    return exit_code;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+compiles hot loops of interpreter (paracl --tiered).
+all loops are placed in one jit session, which lives as long as this object, so compiled code must not outlive it.
+*/
+export
+class LoopJit final
+{
+  public:
+    using CompiledLoop = void (*)(int* frame);
+
+  private:
+    Host host_;
+    std::unique_ptr<llvm::orc::LLJIT> jit_;
+    unsigned opt_level_;
+    size_t loops_count_ = 0;
+
+  public:
+    explicit LoopJit(unsigned opt_level = 2) :
+    host_(detect_host()), jit_(create_jit(host_.target_machine_builder)), opt_level_(opt_level)
+    {}
+
+    /* frame[i] is address of captures[i] */
+    CompiledLoop compile_loop(last::binary::Image const & loop, std::vector<std::string_view> const & captures)
+    {
+        auto&& function_name = "__paracl_loop_" + std::to_string(loops_count_++);
+
+        LOGINFO("paracl: jit: compiling hot loop '{}'", function_name);
+
+        auto&& context = std::make_unique<llvm::LLVMContext>();
+        auto&& module  = llvm_ir_translator::translate_loop(loop, captures, function_name, *context);
+
+        add_module(*jit_, *host_.target_machine, opt_level_, std::move(module), std::move(context));
+
+        return unwrap(jit_->lookup(function_name)).toPtr<void(int*)>();
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace compiler::jit */
+//---------------------------------------------------------------------------------------------------------------
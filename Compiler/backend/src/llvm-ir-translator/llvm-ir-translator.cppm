@@ -10,12 +10,15 @@ module;
 #include <llvm/Support/ToolOutputFile.h>
 #include <boost/json.hpp>
 
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
-#include <sstream>
+#include <memory>
 #include <stdexcept>
-
-#include "create-basic-node.hpp"
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #define LOGINFO(...)
 #define LOGERR(...)
@@ -26,8 +29,9 @@ export module llvm_ir_translator;
 
 //---------------------------------------------------------------------------------------------------------------
 
-import nametable;
-import libc_standart_functions;
+import ir_nametable;
+import runtime_functions;
+export import pgo;
 import thelast;
 
 //---------------------------------------------------------------------------------------------------------------
@@ -39,15 +43,17 @@ namespace compiler::llvm_ir_translator
 
 struct llvmIrTranslatorData
 {
-    llvm::LLVMContext context;
-    llvm::Module module;
+    llvm::LLVMContext &context;
+    llvm::Module &module;
     llvm::IRBuilder<> builder;
     nametable::Nametable nametable;
-    LibcStandartFunctions libc_standart_functions;
+    RuntimeFunctions runtime;
+    pgo::Counters counters;
 
-    llvmIrTranslatorData(std::filesystem::path const &source) :
-        context(), module(source.string(), context), builder(context),
-        nametable(module, builder), libc_standart_functions(module, builder)
+    /* module is owned by caller: it may be written to file or passed to jit */
+    explicit llvmIrTranslatorData(llvm::Module &module, pgo::Options pgo_options = {}) :
+        context(module.getContext()), module(module), builder(context),
+        nametable(module, builder), runtime(module, builder), counters(std::move(pgo_options), module, builder)
     {}
 };
 
@@ -80,6 +86,128 @@ decltype(auto) generate_statement(BasicNode const & node, llvmIrTranslatorData&
 decltype(auto) generate_expression(BasicNode const & node, llvmIrTranslatorData& data)
 { return visit<llvm::Value*, llvmIrTranslatorData&>(node, data); }
 
+/*
+branches to true_block or false_block by condition.
+'and', 'or' and 'not' become branches: their i32 values are never materialized.
+returns the branch, if it`s the only one (condition without 'and'/'or'), else nullptr.
+*/
+llvm::BranchInst* generate_branch(BasicNode const & node, llvmIrTranslatorData& data,
+                                  llvm::BasicBlock* true_block, llvm::BasicBlock* false_block);
+
+/* 'and' or 'or': right is calculated, only if result isn`t known by left */
+void generate_logical_branch(BinaryOperator const & node, llvmIrTranslatorData& data,
+                             llvm::BasicBlock* true_block, llvm::BasicBlock* false_block)
+{
+    auto&& function = data.builder.GetInsertBlock()->getParent();
+    auto&& right_block = llvm::BasicBlock::Create(data.context, node.type() == BinaryOperator::AND ? "and_rhs" : "or_rhs", function);
+
+    if (node.type() == BinaryOperator::AND)
+        generate_branch(node.larg(), data, right_block, false_block);
+    else
+        generate_branch(node.larg(), data, true_block, right_block);
+
+    data.builder.SetInsertPoint(right_block);
+    generate_branch(node.rarg(), data, true_block, false_block);
+}
+
+llvm::BranchInst* generate_branch(BasicNode const & node, llvmIrTranslatorData& data,
+                                  llvm::BasicBlock* true_block, llvm::BasicBlock* false_block)
+{
+    if (node.is_a<UnaryOperator>() and static_cast<UnaryOperator const &>(node).type() == UnaryOperator::NOT)
+        return generate_branch(static_cast<UnaryOperator const &>(node).arg(), data, false_block, true_block);
+
+    if (node.is_a<BinaryOperator>())
+    {
+        auto&& binary = static_cast<BinaryOperator const &>(node);
+        if (binary.type() == BinaryOperator::AND or binary.type() == BinaryOperator::OR)
+        {
+            generate_logical_branch(binary, data, true_block, false_block);
+            return nullptr;
+        }
+    }
+
+    auto&& value = generate_expression(node, data);
+    auto&& condition = data.builder.CreateICmpNE(value, llvm::ConstantInt::get(data.builder.getInt32Ty(), 0), "cond");
+    return data.builder.CreateCondBr(condition, true_block, false_block);
+}
+
+/* elements of arrays with literal size up to this are on stack of function, others are on heap */
+constexpr uint64_t max_stack_array_size = 4096;
+
+/* every element is value: simple loop, which llvm turns to memset or vectorizes */
+void generate_fill(llvm::Value* elements, llvm::Value* size, llvm::Value* value, llvmIrTranslatorData& data)
+{
+    auto&& function   = data.builder.GetInsertBlock()->getParent();
+    auto&& preheader  = data.builder.GetInsertBlock();
+    auto&& cond_block = llvm::BasicBlock::Create(data.context, "fill_cond", function);
+    auto&& body_block = llvm::BasicBlock::Create(data.context, "fill_body", function);
+    auto&& end_block  = llvm::BasicBlock::Create(data.context, "fill_end" , function);
+
+    data.builder.CreateBr(cond_block);
+    data.builder.SetInsertPoint(cond_block);
+
+    auto&& it = data.builder.CreatePHI(data.builder.getInt32Ty(), 2, "__fillIt");
+    it->addIncoming(data.builder.getInt32(0), preheader);
+    data.builder.CreateCondBr(data.builder.CreateICmpSLT(it, size), body_block, end_block);
+
+    data.builder.SetInsertPoint(body_block);
+    auto&& index = data.builder.CreateZExt(it, data.builder.getInt64Ty());
+    data.builder.CreateStore(value, data.builder.CreateInBoundsGEP(data.builder.getInt32Ty(), elements, index));
+    it->addIncoming(data.builder.CreateNSWAdd(it, data.builder.getInt32(1)), body_block);
+    data.builder.CreateBr(cond_block);
+
+    data.builder.SetInsertPoint(end_block);
+}
+
+/*
+address of name[index]. negative index is a huge unsigned one, so bounds are checked by one comparison.
+failing branch is cold and never returns: llvm removes the check, if loop condition implies it
+(e.g. 'while (i < n) a[i] ...' for array of n elements), and the loop may be vectorized.
+*/
+llvm::Value* generate_element_address(Symbol name, llvm::Value* index, llvmIrTranslatorData& data)
+{
+    auto&& array = data.nametable.get_array(name);
+
+    /* not nullptr: hot loop of interpreter must be able to stay interpreted */
+    if (not array)
+        throw std::runtime_error(std::string("requests element of not exists array: ") + std::string(name.name()));
+
+    auto&& function           = data.builder.GetInsertBlock()->getParent();
+    auto&& in_range_block     = llvm::BasicBlock::Create(data.context, "in_range"    , function);
+    auto&& out_of_range_block = llvm::BasicBlock::Create(data.context, "out_of_range", function);
+
+    auto&& size = data.builder.CreateLoad(data.builder.getInt32Ty(), array->size, std::string(name.name()) + "_size");
+    data.builder.CreateCondBr(data.builder.CreateICmpULT(index, size, "__inRange"), in_range_block, out_of_range_block);
+
+    data.builder.SetInsertPoint(out_of_range_block);
+    auto&& length = llvm::ConstantInt::get(data.builder.getInt64Ty(), name.name().size());
+    data.builder.CreateCall(data.runtime.out_of_range(), {array->name, length, index, size});
+    data.builder.CreateUnreachable();
+
+    data.builder.SetInsertPoint(in_range_block);
+    auto&& elements = data.builder.CreateLoad(data.builder.getInt8Ty()->getPointerTo(), array->elements);
+    return data.builder.CreateInBoundsGEP(data.builder.getInt32Ty(), elements,
+                                          data.builder.CreateZExt(index, data.builder.getInt64Ty()), "__element");
+}
+
+/* heap elements of arrays of scope are freed: next entry to the scope starts without them */
+void leave_scope(llvmIrTranslatorData& data)
+{
+    for (auto&& array : data.nametable.scope_arrays())
+    {
+        if (array->heap)
+        {
+            auto&& ptr_type = data.builder.getInt8Ty()->getPointerTo();
+            data.builder.CreateCall(data.runtime.array_delete(), {data.builder.CreateLoad(ptr_type, array->storage)});
+            data.builder.CreateStore(llvm::ConstantPointerNull::get(ptr_type), array->storage);
+        }
+
+        data.builder.CreateStore(data.builder.getInt32(0), array->size);
+    }
+
+    data.nametable.leave_scope();
+}
+
 namespace visit_specializations
 {
 
@@ -116,7 +244,7 @@ template <>
 llvm::Value* visit(Variable const& node, llvmIrTranslatorData& data)
 {
     LOGINFO("paracl: ir translator: variable access: '{}'", node.name());
-    return data.nametable.get_variable_value(node.name());
+    return data.nametable.get_variable_value(node.symbol());
 }
 
 template <>
@@ -135,13 +263,7 @@ llvm::Value* visit(Scan const& node, llvmIrTranslatorData& data)
 {
     LOGINFO("paracl: ir translator: scan expression");
 
-    auto&& temp_var = data.builder.CreateAlloca(data.builder.getInt32Ty(), nullptr, "__scan_tmp");
-    auto&& fmt = data.builder.CreateGlobalStringPtr("%d", "__scanfFormat");
-    auto&& scanf_args = std::vector<llvm::Value*>{fmt, temp_var};
-
-    data.builder.CreateCall(data.libc_standart_functions.libc_scanf(), scanf_args);
-
-    return data.builder.CreateLoad(data.builder.getInt32Ty(), temp_var, "__scan_result");
+    return data.builder.CreateCall(data.runtime.read_int(), {}, "__scan_result");
 }
 
 template <>
@@ -199,10 +321,32 @@ llvm::Value* visit(BinaryOperator const& node, llvmIrTranslatorData& data)
     {
         auto&& variable = static_cast<Variable const &>(node.larg());
         auto&& right = generate_expression(node.rarg(), data);
-        data.nametable.set_value(variable.name(), right);
+        data.nametable.set_value(variable.symbol(), right);
         return right;
     }
 
+    if (node.type() == BinaryOperator::AND or node.type() == BinaryOperator::OR)
+    {
+        /* value is needed only if 'and'/'or' is not a condition of while or if (they use generate_branch) */
+        auto&& function    = data.builder.GetInsertBlock()->getParent();
+        auto&& true_block  = llvm::BasicBlock::Create(data.context, "logic_true" , function);
+        auto&& false_block = llvm::BasicBlock::Create(data.context, "logic_false", function);
+        auto&& end_block   = llvm::BasicBlock::Create(data.context, "logic_end"  , function);
+
+        generate_logical_branch(node, data, true_block, false_block);
+
+        data.builder.SetInsertPoint(true_block);
+        data.builder.CreateBr(end_block);
+        data.builder.SetInsertPoint(false_block);
+        data.builder.CreateBr(end_block);
+
+        data.builder.SetInsertPoint(end_block);
+        auto&& result = data.builder.CreatePHI(data.builder.getInt32Ty(), 2, node.type() == BinaryOperator::AND ? "__and" : "__or");
+        result->addIncoming(llvm::ConstantInt::get(data.builder.getInt32Ty(), 1), true_block);
+        result->addIncoming(llvm::ConstantInt::get(data.builder.getInt32Ty(), 0), false_block);
+        return result;
+    }
+
     auto&& left  = generate_expression(node.larg(), data);
     auto&& right = generate_expression(node.rarg(), data);
 
@@ -213,8 +357,6 @@ llvm::Value* visit(BinaryOperator const& node, llvmIrTranslatorData& data)
         case BinaryOperator::MUL: return data.builder.CreateMul (left, right, "__mul");
         case BinaryOperator::DIV: return data.builder.CreateSDiv(left, right, "__div");
         case BinaryOperator::REM: return data.builder.CreateSRem(left, right, "__rem");
-        case BinaryOperator::AND: return data.builder.CreateAnd (left, right, "__and");
-        case BinaryOperator::OR:  return data.builder.CreateOr  (left, right, "__or" );
         case BinaryOperator::ISAB:
         {
             auto&& cmp = data.builder.CreateICmpSGT(left, right);
@@ -249,7 +391,7 @@ llvm::Value* visit(BinaryOperator const& node, llvmIrTranslatorData& data)
     }
 
     auto&& variable = static_cast<Variable const &>(node.larg());
-    auto&& name  = variable.name();
+    auto&& name  = variable.symbol();
     auto&& value = data.nametable.get_variable_value(name);
 
     switch(node.type())
@@ -274,6 +416,93 @@ void visit(BinaryOperator const& node, llvmIrTranslatorData& data)
     (void) visit<BinaryOperator, llvm::Value*, llvmIrTranslatorData&>(node, data);
 }
 
+//-----------------------------------------------------------------------------
+// ARRAYS
+//-----------------------------------------------------------------------------
+template <>
+void visit(ArrayDeclaration const& node, llvmIrTranslatorData& data)
+{
+    LOGINFO("paracl: ir translator: generating array declaration '{}'", node.name());
+
+    auto&& value = generate_expression(node.value(), data);
+    auto&& size  = generate_expression(node.size(), data);
+    auto&& array = data.nametable.declare_array(node.symbol());
+
+    auto&& ptr_type = data.builder.getInt8Ty()->getPointerTo();
+    auto&& literal  = llvm::dyn_cast<llvm::ConstantInt>(size);
+
+    auto&& elements = [&]() -> llvm::Value*
+    {
+        if (literal and not literal->isNegative() and literal->getZExtValue() <= max_stack_array_size)
+            return data.nametable.create_entry_array(literal->getZExtValue(), node.name());
+
+        /* heap elements of the previous execution of this declaration (or of other one) */
+        data.builder.CreateCall(data.runtime.array_delete(), {data.builder.CreateLoad(ptr_type, array.storage)});
+
+        auto&& length = llvm::ConstantInt::get(data.builder.getInt64Ty(), node.name().size());
+        auto&& heap   = data.builder.CreateCall(data.runtime.array_new(), {array.name, length, size}, "__arrayNew");
+        data.builder.CreateStore(heap, array.storage);
+        array.heap = true;
+        return heap;
+    }();
+
+    data.builder.CreateStore(elements, array.elements);
+    data.builder.CreateStore(size, array.size);
+    generate_fill(elements, size, value, data);
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+llvm::Value* visit(ArrayElement const& node, llvmIrTranslatorData& data)
+{
+    LOGINFO("paracl: ir translator: array element: '{}'", node.name());
+
+    auto&& index = generate_expression(node.index(), data);
+    auto&& address = generate_element_address(node.symbol(), index, data);
+    return data.builder.CreateLoad(data.builder.getInt32Ty(), address, std::string(node.name()) + "_element");
+}
+
+template <>
+void visit(ArrayElement const& node, llvmIrTranslatorData& data)
+{
+    (void) visit<ArrayElement, llvm::Value*, llvmIrTranslatorData&>(node, data);
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+void visit(ArrayAssignment const& node, llvmIrTranslatorData& data)
+{
+    LOGINFO("paracl: ir translator: generating assignment to element of '{}'", node.name());
+
+    auto&& index = generate_expression(node.index(), data);
+
+    if (node.type() == BinaryOperator::ASGN)
+    {
+        auto&& value = generate_expression(node.value(), data);
+        data.builder.CreateStore(value, generate_element_address(node.symbol(), index, data));
+        return;
+    }
+
+    /* element is read before value is calculated, as left of the same operator for variables */
+    auto&& address = generate_element_address(node.symbol(), index, data);
+    auto&& element = data.builder.CreateLoad(data.builder.getInt32Ty(), address, std::string(node.name()) + "_element");
+    auto&& value   = generate_expression(node.value(), data);
+
+    switch (node.type())
+    {
+        case BinaryOperator::ADDASGN: value = data.builder.CreateAdd (element, value, "__addAsgnResult"); break;
+        case BinaryOperator::SUBASGN: value = data.builder.CreateSub (element, value, "__subAsgnResult"); break;
+        case BinaryOperator::MULASGN: value = data.builder.CreateMul (element, value, "__mulAsgnResult"); break;
+        case BinaryOperator::DIVASGN: value = data.builder.CreateSDiv(element, value, "__divAsgnResult"); break;
+        case BinaryOperator::REMASGN: value = data.builder.CreateSRem(element, value, "__remAsgnResult"); break;
+        default: __builtin_unreachable();
+    }
+
+    data.builder.CreateStore(value, address);
+}
+
 //-----------------------------------------------------------------------------
 // PRINT
 //-----------------------------------------------------------------------------
@@ -282,25 +511,21 @@ void visit(Print const& node, llvmIrTranslatorData& data)
 {
     LOGINFO("paracl: ir translator: generating print statement");
 
-    auto&& fmt = std::ostringstream{};
-    auto&& printf_args = std::vector<llvm::Value*>{};
-
     for (auto&& arg : node)
     {
         if (arg.is_a<StringLiteral>())
-            fmt << "%s";
-        else /* print expect only string literals, variables and number literals, so if not %s, using %d */
-            fmt << "%d";
+        {
+            auto&& string = static_cast<StringLiteral const &>(arg).value();
+            auto&& size   = llvm::ConstantInt::get(data.builder.getInt64Ty(), string.size());
+            data.builder.CreateCall(data.runtime.write_str(), {generate_expression(arg, data), size});
+            continue;
+        }
 
-        printf_args.push_back(generate_expression(arg, data));
+        /* print expect only string literals, variables and number literals, so if not string, it`s integer */
+        data.builder.CreateCall(data.runtime.write_int(), {generate_expression(arg, data)});
     }
 
-    fmt << "\n";
-
-    auto&& fmt_str = data.builder.CreateGlobalStringPtr(fmt.str(), "__printfFormat");
-    printf_args.insert(printf_args.begin(), fmt_str);
-
-    data.builder.CreateCall(data.libc_standart_functions.libc_printf(), printf_args);
+    data.builder.CreateCall(data.runtime.newline());
 }
 
 //-----------------------------------------------------------------------------
@@ -320,13 +545,14 @@ void visit(While const& node, llvmIrTranslatorData& data)
     data.builder.CreateBr(cond_block);
     data.builder.SetInsertPoint(cond_block);
 
-    auto&& cond_val = generate_expression(node.condition(), data);
-    auto&& cond_i1 = data.builder.CreateICmpNE(cond_val, 
-        llvm::ConstantInt::get(data.builder.getInt32Ty(), 0), "while_cond");
-
-    data.builder.CreateCondBr(cond_i1, body_block, end_block);
+    auto&& checks = data.counters.count(compiler::pgo::Point::WHILE_CONDITION);
+    auto&& branch = generate_branch(node.condition(), data, body_block, end_block);
 
     data.builder.SetInsertPoint(body_block);
+
+    auto&& iterations = data.counters.count(compiler::pgo::Point::WHILE_BODY);
+    data.counters.weigh(branch, body_block, iterations, checks);
+
     generate_statement(node.body(), data);
     data.builder.CreateBr(cond_block);
 
@@ -343,16 +569,17 @@ void visit(If const& node, llvmIrTranslatorData& data)
 
     auto&& current_func = data.builder.GetInsertBlock()->getParent();
 
-    auto&& cond_val = generate_expression(node.condition(), data);
-    auto&& cond_i1 = data.builder.CreateICmpNE(cond_val, 
-        llvm::ConstantInt::get(data.builder.getInt32Ty(), 0), "if_cond");
-
     auto&& then_block = llvm::BasicBlock::Create(data.context, "if_then", current_func);
     auto&& end_block = llvm::BasicBlock::Create(data.context, "if_end", current_func);
 
-    data.builder.CreateCondBr(cond_i1, then_block, end_block);
+    auto&& checks = data.counters.count(compiler::pgo::Point::IF_CONDITION);
+    auto&& branch = generate_branch(node.condition(), data, then_block, end_block);
 
     data.builder.SetInsertPoint(then_block);
+
+    auto&& executions = data.counters.count(compiler::pgo::Point::IF_BODY);
+    data.counters.weigh(branch, then_block, executions, checks);
+
     generate_statement(node.body(), data);
     data.builder.CreateBr(end_block);
 
@@ -366,14 +593,10 @@ bool visit(If const& node, llvmIrTranslatorData& data)
 
     auto&& current_func = data.builder.GetInsertBlock()->getParent();
 
-    auto&& cond_val = generate_expression(node.condition(), data);
-    auto&& cond_i1 = data.builder.CreateICmpNE(cond_val, 
-        llvm::ConstantInt::get(data.builder.getInt32Ty(), 0), "if_cond");
-
     auto&& then_block = llvm::BasicBlock::Create(data.context, "if_then", current_func);
     auto&& end_block = llvm::BasicBlock::Create(data.context, "if_end", current_func);
-    
-    data.builder.CreateCondBr(cond_i1, then_block, end_block);
+
+    generate_branch(node.condition(), data, then_block, end_block);
 
     data.builder.SetInsertPoint(then_block);
     generate_statement(node.body(), data);
@@ -425,19 +648,22 @@ void visit(Condition const& node, llvmIrTranslatorData& data)
     {
         data.builder.SetInsertPoint(if_blocks[it]);
 
-        auto&& if_it = static_cast<If>(node.get_ifs()[it]);
-        auto&& cond_val = generate_expression(if_it.condition(), data);
-        auto&& cond_i1 = data.builder.CreateICmpNE(cond_val, 
-            llvm::ConstantInt::get(data.builder.getInt32Ty(), 0), "if_cond");
+        auto&& if_it = static_cast<If const &>(node.get_ifs()[it]);
 
         auto&& next_block = (it + 1 < node.get_ifs().size()) 
             ? if_blocks[it + 1] 
             : (else_block ? else_block : end_block);
 
-        data.builder.CreateCondBr(cond_i1, body_blocks[it], next_block);
+        auto&& checks = data.counters.count(compiler::pgo::Point::IF_CONDITION);
+        auto&& branch = generate_branch(if_it.condition(), data, body_blocks[it], next_block);
 
         data.builder.SetInsertPoint(body_blocks[it]);
-        generate_statement(node.get_ifs()[it], data);
+
+        auto&& executions = data.counters.count(compiler::pgo::Point::IF_BODY);
+        data.counters.weigh(branch, body_blocks[it], executions, checks);
+
+        /* only body: condition is already checked */
+        generate_statement(if_it.body(), data);
         data.builder.CreateBr(end_block);
     }
 
@@ -464,7 +690,7 @@ void visit(Scope const& node, llvmIrTranslatorData& data)
     for (auto&& stmt : node)
         generate_statement(stmt, data);
 
-    data.nametable.leave_scope();
+    leave_scope(data);
 }
 
 //-----------------------------------------------------------------------------
@@ -473,18 +699,38 @@ void visit(Scope const& node, llvmIrTranslatorData& data)
 } /* namespace last::node */
 //-----------------------------------------------------------------------------
 
-SPECIALIZE_CREATE(last::node::Print         , last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::Scan          , last::node::generatable_expression, last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::Variable      , last::node::generatable_expression, last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::NumberLiteral , last::node::generatable_expression, last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::StringLiteral , last::node::generatable_expression)
-SPECIALIZE_CREATE(last::node::UnaryOperator , last::node::generatable_expression, last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::BinaryOperator, last::node::generatable_expression, last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::While         , last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::If            , last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::Else          , last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::Condition     , last::node::generatable_statement)
-SPECIALIZE_CREATE(last::node::Scope         , last::node::generatable_statement)
+namespace compiler::llvm_ir_translator
+{
+
+/*
+factory for last::read: nodes are created with signatures of this translator.
+node::create is not specialized here, because its specializations are also defined by interpreter,
+and both backends may be linked in one executable (paracl --jit).
+*/
+struct GeneratableNodes
+{
+    using Statement  = last::node::BasicNode::Actions<last::node::generatable_statement>;
+    using Expression = last::node::BasicNode::Actions<last::node::generatable_expression, last::node::generatable_statement>;
+    using Literal    = last::node::BasicNode::Actions<last::node::generatable_expression>;
+
+    static last::node::BasicNode create(last::node::Print            node) { return Statement ::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::Scan             node) { return Expression::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::Variable         node) { return Expression::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::NumberLiteral    node) { return Expression::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::StringLiteral    node) { return Literal   ::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::UnaryOperator    node) { return Expression::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::BinaryOperator   node) { return Expression::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::ArrayDeclaration node) { return Statement ::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::ArrayElement     node) { return Expression::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::ArrayAssignment  node) { return Statement ::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::While            node) { return Statement ::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::If               node) { return Statement ::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::Else             node) { return Statement ::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::Condition        node) { return Statement ::create(std::move(node)); }
+    static last::node::BasicNode create(last::node::Scope            node) { return Statement ::create(std::move(node)); }
+};
+
+} /* namespace compiler::llvm_ir_translator */
 
 //---------------------------------------------------------------------------------------------------------------
 
@@ -497,34 +743,50 @@ SPECIALIZE_CREATE(last::node::Scope         , last::node::generatable_statement)
 namespace compiler::llvm_ir_translator
 {
 
-export
-void generate_llvm_ir(std::filesystem::path const & ast_text_representation, 
-                      std::filesystem::path const & ir_file)
+void translate(last::AST const & ast, llvm::Module & module, pgo::Options pgo_options = {})
 {
     LOGINFO("paracl: ir translator: starting translation from AST to LLVM IR");
 
-    auto&& ast = last::read(ast_text_representation);
-    auto&& data = llvmIrTranslatorData{ast_text_representation};
+    auto&& data = llvmIrTranslatorData{module, std::move(pgo_options)};
 
-    LOGINFO("paracl: ir translator: generating main function");
+    {
+        auto&& timer = last::stats::Timer{"ir generation"};
 
-    auto&& main_type = llvm::FunctionType::get(data.builder.getInt32Ty(), false);
-    auto&& main_function = llvm::Function::Create(main_type, llvm::Function::ExternalLinkage, "main", data.module);
+        LOGINFO("paracl: ir translator: generating main function");
 
-    auto&& entry_block = llvm::BasicBlock::Create(data.context, "entry", main_function);
-    data.builder.SetInsertPoint(entry_block);
+        auto&& main_type = llvm::FunctionType::get(data.builder.getInt32Ty(), false);
+        auto&& main_function = llvm::Function::Create(main_type, llvm::Function::ExternalLinkage, "main", data.module);
 
-    data.nametable.new_scope();
-    last::node::generate_statement(ast.root(), data);
-    data.nametable.leave_scope();
+        auto&& entry_block = llvm::BasicBlock::Create(data.context, "entry", main_function);
+        data.builder.SetInsertPoint(entry_block);
+
+        data.nametable.new_scope();
+        last::node::generate_statement(ast.root(), data);
+        data.nametable.leave_scope();
+
+        data.builder.CreateRet(llvm::ConstantInt::get(data.builder.getInt32Ty(), 0));
+
+        data.counters.finish(*main_function, data.runtime.profile_init());
+    }
 
-    data.builder.CreateRet(llvm::ConstantInt::get(data.builder.getInt32Ty(), 0));
+    auto&& timer = last::stats::Timer{"ir verification"};
 
     if (llvm::verifyModule(data.module, &llvm::errs()))
     {
         LOGERR("paracl: ir translator: module verification failed");
         throw std::runtime_error("IR module verification failed");
     }
+}
+
+//-----------------------------------------------------------------------------
+
+void generate_llvm_ir(last::AST const & ast, std::string const & module_name,
+                      std::filesystem::path const & ir_file)
+{
+    auto&& context = llvm::LLVMContext{};
+    auto&& module  = llvm::Module{module_name, context};
+
+    translate(ast, module);
 
     LOGINFO("paracl: ir translator: writing IR to file: {}", ir_file.string());
 
@@ -532,10 +794,104 @@ void generate_llvm_ir(std::filesystem::path const & ast_text_representation,
     llvm::ToolOutputFile out(ir_file.string(), ec, llvm::sys::fs::OF_None);
     if (ec) throw std::runtime_error("failed to open IR file: " + ec.message());
 
-    data.module.print(out.os(), nullptr);
+    module.print(out.os(), nullptr);
     out.keep();
+}
+
+//-----------------------------------------------------------------------------
+
+/* ast from file: text or binary format */
+export
+void generate_llvm_ir(std::filesystem::path const & ast_text_representation,
+                      std::filesystem::path const & ir_file)
+{
+    generate_llvm_ir(last::read<GeneratableNodes>(ast_text_representation), ast_text_representation.string(), ir_file);
+}
+
+//-----------------------------------------------------------------------------
+
+/* ast from frontend in the same process */
+export
+void generate_llvm_ir(last::binary::Image const & image, std::string const & module_name,
+                      std::filesystem::path const & ir_file)
+{
+    generate_llvm_ir(last::read<GeneratableNodes>(image), module_name, ir_file);
+}
+
+//-----------------------------------------------------------------------------
+
+/* module in memory, without text IR: for jit and in-process code generation */
+export
+std::unique_ptr<llvm::Module> translate(last::binary::Image const & image, std::string const & module_name,
+                                        llvm::LLVMContext & context, pgo::Options pgo_options = {})
+{
+    auto&& module = std::make_unique<llvm::Module>(module_name, context);
+    translate(last::read<GeneratableNodes>(image), *module, std::move(pgo_options));
+    return module;
+}
+
+//-----------------------------------------------------------------------------
+
+/* module in memory, ast from file: text or binary format */
+export
+std::unique_ptr<llvm::Module> translate(std::filesystem::path const & ast_text_representation, llvm::LLVMContext & context,
+                                        pgo::Options pgo_options = {})
+{
+    auto&& module = std::make_unique<llvm::Module>(ast_text_representation.string(), context);
+    translate(last::read<GeneratableNodes>(ast_text_representation), *module, std::move(pgo_options));
+    return module;
+}
+
+//-----------------------------------------------------------------------------
+
+/*
+hot loop of interpreter: void <function_name>(i32* frame).
+root of image is While, captured variables are not declared in the loop, they live in frame[i].
+*/
+export
+std::unique_ptr<llvm::Module> translate_loop(last::binary::Image const & loop, std::vector<std::string_view> const & captures,
+                                             std::string const & function_name, llvm::LLVMContext & context)
+{
+    LOGINFO("paracl: ir translator: translating loop '{}' with {} captured variables", function_name, captures.size());
+
+    auto&& ast    = last::read<GeneratableNodes>(loop);
+    auto&& module = std::make_unique<llvm::Module>(function_name, context);
+    auto&& data   = llvmIrTranslatorData{*module};
+
+    auto&& frame_type = data.builder.getInt32Ty()->getPointerTo();
+    auto&& loop_type  = llvm::FunctionType::get(data.builder.getVoidTy(), {frame_type}, false);
+    auto&& function   = llvm::Function::Create(loop_type, llvm::Function::ExternalLinkage, function_name, data.module);
+
+    auto&& frame = function->getArg(0);
+    frame->setName("frame");
+
+    auto&& entry_block = llvm::BasicBlock::Create(data.context, "entry", function);
+    data.builder.SetInsertPoint(entry_block);
+
+    data.nametable.new_scope();
+
+    /* names of loop are symbols of its own tree: captured variable, which is not used by the loop, needs no binding */
+    for (unsigned it = 0; it < captures.size(); ++it)
+    {
+        auto&& symbol = ast.symbols()->find(captures[it]);
+        if (not symbol) continue;
+        data.nametable.bind(*symbol, data.builder.CreateConstInBoundsGEP1_32(data.builder.getInt32Ty(), frame, it, captures[it]));
+    }
+
+    last::node::generate_statement(ast.root(), data);
+    data.nametable.leave_scope();
+
+    /* the rest of loop is executed by interpreter, which prints through stdio: output of the loop must be before */
+    data.builder.CreateCall(data.runtime.flush());
+    data.builder.CreateRetVoid();
+
+    if (llvm::verifyModule(data.module, &llvm::errs()))
+    {
+        LOGERR("paracl: ir translator: loop verification failed");
+        throw std::runtime_error("IR loop verification failed");
+    }
 
-    LOGINFO("paracl: ir translator: compiling IR to object file: {}", object_file.string());
+    return module;
 }
 
 //-----------------------------------------------------------------------------
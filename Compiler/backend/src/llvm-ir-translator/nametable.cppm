@@ -5,6 +5,8 @@ module;
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Module.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <ranges>
 #include <stdexcept>
 #include <string>
@@ -18,7 +20,12 @@ module;
 
 //---------------------------------------------------------------------------------------------------------------
 
-export module nametable;
+export module ir_nametable;
+
+//---------------------------------------------------------------------------------------------------------------
+
+import last_stats;
+import node_symbols;
 
 //---------------------------------------------------------------------------------------------------------------
 
@@ -27,16 +34,31 @@ namespace compiler::nametable
 
 //---------------------------------------------------------------------------------------------------------------
 
+/* array of ints: all its parts are entry allocas, so they become registers after mem2reg */
+export struct Array
+{
+    llvm::AllocaInst *elements; /* ptr to the first element: on stack of function or on heap */
+    llvm::AllocaInst *size;     /* i32. 0, until array is declared: every access is out of range */
+    llvm::AllocaInst *storage;  /* ptr to heap elements, which must be freed, or null */
+    llvm::Value *name;          /* string for error messages */
+    bool heap = false;          /* some of declarations allocates elements on heap */
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
 export class Nametable final
 {
   private:
     llvm::Module &module_;
     llvm::IRBuilder<> &builder_;
 
-    std::vector<std::unordered_map<std::string_view, llvm::AllocaInst *>> scopes_;
+    std::vector<std::unordered_map<last::node::Symbol, llvm::Value *, last::node::SymbolHash>> scopes_; /* address of variable */
+    std::vector<std::unordered_map<last::node::Symbol, Array, last::node::SymbolHash>> array_scopes_;
 
-    llvm::AllocaInst *lookup(std::string_view name);
-    void declare(std::string_view name, llvm::Value * = nullptr);
+    llvm::Value *lookup(last::node::Symbol name);
+    void declare(last::node::Symbol name, llvm::Value * = nullptr);
+    llvm::AllocaInst *create_entry_alloca(std::string_view name);
+    llvm::AllocaInst *create_entry_alloca(llvm::Type *type, llvm::Constant *initial, std::string_view name);
 
   public:
     Nametable(llvm::Module &module, llvm::IRBuilder<> &builder);
@@ -44,10 +66,22 @@ export class Nametable final
     void new_scope();
     void leave_scope();
 
-    llvm::AllocaInst *get_variable(std::string_view name);
-    llvm::Value *get_variable_value(std::string_view name);
+    llvm::Value *get_variable(last::node::Symbol name);
+    llvm::Value *get_variable_value(last::node::Symbol name);
+
+    void set_value(last::node::Symbol name, llvm::Value *value);
 
-    void set_value(std::string_view name, llvm::Value *value);
+    /* variable, which lives outside of generated code (for example, in interpreter frame) */
+    void bind(last::node::Symbol name, llvm::Value *address);
+
+    Array *get_array(last::node::Symbol name);
+    Array &declare_array(last::node::Symbol name);
+
+    /* arrays of the innermost scope: their elements are freed, before it`s left */
+    std::vector<Array *> scope_arrays();
+
+    /* elements of array with size known at compile time */
+    llvm::AllocaInst *create_entry_array(uint64_t size, std::string_view name);
 };
 
 //---------------------------------------------------------------------------------------------------------------
@@ -62,7 +96,9 @@ Nametable::Nametable(llvm::Module &module, llvm::IRBuilder<> &builder)
 void Nametable::new_scope()
 {
     LOGINFO("paracl: compiler: nametable: create next scope");
+    last::stats::count(last::stats::Counter::SCOPES_PUSHED);
     scopes_.emplace_back();
+    array_scopes_.emplace_back();
 }
 
 //---------------------------------------------------------------------------------------------------------------
@@ -72,13 +108,15 @@ void Nametable::leave_scope()
     LOGINFO("paracl: compiler: nametable: exiting scope");
     if (scopes_.empty()) return;
     scopes_.pop_back();
+    array_scopes_.pop_back();
 }
 
 //---------------------------------------------------------------------------------------------------------------
 
-llvm::AllocaInst *Nametable::get_variable(std::string_view name)
+llvm::Value *Nametable::get_variable(last::node::Symbol name)
 {
     LOGINFO("paracl: compiler: nametable: searching variable: \"{}\"", name);
+    last::stats::count(last::stats::Counter::NAMETABLE_LOOKUPS);
 
     for (auto &&scopes_it : scopes_ | std::views::reverse)
     {
@@ -94,18 +132,20 @@ llvm::AllocaInst *Nametable::get_variable(std::string_view name)
 
 //---------------------------------------------------------------------------------------------------------------
 
-llvm::Value *Nametable::get_variable_value(std::string_view name)
+llvm::Value *Nametable::get_variable_value(last::node::Symbol name)
 {
     auto&& var = get_variable(name);
 
-    if (not var) return nullptr;
+    /* not nullptr: it would crash llvm later, and hot loop of interpreter must be able to stay interpreted */
+    if (not var)
+        throw std::runtime_error(std::string("requests value of not exists variable: ") + std::string(name.name()));
 
-    return builder_.CreateLoad(builder_.getInt32Ty(), var, std::string(name) + "_load");
+    return builder_.CreateLoad(builder_.getInt32Ty(), var, std::string(name.name()) + "_load");
 }
 
 //---------------------------------------------------------------------------------------------------------------
 
-void Nametable::set_value(std::string_view name, llvm::Value *value)
+void Nametable::set_value(last::node::Symbol name, llvm::Value *value)
 {
     LOGINFO("paracl: compiler: nametable: set \"{}\"", name);
 
@@ -119,13 +159,99 @@ void Nametable::set_value(std::string_view name, llvm::Value *value)
     builder_.CreateStore(value, var);
 }
 
+//---------------------------------------------------------------------------------------------------------------
+
+void Nametable::bind(last::node::Symbol name, llvm::Value *address)
+{
+    LOGINFO("paracl: compiler: nametable: bind \"{}\"", name);
+
+    if (scopes_.empty())
+        throw std::runtime_error("cannot bind variable: no active scopes");
+
+    scopes_.back()[name] = address;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+Array *Nametable::get_array(last::node::Symbol name)
+{
+    LOGINFO("paracl: compiler: nametable: searching array: \"{}\"", name);
+    last::stats::count(last::stats::Counter::NAMETABLE_LOOKUPS);
+
+    for (auto &&scopes_it : array_scopes_ | std::views::reverse)
+    {
+        auto&& found = scopes_it.find(name);
+        if (found == scopes_it.end()) continue;
+        return &found->second;
+    }
+
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* declaration of visible array creates it again, so the same parts are used */
+Array &Nametable::declare_array(last::node::Symbol name)
+{
+    if (auto&& array = get_array(name)) return *array;
+
+    LOGINFO("paracl: compiler: nametable: declare array \"{}\"", name);
+
+    if (array_scopes_.empty())
+        throw std::runtime_error("cannot declare array: no active scopes");
+
+    auto&& ptr_type = builder_.getInt8Ty()->getPointerTo();
+    auto&& null     = llvm::ConstantPointerNull::get(ptr_type);
+    auto&& string   = std::string(name.name());
+
+    return array_scopes_.back()[name] = Array{
+        .elements = create_entry_alloca(ptr_type, null, string + "_elements"),
+        .size     = create_entry_alloca(builder_.getInt32Ty(), builder_.getInt32(0), string + "_size"),
+        .storage  = create_entry_alloca(ptr_type, null, string + "_storage"),
+        .name     = builder_.CreateGlobalStringPtr(string, "__arrayName"),
+    };
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::vector<Array *> Nametable::scope_arrays()
+{
+    auto&& arrays = std::vector<Array *>{};
+    if (array_scopes_.empty()) return arrays;
+
+    /* in order of names: the same program is always translated to the same module */
+    auto&& names = std::vector<last::node::Symbol>{};
+    for (auto&& [name, array] : array_scopes_.back())
+        names.push_back(name);
+
+    std::ranges::sort(names, {}, [](auto&& name) { return name.name(); });
+
+    for (auto&& name : names)
+        arrays.push_back(&array_scopes_.back().at(name));
+
+    return arrays;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* entry block, as for variables: array, declared in loop, doesn`t grow the stack on every iteration */
+llvm::AllocaInst *Nametable::create_entry_array(uint64_t size, std::string_view name)
+{
+    auto&& entry = builder_.GetInsertBlock()->getParent()->getEntryBlock();
+    auto&& entry_builder = llvm::IRBuilder<>{&entry, entry.begin()};
+
+    return entry_builder.CreateAlloca(llvm::ArrayType::get(entry_builder.getInt32Ty(), size), nullptr, name);
+}
+
 // private
 //---------------------------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------------------------
 
-llvm::AllocaInst *Nametable::lookup(std::string_view name)
+llvm::Value *Nametable::lookup(last::node::Symbol name)
 {
+    last::stats::count(last::stats::Counter::NAMETABLE_LOOKUPS);
+
     for (auto &&scopes_it : scopes_ | std::views::reverse)
     {
         auto&& found = scopes_it.find(name);
@@ -141,7 +267,7 @@ llvm::AllocaInst *Nametable::lookup(std::string_view name)
 
 //---------------------------------------------------------------------------------------------------------------
 
-void Nametable::declare(std::string_view name, llvm::Value *value)
+void Nametable::declare(last::node::Symbol name, llvm::Value *value)
 {
     LOGINFO("paracl: compiler: nametable: declare \"{}\"", name);
 
@@ -149,7 +275,7 @@ void Nametable::declare(std::string_view name, llvm::Value *value)
         throw std::runtime_error("cannot declare variable: no active scopes");
 
     auto&& var = scopes_.back()[name];
-    var = builder_.CreateAlloca(builder_.getInt32Ty(), nullptr, name);
+    var = create_entry_alloca(name.name());
 
     if (not value) return;
 
@@ -158,6 +284,32 @@ void Nametable::declare(std::string_view name, llvm::Value *value)
 
 //---------------------------------------------------------------------------------------------------------------
 
+/*
+variable can be declared inside while body or on one side of 'and'/'or'. alloca there would grow the stack
+on every iteration, wouldn`t dominate later uses and couldn`t be promoted to register by mem2reg/SROA,
+so every alloca is placed in entry block of the function. it`s initialized by 0 there: value is defined,
+even if the declaring assignment is skipped.
+*/
+llvm::AllocaInst *Nametable::create_entry_alloca(std::string_view name)
+{
+    return create_entry_alloca(builder_.getInt32Ty(), builder_.getInt32(0), name);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+llvm::AllocaInst *Nametable::create_entry_alloca(llvm::Type *type, llvm::Constant *initial, std::string_view name)
+{
+    auto&& entry = builder_.GetInsertBlock()->getParent()->getEntryBlock();
+    auto&& entry_builder = llvm::IRBuilder<>{&entry, entry.begin()};
+
+    auto&& var = entry_builder.CreateAlloca(type, nullptr, name);
+    entry_builder.CreateStore(initial, var);
+
+    return var;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
 } /* namespace compiler::nametable */
 
 //---------------------------------------------------------------------------------------------------------------
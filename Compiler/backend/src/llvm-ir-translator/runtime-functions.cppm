@@ -0,0 +1,139 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <llvm/IR/Attributes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/ModRef.h>
+
+#include <string>
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module runtime_functions;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace compiler::llvm_ir_translator
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+declarations of paracl-rt (see runtime/paracl-rt.h).
+runtime touches only its own buffers and stdio, which are not visible to program (inaccessible memory),
+so llvm keeps variables in registers around print and scan, and moves calculations across them.
+*/
+export
+class RuntimeFunctions final
+{
+  private:
+    llvm::Function *write_int_;
+    llvm::Function *write_str_;
+    llvm::Function *newline_;
+    llvm::Function *read_int_;
+    llvm::Function *flush_;
+    llvm::Function *profile_init_;
+    llvm::Function *array_new_;
+    llvm::Function *array_delete_;
+    llvm::Function *out_of_range_;
+
+  public:
+    explicit RuntimeFunctions(llvm::Module &module, llvm::IRBuilder<> &builder);
+
+    llvm::Function *write_int() const & noexcept { return write_int_; } /* void (i32)      */
+    llvm::Function *write_str() const & noexcept { return write_str_; } /* void (ptr, i64) */
+    llvm::Function *newline()   const & noexcept { return newline_;   } /* void ()         */
+    llvm::Function *read_int()  const & noexcept { return read_int_;  } /* i32 ()          */
+    llvm::Function *flush()     const & noexcept { return flush_;     } /* void ()         */
+
+    /* void (ptr counters, i32 count, i64 checksum, ptr file): only in programs, compiled with --instrument */
+    llvm::Function *profile_init() const & noexcept { return profile_init_; }
+
+    llvm::Function *array_new()    const & noexcept { return array_new_;    } /* ptr (ptr name, i64, i32 size)           */
+    llvm::Function *array_delete() const & noexcept { return array_delete_; } /* void (ptr)                              */
+    llvm::Function *out_of_range() const & noexcept { return out_of_range_; } /* void (ptr name, i64, i32 index, i32 size) */
+
+  private:
+    static llvm::Function *declare(llvm::Module &module, llvm::FunctionType *type, std::string const &name,
+                                   llvm::MemoryEffects memory);
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+llvm::Function *RuntimeFunctions::declare(llvm::Module &module, llvm::FunctionType *type, std::string const &name,
+                                          llvm::MemoryEffects memory)
+{
+    auto&& function = llvm::Function::Create(type, llvm::Function::ExternalLinkage, name, module);
+
+    function->setDoesNotThrow();
+    function->setDoesNotFreeMemory();
+    function->setMemoryEffects(memory);
+
+    return function;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+RuntimeFunctions::RuntimeFunctions(llvm::Module &module, llvm::IRBuilder<> &builder)
+{
+    auto&& void_type = builder.getVoidTy();
+    auto&& i32_type  = builder.getInt32Ty();
+    auto&& i64_type  = builder.getInt64Ty();
+    auto&& ptr_type  = builder.getInt8Ty()->getPointerTo();
+
+    auto&& runtime_memory = llvm::MemoryEffects::inaccessibleMemOnly();
+
+    write_int_ = declare(module, llvm::FunctionType::get(void_type, {i32_type}, false), "prt_write_int", runtime_memory);
+    newline_   = declare(module, llvm::FunctionType::get(void_type, false), "prt_newline", runtime_memory);
+    flush_     = declare(module, llvm::FunctionType::get(void_type, false), "prt_flush", runtime_memory);
+
+    /* string is only read */
+    write_str_ = declare(module, llvm::FunctionType::get(void_type, {ptr_type, i64_type}, false), "prt_write_str",
+                         runtime_memory | llvm::MemoryEffects::argMemOnly(llvm::ModRefInfo::Ref));
+    write_str_->addParamAttr(0, llvm::Attribute::NoCapture);
+    write_str_->addParamAttr(0, llvm::Attribute::ReadOnly);
+    write_str_->addParamAttr(0, llvm::Attribute::NonNull);
+
+    /* not willreturn: program is terminated on bad input */
+    read_int_ = declare(module, llvm::FunctionType::get(i32_type, false), "prt_read_int", runtime_memory);
+
+    /* runtime keeps address of counters and reads them at exit: so it`s not inaccessible memory */
+    profile_init_ = declare(module, llvm::FunctionType::get(void_type, {ptr_type, i32_type, i64_type, ptr_type}, false),
+                            "prt_profile_init", llvm::MemoryEffects::unknown());
+    profile_init_->addParamAttr(3, llvm::Attribute::ReadOnly);
+
+    /* elements are not visible to runtime after allocation: noalias, as of malloc. terminates on negative size */
+    auto&& name_memory = runtime_memory | llvm::MemoryEffects::argMemOnly(llvm::ModRefInfo::Ref);
+
+    array_new_ = declare(module, llvm::FunctionType::get(ptr_type, {ptr_type, i64_type, i32_type}, false), "prt_array_new",
+                         name_memory);
+    array_new_->addRetAttr(llvm::Attribute::NoAlias);
+    array_new_->addRetAttr(llvm::Attribute::NonNull);
+
+    array_delete_ = declare(module, llvm::FunctionType::get(void_type, {ptr_type}, false), "prt_array_delete",
+                            llvm::MemoryEffects::inaccessibleOrArgMemOnly());
+    array_delete_->removeFnAttr(llvm::Attribute::NoFree);
+    array_delete_->addParamAttr(0, llvm::Attribute::NoCapture);
+
+    /* cold and noreturn: failing branch of bounds check is moved out of loops and doesn`t block their optimization */
+    out_of_range_ = declare(module, llvm::FunctionType::get(void_type, {ptr_type, i64_type, i32_type, i32_type}, false),
+                            "prt_out_of_range", name_memory);
+    out_of_range_->setDoesNotReturn();
+    out_of_range_->addFnAttr(llvm::Attribute::Cold);
+
+    for (auto&& function : {array_new_, out_of_range_})
+    {
+        function->addParamAttr(0, llvm::Attribute::NoCapture);
+        function->addParamAttr(0, llvm::Attribute::ReadOnly);
+    }
+
+    for (auto&& function : {write_int_, write_str_, newline_, flush_, profile_init_, array_delete_})
+        function->addFnAttr(llvm::Attribute::WillReturn);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace compiler::llvm_ir_translator */
+//---------------------------------------------------------------------------------------------------------------
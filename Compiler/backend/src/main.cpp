@@ -1,20 +1,40 @@
-#warning "Using version, with stupid options parsing"
-
 #include <iostream>
 #include <exception>
+#include <filesystem>
 #include <stdexcept>
 #include <string>
+#include <cstddef>
 
 import compiler;
+import options;
+import thelast;
 
 int main(int argc, char* argv[]) try
 {
-    if (argc == 2)
-        compiler::compile(argv[1], "a.out");
-    else if (argc == 4)
-        compiler::compile(argv[1]/* = .ast.json */, /* argv[2] = -o , */ argv[3] /* = executable */);
-    else
-        throw std::invalid_argument("Usage: " + std::string(argv[0]) + " <source>.ast.json [-o executbale]");
+    /* <source>.ast.json|<source>.ast.bin... [-o executable|directory] [-O0..3] [-mcpu=<cpu>] [-v] [--instrument|--profile-use=<file>] */
+    auto&& options = compiler::options::handleCompileOpts(argc, argv);
+
+    /* --time-report, --stats and --time-trace of paraclc --via-files come through environment */
+    last::stats::start("paracl-compiler", {});
+
+    auto&& compile_options = compiler::CompileOptions{
+        .optimization_level = options.optimizationLevel,
+        .target_cpu         = options.targetCpu,
+        .verbose            = options.verbose,
+        .profile_file       = options.profileUse
+    };
+
+    auto&& codegen = compiler::Codegen{compiler::Toolchain{compile_options}};
+
+    for (size_t it = 0, ite = options.inputFiles.size(); it != ite; ++it)
+    {
+        auto&& executable = options.outputFiles[it];
+
+        compile_options.instrument_file = options.instrument ? std::filesystem::path{executable.string() + ".profile"}
+                                                             : std::filesystem::path{};
+
+        codegen.compile(options.inputFiles[it], executable, compile_options);
+    }
 
     return 0;
 }
@@ -28,4 +48,3 @@ catch (...)
     std::cerr << "Undefined exceptions catched.\n";
     return 1;
 }
-
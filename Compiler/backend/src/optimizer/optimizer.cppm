@@ -0,0 +1,81 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <llvm/IR/Module.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/Mem2Reg.h>
+
+#include <stdexcept>
+#include <string>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module optimizer;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace compiler::optimizer
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+llvm::OptimizationLevel to_optimization_level(unsigned level)
+{
+    switch (level)
+    {
+        case 0: return llvm::OptimizationLevel::O0;
+        case 1: return llvm::OptimizationLevel::O1;
+        case 2: return llvm::OptimizationLevel::O2;
+        case 3: return llvm::OptimizationLevel::O3;
+        default: break;
+    }
+
+    throw std::invalid_argument("Unsupported optimization level: " + std::to_string(level));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+runs default -O<level> pipeline of new pass manager on module in memory.
+target_machine may be nullptr, but with it passes know about target (vectorization, cost model, etc.)
+*/
+export
+void optimize(llvm::Module & module, unsigned level, llvm::TargetMachine * target_machine = nullptr)
+{
+    LOGINFO("paracl: optimizer: running -O{} pipeline on '{}'", level, module.getName().str());
+
+    auto&& optimization_level = to_optimization_level(level);
+
+    auto&& loop_analysis     = llvm::LoopAnalysisManager{};
+    auto&& function_analysis = llvm::FunctionAnalysisManager{};
+    auto&& cgscc_analysis    = llvm::CGSCCAnalysisManager{};
+    auto&& module_analysis   = llvm::ModuleAnalysisManager{};
+
+    auto&& pass_builder = llvm::PassBuilder{target_machine};
+
+    pass_builder.registerModuleAnalyses  (module_analysis);
+    pass_builder.registerCGSCCAnalyses   (cgscc_analysis);
+    pass_builder.registerFunctionAnalyses(function_analysis);
+    pass_builder.registerLoopAnalyses    (loop_analysis);
+    pass_builder.crossRegisterProxies(loop_analysis, function_analysis, cgscc_analysis, module_analysis);
+
+    auto&& pipeline = (optimization_level == llvm::OptimizationLevel::O0)
+                    ? pass_builder.buildO0DefaultPipeline(optimization_level)
+                    : pass_builder.buildPerModuleDefaultPipeline(optimization_level);
+
+    /* variables are allocas of entry block (see nametable), so even -O0 code keeps them in registers */
+    if (optimization_level == llvm::OptimizationLevel::O0)
+        pipeline.addPass(llvm::createModuleToFunctionPassAdaptor(llvm::PromotePass{}));
+
+    pipeline.run(module, module_analysis);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace compiler::optimizer */
+//---------------------------------------------------------------------------------------------------------------
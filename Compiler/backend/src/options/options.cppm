@@ -1,7 +1,5 @@
 module;
 
-#error "Unsupported now"
-
 #include <cstdlib>
 #include <string>
 #include <iostream>
@@ -9,21 +7,25 @@ module;
 #include <stdexcept>
 #include <sstream>
 #include <filesystem>
+#include <algorithm>
+#include <vector>
 
 #include <llvm/Support/CommandLine.h>
 
 export module options;
 
-llvm::cl::opt<std::string> AstJsonFile(
+/* -help and -version are registered by llvm itself */
+
+llvm::cl::list<std::string> InputFiles(
     llvm::cl::Positional,
-    llvm::cl::desc("<input .ast.json file>"),
-    llvm::cl::Required,
+    llvm::cl::desc("<input files>"),
+    llvm::cl::OneOrMore,
     llvm::cl::value_desc("filename")
 );
 
 llvm::cl::opt<std::string> OutputFileName(
     "o",
-    llvm::cl::desc("Specify output executable filename"),
+    llvm::cl::desc("Specify output executable filename (directory of executables, if there are several inputs)"),
     llvm::cl::value_desc("filename"),
     llvm::cl::init("a.out")
 );
@@ -34,18 +36,27 @@ llvm::cl::alias OutputAlias(
     llvm::cl::aliasopt(OutputFileName)
 );
 
-// Уровень оптимизации
-llvm::cl::opt<int> OptimizationLevel(
+// Уровень оптимизации: -O0 .. -O3, как у llc
+llvm::cl::opt<char> OptimizationLevel(
     "O",
-    llvm::cl::desc("Optimization level. Choose from:"),
+    llvm::cl::desc("Optimization level: -O0, -O1, -O2 or -O3 (default)"),
     llvm::cl::value_desc("level"),
-    llvm::cl::values(
-        clEnumValN(0, "0", "No optimizations (default)"),
-        clEnumValN(1, "1", "Basic optimizations"),
-        clEnumValN(2, "2", "Aggressive optimizations"),
-        clEnumValN(3, "3", "Maximum optimizations")
-    ),
-    llvm::cl::init(0)
+    llvm::cl::Prefix,
+    llvm::cl::init('3')
+);
+
+// Процессор, под который генерируется код
+llvm::cl::opt<std::string> TargetCpu(
+    "mcpu",
+    llvm::cl::desc("Target cpu: 'generic' (default), 'native' (cpu of this machine) or llvm cpu name (e.g. 'skylake')"),
+    llvm::cl::value_desc("cpu"),
+    llvm::cl::init("generic")
+);
+
+llvm::cl::alias TargetCpuAlias(
+    "march",
+    llvm::cl::desc("Alias for -mcpu"),
+    llvm::cl::aliasopt(TargetCpu)
 );
 
 // Verbose mode
@@ -61,24 +72,17 @@ llvm::cl::alias VerboseAlias(
     llvm::cl::aliasopt(VerboseMode)
 );
 
-// Help option
-llvm::cl::opt<bool> ShowHelp(
-    "help",
-    llvm::cl::desc("Show this help message"),
+// Профилирование: сборка со счётчиками и оптимизация по собранному профилю
+llvm::cl::opt<bool> Instrument(
+    "instrument",
+    llvm::cl::desc("Count executions of loops and branches: program writes counters to <executable>.profile at exit"),
     llvm::cl::init(false)
 );
 
-llvm::cl::alias HelpAlias(
-    "h",
-    llvm::cl::desc("Alias for --help"),
-    llvm::cl::aliasopt(ShowHelp)
-);
-
-// Version option
-llvm::cl::opt<bool> ShowVersion(
-    "version",
-    llvm::cl::desc("Show version information"),
-    llvm::cl::init(false)
+llvm::cl::opt<std::string> ProfileUse(
+    "profile-use",
+    llvm::cl::desc("Optimize by profile, written by program, compiled with --instrument"),
+    llvm::cl::value_desc("file")
 );
 
 export namespace compiler::options
@@ -86,47 +90,69 @@ export namespace compiler::options
 
 struct Options
 {
-    std::filesystem::path astJsonFile;
-    std::filesystem::path outputFile;
-    int optimizationLevel;
+    std::vector<std::filesystem::path> inputFiles;
+    std::vector<std::filesystem::path> outputFiles; /* executable of every input */
+    unsigned optimizationLevel;
+    std::string targetCpu;
     bool verbose;
+    bool instrument;
+    std::filesystem::path profileUse; /* empty: no profile */
 };
 
 Options handleCompileOpts(int argc, char** argv)
 {
     llvm::cl::ParseCommandLineOptions(argc, argv);
 
-    if (ShowHelp)
+    auto&& optLevel = OptimizationLevel.getValue();
+    if ((optLevel < '0') || ('3' < optLevel))
+        throw std::invalid_argument(std::string("ParaCL: error: optimization level '-O") + optLevel + "' is not supported");
+
+    auto&& inputPaths  = std::vector<std::filesystem::path>{InputFiles.begin(), InputFiles.end()};
+    auto&& outputPaths = std::vector<std::filesystem::path>{};
+
+    for (auto&& inputPath : inputPaths)
+        if (not std::filesystem::exists(inputPath))
+            throw std::runtime_error("ParaCL: error: No such file: " + inputPath.string());
+
+    if (inputPaths.size() == 1)
+        outputPaths.emplace_back(OutputFileName.getValue());
+    else
     {
-        llvm::cl::PrintHelpMessage();
-        exit(EXIT_SUCCESS);
-    }
+        /* several inputs: -o is directory (current by default), executables are named after sources */
+        auto&& outputDir = std::filesystem::path{OutputFileName.getNumOccurrences() ? OutputFileName.getValue() : "."};
+        std::filesystem::create_directories(outputDir);
 
-    // if (ShowVersion)
-    // {
-        // /std::cout << "ParaCL compiler version: " << ParaCL::general::projInfo::ParaCLVersion << '\n';
-        // exit(EXIT_SUCCESS);
-    // }
+        for (auto&& inputPath : inputPaths)
+        {
+            auto&& outputPath = outputDir / inputPath.stem();
 
-    auto&& optLevel = OptimizationLevel.getValue();
-    if ((optLevel < 0) || (3 < optLevel))
-        std::cerr << "ParaCL: warning: optimization level '-O" << optLevel << "' is not supported; using '-O3' instead\n";
+            if (std::ranges::find(outputPaths, outputPath) != outputPaths.end())
+                throw std::invalid_argument("ParaCL: error: several inputs have the same executable " + outputPath.string());
+
+            outputPaths.push_back(std::move(outputPath));
+        }
+    }
+
+    auto&& profilePath = std::filesystem::path{ProfileUse.getValue()};
 
-    auto&& inputPath  = std::filesystem::path{AstJsonFile   .getValue()};
-    auto&& outputPath = std::filesystem::path{OutputFileName.getValue()};
+    if (Instrument and not profilePath.empty())
+        throw std::invalid_argument("ParaCL: error: '--instrument' and '--profile-use' can`t be used together");
 
-    if (not std::filesystem::exists(inputPath))
-        throw std::runtime_error("ParaCL: error: No such file: " + inputPath.string());
+    if (not profilePath.empty() and inputPaths.size() != 1)
+        throw std::invalid_argument("ParaCL: error: '--profile-use' is profile of one program, but there are several inputs");
 
-    if ((inputPath.extension() != ".ast.json") and (inputPath.extension() != ".json"))
-        throw std::runtime_error("ParaCL: error: source file must must have extension '.ast.json'");
+    if (not profilePath.empty() and not std::filesystem::exists(profilePath))
+        throw std::runtime_error("ParaCL: error: No such profile: " + profilePath.string());
 
     return Options
     {
-        .astJsonFile = inputPath,
-        .outputFile = outputPath,
-        .optimizationLevel = optLevel,
-        .verbose = VerboseMode.getValue()
+        .inputFiles = std::move(inputPaths),
+        .outputFiles = std::move(outputPaths),
+        .optimizationLevel = static_cast<unsigned>(optLevel - '0'),
+        .targetCpu = TargetCpu.getValue(),
+        .verbose = VerboseMode.getValue(),
+        .instrument = Instrument.getValue(),
+        .profileUse = profilePath
     };
 }
 
@@ -0,0 +1,281 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module pgo;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace compiler::pgo
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+counters, written by instrumented program (see prt_profile_init of paracl-rt).
+text file:
+    paracl-profile 1
+    checksum <checksum of control flow>
+    counters <count>
+    <counter 0>
+    ...
+*/
+export
+struct Profile
+{
+    uint64_t checksum = 0;
+    std::vector<uint64_t> counters;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+export
+Profile read_profile(std::filesystem::path const & file)
+{
+    auto&& in = std::ifstream{file};
+    if (not in.is_open())
+        throw std::runtime_error("Failed to open profile '" + file.string() + "'");
+
+    auto&& magic    = std::string{};
+    auto&& version  = 0u;
+    auto&& checksum = std::string{};
+    auto&& counters = std::string{};
+    auto&& count    = size_t{0};
+    auto&& profile  = Profile{};
+
+    in >> magic >> version >> checksum >> profile.checksum >> counters >> count;
+
+    if (not in or magic != "paracl-profile" or version != 1 or checksum != "checksum" or counters != "counters")
+        throw std::runtime_error("Bad profile '" + file.string() + "': it`s not written by program, compiled with --instrument");
+
+    profile.counters.resize(count);
+    for (auto&& counter : profile.counters) in >> counter;
+
+    if (not in)
+        throw std::runtime_error("Bad profile '" + file.string() + "': expected " + std::to_string(count) + " counters");
+
+    return profile;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* what translator does with counters of branches. both are off by default */
+export
+struct Options
+{
+    std::optional<std::filesystem::path> instrument; /* program counts branches and writes counters to this file at exit */
+    std::optional<Profile>               use;        /* branches get weights from counters of previous runs */
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* place of counter in control flow. checksum of profile is made of them, so profile of other program is not used */
+export
+enum class Point : uint64_t
+{
+    WHILE_CONDITION = 1, /* every check of loop condition */
+    WHILE_BODY      = 2, /* every iteration                */
+    IF_CONDITION    = 3, /* every check of if (or elif)    */
+    IF_BODY         = 4, /* every execution of its body    */
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+counters of one module. translator asks for a counter at the beginning of every block, which is counted,
+and gives conditional branches with their counters. counters get the same numbers in every translation of the same ast:
+so --instrument and --profile-use builds agree about them.
+*/
+export
+class Counters final
+{
+  private:
+    /* branch goes to taken_block 'taken' times from 'total' */
+    struct Branch
+    {
+        llvm::BranchInst* branch;
+        llvm::BasicBlock* taken_block;
+        uint32_t          taken;
+        uint32_t          total;
+    };
+
+    static constexpr uint64_t fnv_offset = 14695981039346656037ULL;
+    static constexpr uint64_t fnv_prime  = 1099511628211ULL;
+
+    Options options_;
+    llvm::Module& module_;
+    llvm::IRBuilder<>& builder_;
+
+    llvm::GlobalVariable* counters_ = nullptr; /* placeholder: size of array is known only at the end */
+    std::vector<Branch> branches_;
+    uint32_t size_ = 0;
+    uint64_t checksum_ = fnv_offset;
+
+  public:
+    Counters(Options options, llvm::Module& module, llvm::IRBuilder<>& builder);
+
+    /* new counter at insertion point of builder. instrumented program increments it there */
+    uint32_t count(Point point);
+
+    /* branch may be nullptr: conditions with 'and'/'or' are several branches, they keep weights of llvm */
+    void weigh(llvm::BranchInst* branch, llvm::BasicBlock* taken_block, uint32_t taken, uint32_t total);
+
+    /* at the end of translation: counters are registered in runtime at entry of main, or weights are set */
+    void finish(llvm::Function& main, llvm::Function* profile_init);
+
+  private:
+    void mix_(uint64_t value);
+    void instrument_(llvm::Function& main, llvm::Function* profile_init);
+    void use_(Profile const & profile);
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+Counters::Counters(Options options, llvm::Module& module, llvm::IRBuilder<>& builder) :
+options_(std::move(options)), module_(module), builder_(builder)
+{
+    if (options_.instrument and options_.use)
+        throw std::invalid_argument("Program can`t be instrumented and optimized by profile at the same time");
+
+    if (not options_.instrument) return;
+
+    auto&& i64 = builder_.getInt64Ty();
+    counters_ = new llvm::GlobalVariable(module_, i64, false, llvm::GlobalValue::InternalLinkage,
+                                         llvm::ConstantInt::get(i64, 0), "__paracl_profile_counters.placeholder");
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Counters::mix_(uint64_t value)
+{
+    for (auto&& byte = 0; byte != 8; ++byte)
+    {
+        checksum_ ^= (value >> (8 * byte)) & 0xff;
+        checksum_ *= fnv_prime;
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+uint32_t Counters::count(Point point)
+{
+    auto&& index = size_++;
+    mix_(static_cast<uint64_t>(point));
+
+    if (not counters_) return index;
+
+    auto&& i64     = builder_.getInt64Ty();
+    auto&& address = builder_.CreateConstInBoundsGEP1_32(i64, counters_, index, "__counter");
+    auto&& value   = builder_.CreateLoad(i64, address);
+    builder_.CreateStore(builder_.CreateAdd(value, llvm::ConstantInt::get(i64, 1)), address);
+
+    return index;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Counters::weigh(llvm::BranchInst* branch, llvm::BasicBlock* taken_block, uint32_t taken, uint32_t total)
+{
+    if (not branch or not options_.use) return;
+    branches_.push_back(Branch{branch, taken_block, taken, total});
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Counters::finish(llvm::Function& main, llvm::Function* profile_init)
+{
+    mix_(size_);
+
+    if (options_.instrument) instrument_(main, profile_init);
+    if (options_.use)        use_(*options_.use);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Counters::instrument_(llvm::Function& main, llvm::Function* profile_init)
+{
+    LOGINFO("paracl: pgo: {} counters, checksum {}", size_, checksum_);
+
+    auto&& i64   = builder_.getInt64Ty();
+    auto&& array = llvm::ArrayType::get(i64, size_);
+
+    auto&& counters = new llvm::GlobalVariable(module_, array, false, llvm::GlobalValue::InternalLinkage,
+                                               llvm::ConstantAggregateZero::get(array), "__paracl_profile_counters");
+
+    counters_->replaceAllUsesWith(counters);
+    counters_->eraseFromParent();
+    counters_ = counters;
+
+    /* after allocas of variables: they stay together at the beginning of entry block */
+    auto&& entry   = main.getEntryBlock();
+    auto&& builder = llvm::IRBuilder<>{&entry, entry.getFirstNonPHIOrDbgOrAlloca()};
+
+    builder.CreateCall(profile_init, {
+        counters,
+        builder.getInt32(size_),
+        builder.getInt64(checksum_),
+        builder.CreateGlobalStringPtr(options_.instrument->string(), "__paracl_profile_file")
+    });
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Counters::use_(Profile const & profile)
+{
+    if (profile.checksum != checksum_ or profile.counters.size() != size_)
+    {
+        llvm::errs() << "paraclc: warning: profile doesn`t match the program (it was changed or compiled with other -O), "
+                        "profile is not used\n";
+        return;
+    }
+
+    auto&& weights = llvm::MDBuilder{module_.getContext()};
+
+    for (auto&& [branch, taken_block, taken_counter, total_counter] : branches_)
+    {
+        auto&& taken = profile.counters[taken_counter];
+        auto&& total = std::max(profile.counters[total_counter], taken);
+
+        /* never executed: nothing is known */
+        if (total == 0) continue;
+
+        /* weights are 32-bit: big counters are scaled down together */
+        auto&& scale     = total / std::numeric_limits<uint32_t>::max() + 1;
+        auto&& taken_w   = static_cast<uint32_t>(taken / scale);
+        auto&& skipped_w = static_cast<uint32_t>((total - taken) / scale);
+
+        auto&& node = (branch->getSuccessor(0) == taken_block)
+                    ? weights.createBranchWeights(taken_w, skipped_w)
+                    : weights.createBranchWeights(skipped_w, taken_w);
+
+        branch->setMetadata(llvm::LLVMContext::MD_prof, node);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace compiler::pgo */
+//---------------------------------------------------------------------------------------------------------------
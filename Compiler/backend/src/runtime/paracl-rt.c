@@ -0,0 +1,279 @@
+/* getc_unlocked, isatty */
+#define _POSIX_C_SOURCE 200809L
+
+#include "paracl-rt.h"
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+#define PRT_BUFFER_SIZE (1 << 16)
+
+/* enough for INT32_MIN */
+#define PRT_INT_MAX_LENGTH 11
+
+static char   prt_buffer[PRT_BUFFER_SIZE];
+static size_t prt_size;
+static int    prt_line_buffered;
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+/* output goes through stdio: so it keeps order with output of host, which runs compiled code in its process */
+void prt_flush(void)
+{
+    if (prt_size == 0) return;
+
+    fwrite(prt_buffer, 1, prt_size, stdout);
+    prt_size = 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+__attribute__((constructor))
+static void prt_init(void)
+{
+    prt_line_buffered = isatty(STDOUT_FILENO);
+
+    /* runs before stdio flushes its buffers at exit */
+    atexit(prt_flush);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+void prt_set_line_buffered(int line_buffered)
+{
+    prt_line_buffered = line_buffered;
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+void prt_write_int(int32_t value)
+{
+    if (PRT_BUFFER_SIZE - prt_size < PRT_INT_MAX_LENGTH) prt_flush();
+
+    /* digits are written from the end of temporary buffer: unsigned, so INT32_MIN is negated correctly */
+    char digits[PRT_INT_MAX_LENGTH];
+    char* begin = digits + PRT_INT_MAX_LENGTH;
+
+    uint32_t magnitude = (value < 0) ? 0u - (uint32_t) value : (uint32_t) value;
+
+    do
+    {
+        *--begin = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (value < 0) *--begin = '-';
+
+    size_t length = (size_t) (digits + PRT_INT_MAX_LENGTH - begin);
+    memcpy(prt_buffer + prt_size, begin, length);
+    prt_size += length;
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+void prt_write_str(char const * data, size_t size)
+{
+    if (PRT_BUFFER_SIZE - prt_size < size) prt_flush();
+
+    if (PRT_BUFFER_SIZE < size)
+    {
+        fwrite(data, 1, size, stdout);
+        return;
+    }
+
+    memcpy(prt_buffer + prt_size, data, size);
+    prt_size += size;
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+void prt_newline(void)
+{
+    if (prt_size == PRT_BUFFER_SIZE) prt_flush();
+
+    prt_buffer[prt_size++] = '\n';
+
+    if (!prt_line_buffered) return;
+
+    prt_flush();
+    fflush(stdout);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+static void prt_input_error(char const * message)
+{
+    prt_flush();
+    fflush(stdout);
+
+    fprintf(stderr, "paracl: scan: %s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+/* stdin is read by stdio (by big blocks), position in stream is shared with host interpreter in paracl --tiered */
+int32_t prt_read_int(void)
+{
+    int symbol = getc_unlocked(stdin);
+
+    while (symbol == ' ' || symbol == '\n' || symbol == '\t' || symbol == '\r' || symbol == '\v' || symbol == '\f')
+        symbol = getc_unlocked(stdin);
+
+    if (symbol == EOF)
+        prt_input_error("unexpected end of input");
+
+    int negative = (symbol == '-');
+    if (symbol == '-' || symbol == '+')
+        symbol = getc_unlocked(stdin);
+
+    if (symbol < '0' || '9' < symbol)
+        prt_input_error("expected integer");
+
+    /* accumulated as negative: |INT32_MIN| doesn`t fit in int32_t */
+    long long value = 0;
+    for (; '0' <= symbol && symbol <= '9'; symbol = getc_unlocked(stdin))
+    {
+        value = value * 10 - (symbol - '0');
+
+        if (value < INT32_MIN)
+            prt_input_error("integer is out of range");
+    }
+
+    if (symbol != EOF) ungetc(symbol, stdin);
+
+    if (!negative && -value > INT32_MAX)
+        prt_input_error("integer is out of range");
+
+    return (int32_t) (negative ? value : -value);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+/* messages are the same as interpreter gives (see its nametable) */
+int32_t* prt_array_new(char const * name, size_t name_size, int32_t size)
+{
+    if (size < 0)
+    {
+        prt_flush();
+        fflush(stdout);
+
+        fprintf(stderr, "paracl: negative size of array '%.*s': %" PRId32 "\n", (int) name_size, name, size);
+        exit(EXIT_FAILURE);
+    }
+
+    /* malloc(0) may return NULL: empty array is still an array */
+    int32_t* elements = malloc(size ? (size_t) size * sizeof(int32_t) : 1);
+
+    if (!elements)
+    {
+        prt_flush();
+        fflush(stdout);
+
+        fprintf(stderr, "paracl: not enough memory for array '%.*s' of %" PRId32 " elements\n", (int) name_size, name, size);
+        exit(EXIT_FAILURE);
+    }
+
+    return elements;
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+void prt_array_delete(int32_t* elements)
+{
+    free(elements);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+void prt_out_of_range(char const * name, size_t name_size, int32_t index, int32_t size)
+{
+    prt_flush();
+    fflush(stdout);
+
+    fprintf(stderr, "paracl: array index %" PRId32 " is out of range of '%.*s' (size %" PRId32 ")\n",
+            index, (int) name_size, name, size);
+    exit(EXIT_FAILURE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+/* counters of paraclc --instrument build */
+static uint64_t*    prt_profile_counters;
+static uint32_t     prt_profile_count;
+static uint64_t     prt_profile_checksum;
+static char const * prt_profile_file;
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+/* counters of previous runs: only if the file is written by the same program */
+static void prt_profile_merge(char const * file)
+{
+    FILE* in = fopen(file, "r");
+    if (!in) return;
+
+    int version = 0;
+    uint64_t checksum = 0;
+    uint32_t count = 0;
+
+    if (fscanf(in, " paracl-profile %d checksum %" SCNu64 " counters %" SCNu32, &version, &checksum, &count) != 3 ||
+        version != 1 || checksum != prt_profile_checksum || count != prt_profile_count)
+    {
+        fclose(in);
+        return;
+    }
+
+    for (uint32_t it = 0; it != count; ++it)
+    {
+        uint64_t value = 0;
+        if (fscanf(in, " %" SCNu64, &value) != 1) break;
+        prt_profile_counters[it] += value;
+    }
+
+    fclose(in);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+static void prt_profile_write(void)
+{
+    char const * file = getenv("PARACL_PROFILE_FILE");
+    if (!file || !*file) file = prt_profile_file;
+
+    prt_profile_merge(file);
+
+    FILE* out = fopen(file, "w");
+    if (!out)
+    {
+        fprintf(stderr, "paracl: profile: failed to write '%s'\n", file);
+        return;
+    }
+
+    fprintf(out, "paracl-profile 1\nchecksum %" PRIu64 "\ncounters %" PRIu32 "\n", prt_profile_checksum, prt_profile_count);
+
+    for (uint32_t it = 0; it != prt_profile_count; ++it)
+        fprintf(out, "%" PRIu64 "\n", prt_profile_counters[it]);
+
+    fclose(out);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
+
+void prt_profile_init(uint64_t* counters, uint32_t count, uint64_t checksum, char const * file)
+{
+    prt_profile_counters = counters;
+    prt_profile_count    = count;
+    prt_profile_checksum = checksum;
+    prt_profile_file     = file;
+
+    /* program may end by exit on bad input: counters are written anyway */
+    atexit(prt_profile_write);
+}
+
+/*---------------------------------------------------------------------------------------------------------------*/
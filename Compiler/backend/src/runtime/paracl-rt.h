@@ -0,0 +1,51 @@
+#ifndef PARACL_RT_H
+#define PARACL_RT_H
+
+/*
+paracl-rt: input and output of compiled ParaCL programs.
+every print is a few calls of non-variadic functions instead of printf with format string.
+output is buffered by runtime itself and written at exit (or at every new line, if stdout is terminal).
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+void    prt_write_int(int32_t value);
+void    prt_write_str(char const * data, size_t size);
+void    prt_newline(void);
+
+/* skips spaces and reads decimal integer. on bad input program is terminated with message */
+int32_t prt_read_int(void);
+
+/* buffer of runtime -> stdio. used by hosts, which run compiled code in their process (paracl --jit, --tiered) */
+void    prt_flush(void);
+
+/* 1 - every print is written at once. default is 1, if stdout is terminal */
+void    prt_set_line_buffered(int line_buffered);
+
+/*
+programs, compiled with paraclc --instrument, register their counters at start.
+at exit counters are added to the profile file ($PARACL_PROFILE_FILE, if set, else 'file'),
+if it`s written by the same program, and the file is rewritten.
+*/
+void    prt_profile_init(uint64_t* counters, uint32_t count, uint64_t checksum, char const * file);
+
+/*
+elements of array, which size isn`t a small literal (small ones are on stack of compiled function).
+name is only for error message: on negative size program is terminated.
+*/
+int32_t* prt_array_new(char const * name, size_t name_size, int32_t size);
+void     prt_array_delete(int32_t* elements);
+
+/* failed bounds check: program is terminated with message */
+void     prt_out_of_range(char const * name, size_t name_size, int32_t index, int32_t size) __attribute__((noreturn, cold));
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* PARACL_RT_H */
@@ -12,34 +12,267 @@
 #include <stdexcept>
 #include <filesystem>
 #include <string>
+#include <fstream>
+#include <iterator>
+#include <cstdint>
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <vector>
 
-int main(int argc, char* argv[]) try
-{
-    if (argc <= 1 or argc == 3 or argc >= 5)
-        throw std::invalid_argument("Usage:\n" + std::string(argv[0]) + " <source>.cl [-o executable]");
+#include <llvm/ADT/Statistic.h>
+#include <llvm/Support/CommandLine.h>
+
+import general;
+import compiler;
+import options;
+import compile_cache;
+import thelast;
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+the rest of options (-o, -O, -mcpu, -v, --instrument, --profile-use) are registered by options module.
+--stats is an option of llvm itself (statistics of passes, if llvm is built with them): paraclc prints its own counters too.
+*/
+llvm::cl::opt<bool> ViaFiles(
+    "via-files",
+    llvm::cl::desc("Debug mode: run frontend and compiler as separate processes, ast is passed through file"),
+    llvm::cl::init(false)
+);
+
+llvm::cl::opt<unsigned> Jobs(
+    "j",
+    llvm::cl::desc("Number of sources, compiled in parallel: -j1 (default), -j0 - number of cpus"),
+    llvm::cl::value_desc("jobs"),
+    llvm::cl::Prefix,
+    llvm::cl::init(1)
+);
+
+llvm::cl::opt<bool> NoCache(
+    "no-cache",
+    llvm::cl::desc("Always compile: don`t take executable from compile cache and don`t store it there"),
+    llvm::cl::init(false)
+);
+
+llvm::cl::opt<std::string> CacheDir(
+    "cache-dir",
+    llvm::cl::desc("Compile cache directory (default: $PARACL_CACHE_DIR, $XDG_CACHE_HOME/paracl or ~/.cache/paracl)"),
+    llvm::cl::value_desc("directory")
+);
 
-    auto&& executable = (argc == 4) ? std::filesystem::path{argv[3]} : std::filesystem::path{"a.out"};
-    std::filesystem::path tmp_ast_json = executable;
-    tmp_ast_json.replace_extension(".ast.json");
+llvm::cl::opt<unsigned> CacheSizeLimit(
+    "cache-size-limit",
+    llvm::cl::desc("Size limit of compile cache in megabytes, least recently used executables are evicted (default: 512)"),
+    llvm::cl::value_desc("megabytes"),
+    llvm::cl::init(512)
+);
+
+llvm::cl::opt<bool> TimeReport(
+    "time-report",
+    llvm::cl::desc("Print time of every phase (parse, ir generation, llvm optimization, linking, ...) to stderr"),
+    llvm::cl::init(false)
+);
+
+llvm::cl::opt<std::string> TimeTrace(
+    "time-trace",
+    llvm::cl::desc("Write phases to <file> in chrome trace event format: with --via-files all processes share one timeline"),
+    llvm::cl::value_desc("file"),
+    llvm::cl::init("")
+);
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* ast optimizer has levels up to -O2: -O3 of paraclc differs from -O2 only in llvm passes */
+unsigned ast_optimization_level(unsigned optimization_level)
+{ return std::min(optimization_level, 2u); }
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* debug mode: frontend and compiler are separate processes, ast is passed through <executable>.ast.bin */
+void compile_via_files(std::filesystem::path const & source, std::filesystem::path const & executable,
+                       compiler::options::Options const & options)
+{
+    std::filesystem::path tmp_ast = executable;
+    tmp_ast.replace_extension(".ast.bin");
 
-    auto&& source = std::filesystem::path{argv[1]};
     auto&& frontend_command = std::ostringstream{};
 
-    frontend_command << PARACL_FRONT " " << source.string() << " -o " << tmp_ast_json.string();
+    frontend_command << PARACL_FRONT " " << source.string() << " --emit=bin -O" << ast_optimization_level(options.optimizationLevel)
+                     << " -o " << tmp_ast.string();
 
     auto&& frontend_exit_code = std::system(frontend_command.str().c_str());
     if (frontend_exit_code != EXIT_SUCCESS)
         throw std::runtime_error("Fronted failed with exit code " + std::to_string(frontend_exit_code));
 
     auto&& compiler_command = std::ostringstream{};
-    compiler_command << PARACL_COMPILER " " << tmp_ast_json.string() << " -o " << executable.string();
+    compiler_command << PARACL_COMPILER " " << tmp_ast.string() << " -o " << executable.string()
+                     << " -O" << options.optimizationLevel << " -mcpu=" << options.targetCpu << (options.verbose ? " -v" : "")
+                     << (options.instrument ? " --instrument" : "");
+
+    if (not options.profileUse.empty())
+        compiler_command << " --profile-use=" << options.profileUse.string();
 
     auto&& compiler_exit_code = std::system(compiler_command.str().c_str());
     if (compiler_exit_code != EXIT_SUCCESS)
         throw std::runtime_error("Compilation failed with exit code " + std::to_string(compiler_exit_code));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::string read_source(std::filesystem::path const & source)
+{
+    auto&& file = std::ifstream{source, std::ios::binary};
+    if (not file.is_open())
+        throw std::runtime_error("Failed to open '" + source.string() + "'");
+
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+compiler::CompileOptions compile_options(compiler::options::Options const & options, std::filesystem::path const & executable)
+{
+    return compiler::CompileOptions{
+        .optimization_level = options.optimizationLevel,
+        .target_cpu         = options.targetCpu,
+        .verbose            = options.verbose,
+        .instrument_file    = options.instrument ? std::filesystem::path{executable.string() + ".profile"}
+                                                 : std::filesystem::path{},
+        .profile_file       = options.profileUse
+    };
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+one source -> executable: from compile cache (cache may be nullptr) or by frontend and codegen of this thread,
+which is created at the first compilation. sources of batch are built in parallel: they share only toolchain and cache directory.
+*/
+void build(std::filesystem::path const & source, std::filesystem::path const & executable, compiler::options::Options const & options,
+           compiler::cache::Cache const * cache, compiler::Toolchain const & toolchain, std::optional<compiler::Codegen>& codegen)
+{
+    auto&& build_options = compile_options(options, executable);
+    auto&& key = std::string{};
+
+    if (cache)
+    {
+        /* unchanged program with the same options is not compiled again: executable is taken from cache */
+        key = compiler::cache::Cache::key(read_source(source), compiler::codegen_signature(build_options));
+
+        if (cache->fetch(key, executable))
+        {
+            if (options.verbose) std::clog << ("paraclc: cache hit " + key + " (" + source.string() + ")\n");
+            return;
+        }
+    }
+
+    if (ViaFiles)
+        compile_via_files(source, executable, options);
+    else
+    {
+        auto&& image = ParaCL::general::generateASTImage(source.string(), ast_optimization_level(options.optimizationLevel));
+
+        if (not codegen) codegen.emplace(toolchain);
+        codegen->compile(image, source, executable, build_options);
+    }
+
+    if (cache and not cache->store(key, executable))
+        std::cerr << ("paraclc: warning: failed to store executable in compile cache " + cache->directory().string() + "\n");
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+-j N: N threads take sources one by one, each of them parses, translates and generates code of its source.
+so the stages of different sources go at the same time. error of one source doesn`t stop the others,
+errors are reported in order of sources, after all of them are done. returns number of failed sources.
+*/
+size_t build_batch(compiler::options::Options const & options, compiler::cache::Cache const * cache,
+                   compiler::Toolchain const & toolchain, unsigned jobs)
+{
+    auto&& count  = options.inputFiles.size();
+    auto&& errors = std::vector<std::string>(count);
+    auto&& next   = std::atomic<size_t>{0};
+
+    auto&& worker = [&]
+    {
+        auto&& codegen = std::optional<compiler::Codegen>{};
+
+        for (auto&& it = next++; it < count; it = next++)
+        {
+            try
+            {
+                build(options.inputFiles[it], options.outputFiles[it], options, cache, toolchain, codegen);
+            }
+            catch (std::exception const & e)
+            {
+                errors[it] = e.what();
+            }
+            catch (...)
+            {
+                errors[it] = "Undefined exception.";
+            }
+        }
+    };
+
+    {
+        auto&& workers = std::vector<std::jthread>{};
+        for (auto&& it = 1u; it < std::min<size_t>(jobs, count); ++it) workers.emplace_back(worker);
+        worker();
+    }
+
+    auto&& failed = size_t{0};
+
+    for (auto&& it = size_t{0}; it != count; ++it)
+    {
+        if (errors[it].empty()) continue;
+
+        ++failed;
+        std::cerr << "paraclc: " << options.inputFiles[it].string() << ": " << errors[it] << "\n";
+    }
+
+    if (failed != 0)
+        std::cerr << "paraclc: " << failed << " of " << count << " sources failed\n";
+
+    return failed;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[]) try
+{
+    /* <source>.cl... [-o executable|directory] [-O0..3] [-mcpu=<cpu>|-march=native] [-v] [-j<jobs>] [--via-files] [--no-cache]
+                      [--instrument|--profile-use=<file>] [--time-report] [--stats] [--time-trace=<file>] */
+    auto&& options = compiler::options::handleCompileOpts(argc, argv);
+
+    /* before threads of -j. with --via-files frontend and compiler processes inherit these options */
+    last::stats::start("paraclc", {.time_report = TimeReport, .stats = llvm::AreStatisticsEnabled(), .time_trace = TimeTrace.getValue()});
+
+    auto&& cache = std::optional<compiler::cache::Cache>{};
+    if (not NoCache)
+        cache.emplace(
+            CacheDir.empty() ? compiler::cache::Cache::default_directory() : std::filesystem::path{CacheDir.getValue()},
+            std::uintmax_t{CacheSizeLimit.getValue()} * 1024 * 1024
+        );
+
+    auto&& cache_ptr = cache ? &*cache : nullptr;
+
+    /* llvm is initialized once for all sources */
+    auto&& toolchain = compiler::Toolchain{compile_options(options, {})};
+
+    if (options.inputFiles.size() == 1)
+    {
+        auto&& codegen = std::optional<compiler::Codegen>{};
+        build(options.inputFiles.front(), options.outputFiles.front(), options, cache_ptr, toolchain, codegen);
+        return EXIT_SUCCESS;
+    }
+
+    auto&& jobs = (Jobs == 0) ? std::max(std::thread::hardware_concurrency(), 1u) : Jobs.getValue();
 
-    return EXIT_SUCCESS;
+    return (build_batch(options, cache_ptr, toolchain, jobs) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 catch (std::exception const & e)
 {
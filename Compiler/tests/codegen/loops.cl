@@ -0,0 +1,18 @@
+// fill and reduction loops of e2e test 0049.
+// size is read, so llvm can`t calculate the loops at compile time: they must stay loops.
+n = ?;
+a = repeat(0, n);
+
+i = 0;
+while (i < n) {
+    a[i] = i * i;
+    i += 1;
+}
+
+sum = 0;
+i = 0;
+while (i < n) {
+    sum += a[i];
+    i += 1;
+}
+print "sum = ", sum;
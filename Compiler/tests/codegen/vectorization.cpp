@@ -0,0 +1,89 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "expect.hpp"
+
+import general;
+import compiler;
+import llvm_ir_translator;
+import optimizer;
+
+/*
+ir of loops over arrays after -O3 of paraclc: the loops are vectorized, and bounds checks are removed from them
+(loop condition 'i < n' implies 'i < size of array'). usage: codegen-vectorization <loops>.cl
+*/
+
+namespace
+{
+
+using ::last::test::expect;
+using ::last::test::failures;
+
+/* the same as paraclc does in process: ast -O2, llvm -O3 for generic cpu */
+std::string optimized_ir(std::filesystem::path const & source)
+{
+    auto&& options = compiler::CompileOptions{};
+    auto&& context = llvm::LLVMContext{};
+    auto&& module  = compiler::llvm_ir_translator::translate(ParaCL::general::generateASTImage(source.string(), 2),
+                                                             source.string(), context);
+
+    auto&& target_machine = compiler::Toolchain{options}.create_target_machine();
+    module->setDataLayout(target_machine->createDataLayout());
+    module->setTargetTriple(target_machine->getTargetTriple().str());
+
+    compiler::optimizer::optimize(*module, options.optimization_level, target_machine.get());
+
+    auto&& ir  = std::string{};
+    auto&& out = llvm::raw_string_ostream{ir};
+    module->print(out, nullptr);
+    out.flush();
+
+    return ir;
+}
+
+/* blocks 'vector.body', 'vector.body12', ...: one per vectorized loop */
+size_t vectorized_loops(std::string const & ir)
+{
+    auto&& count = size_t{0};
+    auto&& in    = std::istringstream{ir};
+
+    for (auto&& line = std::string{}; std::getline(in, line);)
+        if (line.starts_with("vector.body")) ++count;
+
+    return count;
+}
+
+} /* namespace */
+
+//--------------------------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    if (argc != 2)
+        throw std::invalid_argument("Usage: " + std::string(argv[0]) + " <loops>.cl");
+
+    auto&& ir = optimized_ir(argv[1]);
+
+    expect(vectorized_loops(ir) >= 2, "fill and reduction loops are vectorized");
+    expect(ir.find("<4 x i32>") != std::string::npos, "elements are processed by 4");
+    expect(ir.find("call void @prt_out_of_range") == std::string::npos, "bounds checks are removed from loops");
+
+    if (failures != 0) std::cout << "\n" << ir;
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (std::exception const & e)
+{
+    std::cerr << "exception: " << e.what() << "\n";
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,27 @@
+x = 0;
+count = 0;
+
+y = 0 and (x = 1);
+print x, " ", y;
+
+y = 3 or (x = 2);
+print x, " ", y;
+
+y = 3 and (x = 4);
+print x, " ", y;
+
+y = 0 || (x = 0);
+print x, " ", y;
+
+i = 0;
+while (i < 10 and (i < 100 or (count += 1)))
+{
+    i += 1;
+    z = (i == 3) || (count += 1);
+}
+print i, " ", count;
+
+if (not (i > 5 && (count = 0)))
+    print count;
+else
+    print 1;
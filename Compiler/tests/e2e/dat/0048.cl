@@ -0,0 +1,13 @@
+x = 0;
+if ((x = x + 1) == 1) print x; else print 0;
+print x;
+
+n = 0;
+i = 0;
+while (i < 5)
+{
+    if ((n = n + 1) == 2) print 20;
+    else if ((n = n + 10) > 30) print 30;
+    i += 1;
+}
+print n;
@@ -0,0 +1,35 @@
+n = 10;
+a = repeat(0, n);
+
+i = 0;
+while (i < n) {
+    a[i] = i * i;
+    i += 1;
+}
+
+sum = 0;
+i = 0;
+while (i < n) {
+    sum += a[i];
+    i += 1;
+}
+print "sum = ", sum;
+
+b = repeat(7, 3);
+b[1] += 5;
+b[2] *= a[3];
+b[0] -= b[1] - 1;
+print b[0], " ", b[1], " ", b[2];
+
+{
+    c = repeat(1, 2);
+    c[1] = c[0] + b[2];
+    print c[1];
+}
+
+big = repeat(2, 5000);
+big[4999] /= 2;
+print big[0] + big[4999];
+
+b = repeat(-1, 1);
+print b[0];
@@ -0,0 +1,29 @@
+// invariant of loop is calculated before it only if its variables are assigned there:
+// q is declared by 'm and (q = 1)', but m is 0, so q is never assigned and the loop runs zero times
+
+j = 0;
+while (j < 3)
+{
+    j += 1;
+}
+
+m = j - 3;
+m and (q = 1);
+
+i = 0;
+while (i < m)
+{
+    i = i + q * 2;
+}
+print i;
+
+// k is assigned before the loop: k * 2 is still calculated once
+k = j * 5;
+s = 0;
+i = 0;
+while (i < j)
+{
+    s = s + k * 2;
+    i += 1;
+}
+print s;
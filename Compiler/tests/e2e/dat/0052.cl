@@ -0,0 +1,12 @@
+a = repeat(0, 4);
+i = 0;
+while (i < 4)
+{
+    a[i] = i;
+    i += 1;
+}
+print a[3];
+
+// write before the first element: negative index
+a[i - 5] = 1;
+print 7;
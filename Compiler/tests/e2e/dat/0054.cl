@@ -0,0 +1,14 @@
+// size of array is read (see 0054.in)
+n = ?;
+a = repeat(3, n);
+
+i = 0;
+s = 0;
+while (i < n)
+{
+    a[i] = a[i] * i;
+    s += a[i];
+    i += 1;
+}
+print s;
+print a[n - 1];
@@ -55,40 +55,47 @@ def main():
         color_print(Colors.RED, f"Error reading answer file: {e}")
         return 1
 
-    expect_compilation_death = False
-    expected_compile_exit_code = 0
+    # input of program (for '?'), if there is <test>.in near <test>.cl
+    stdin_file = os.path.splitext(test_input)[0] + ".in"
+    program_input = None
+
+    if os.path.exists(stdin_file):
+        with open(stdin_file, 'r') as f:
+            program_input = f.read()
+
+    # DEATH_WITH: <exit code> of compiler (bad program) or of program (runtime error),
+    # next lines (if any) - message, expected in stderr
+    expect_death = False
+    expected_exit_code = 0
+    death_message = ""
 
     if answer_content.startswith("DEATH_WITH:"):
-        expect_compilation_death = True
-        parts = answer_content.split(':', 2)
-        if len(parts) < 2:
-            color_print(Colors.RED, "Error: Bad format in .ans file. Expected 'DEATH_WITH:exit_code'")
-            return 1
+        expect_death = True
+        exit_code_line, _, death_message = answer_content.partition('\n')
+        death_message = death_message.strip()
         try:
-            expected_compile_exit_code = int(parts[1].strip())
+            expected_exit_code = int(exit_code_line.partition(':')[2].strip())
         except ValueError:
-            color_print(Colors.RED, f"Error: Invalid exit code in .ans file: {parts[1]}")
+            color_print(Colors.RED, f"Error: Invalid exit code in .ans file: {exit_code_line}")
             return 1
-    else:
-        expect_compilation_death = False
-        expected_compile_exit_code = 0
 
     executable = test_input + ".out"
     compile_result = subprocess.run(
-        [paracl_executable, test_input, " -o " , executable],
-        # [f"{paracl_executable} {test_input} -o {executable}"],
+        # tests always check the compiler itself, not executables from compile cache
+        [paracl_executable, test_input, "-o", executable, "--no-cache"],
         capture_output=True,
         text=True
     )
     
-    if expect_compilation_death:
-        if compile_result.returncode == expected_compile_exit_code:
+    if expect_death and compile_result.returncode != 0:
+        if compile_result.returncode == expected_exit_code and death_message in compile_result.stderr:
             color_print(Colors.GREEN, "TEST PASSED - Expected compilation death occurred")
             return 0
         else:
-            color_print(Colors.RED, "TEST FAILED - Expected compilation death but compilation succeeded")
-            color_print(Colors.GREEN, f"[ expected exit code ]: {expected_compile_exit_code}")
+            color_print(Colors.RED, "TEST FAILED - Compilation died, but not as expected")
+            color_print(Colors.GREEN, f"[ expected exit code ]: {expected_exit_code}")
             color_print(Colors.RED,   f"[ compiler exit code ]: {compile_result.returncode}")
+            color_print(Colors.GREEN, f"[ expected message   ]: {death_message}")
             if compile_result.stdout:
                 print(f"Compiler stdout: {compile_result.stdout}")
             if compile_result.stderr:
@@ -107,6 +114,7 @@ def main():
 
     result = subprocess.run(
         [executable],
+        input=program_input,
         capture_output=True,
         text=True
     )
@@ -114,6 +122,19 @@ def main():
     if os.path.exists(executable):
         os.remove(executable)
 
+    if expect_death:
+        if result.returncode == expected_exit_code and death_message in result.stderr:
+            color_print(Colors.GREEN, "TEST PASSED - Expected death of program occurred")
+            return 0
+        else:
+            color_print(Colors.RED, "TEST FAILED - Expected death of compiler or program")
+            color_print(Colors.GREEN, f"[ expected exit code ]: {expected_exit_code}")
+            color_print(Colors.RED,   f"[ program  exit code ]: {result.returncode}")
+            color_print(Colors.GREEN, f"[ expected message   ]: {death_message}")
+            print(f"Program stdout: {result.stdout}")
+            print(f"Program stderr: {result.stderr}")
+            return 1
+
     program_stdout = result.stdout
     program_stderr = result.stderr
 
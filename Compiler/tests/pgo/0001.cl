@@ -0,0 +1,10 @@
+n = 100;
+i = 0;
+odd = 0;
+while (i < n)
+{
+    if (i % 2)
+        odd += 1;
+    i += 1;
+}
+print odd;
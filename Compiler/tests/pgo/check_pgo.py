@@ -0,0 +1,150 @@
+#!/usr/bin/python3
+
+# paraclc --instrument and --profile-use:
+#   instrumented program writes its counters to <executable>.profile at exit, the next runs add theirs to them;
+#   --profile-use build takes this profile, but profile of other program (other checksum) is not used.
+
+import os
+import sys
+import subprocess
+import tempfile
+
+class Colors:
+    RED       = '\033[91m'
+    GREEN     = '\033[92m'
+    WHITE     = '\033[97m'
+    RESET     = '\033[0m'
+
+def color_print(color, arg, **kwargs):
+    print(f"{color}{arg}{Colors.RESET}", **kwargs)
+
+def extract_numbers(text):
+    numbers = []
+    for token in text.split():
+        try:
+            numbers.append(int(token))
+        except ValueError:
+            continue
+    return numbers
+
+def read_counters(counters_file):
+    with open(counters_file, 'r') as f:
+        return extract_numbers(''.join(line.split('#')[0] for line in f))
+
+# paracl-profile 1 / checksum <checksum> / counters <count> / <counter>...
+def read_profile(profile_file):
+    with open(profile_file, 'r') as f:
+        tokens = f.read().split()
+
+    if tokens[:3] != ["paracl-profile", "1", "checksum"] or tokens[4] != "counters":
+        raise ValueError(f"bad header of profile: {tokens[:6]}")
+
+    counters = [int(token) for token in tokens[6:]]
+    if len(counters) != int(tokens[5]):
+        raise ValueError(f"expected {tokens[5]} counters, got {len(counters)}")
+
+    return int(tokens[3]), counters
+
+def write_profile(profile_file, checksum, counters):
+    with open(profile_file, 'w') as f:
+        f.write(f"paracl-profile 1\nchecksum {checksum}\ncounters {len(counters)}\n")
+        f.writelines(f"{counter}\n" for counter in counters)
+
+class Checks:
+    def __init__(self):
+        self.errors = 0
+
+    def expect(self, condition, what, details = ""):
+        if condition:
+            color_print(Colors.GREEN, f"ok     {what}")
+            return
+
+        color_print(Colors.RED, f"FAILED {what}")
+        if details:
+            print(details)
+        self.errors += 1
+
+def main():
+    if len(sys.argv) != 5:
+        print(f"Usage: {sys.argv[0]} <paraclc> <test>.cl <answer>.ans <expected>.counters")
+        return 1
+
+    paraclc, test_input, test_answer, counters_file = sys.argv[1:5]
+
+    with open(test_answer, 'r') as f:
+        expected_output = extract_numbers(f.read())
+    expected_counters = read_counters(counters_file)
+
+    checks = Checks()
+
+    with tempfile.TemporaryDirectory() as work_dir:
+        executable = os.path.join(work_dir, "program")
+        profile    = executable + ".profile"
+
+        def compile(*options):
+            # tests always check the compiler itself, not executables from compile cache
+            return subprocess.run([paraclc, test_input, "-o", executable, "--no-cache", *options],
+                                  capture_output=True, text=True)
+
+        def run():
+            result = subprocess.run([executable], capture_output=True, text=True)
+            checks.expect(result.returncode == 0 and extract_numbers(result.stdout) == expected_output,
+                          "program gives expected output", f"exit code {result.returncode}, stdout: {result.stdout}")
+
+        # instrumented build
+        result = compile("--instrument")
+        if result.returncode != 0:
+            color_print(Colors.RED, f"Compilation with --instrument failed with exit code {result.returncode}")
+            print(f"Compiler stderr: {result.stderr}")
+            return 1
+
+        run()
+        checks.expect(os.path.exists(profile), "profile is written at exit")
+        if not os.path.exists(profile):
+            return 1
+
+        checksum, counters = read_profile(profile)
+        checks.expect(counters == expected_counters, "counters of one run", f"counters: {counters}")
+
+        run()
+        _, counters = read_profile(profile)
+        checks.expect(counters == [2 * counter for counter in expected_counters],
+                      "counters of the next run are added", f"counters: {counters}")
+
+        # profile of other program is overwritten, not merged
+        write_profile(profile, checksum + 1, [1000] * len(expected_counters))
+        run()
+        other_checksum, counters = read_profile(profile)
+        checks.expect(other_checksum == checksum and counters == expected_counters,
+                      "profile with other checksum is not merged", f"checksum {other_checksum}, counters: {counters}")
+
+        # build by profile
+        result = compile(f"--profile-use={profile}", "-v")
+        checks.expect(result.returncode == 0, "compilation with --profile-use", f"stderr: {result.stderr}")
+        checks.expect(f"{len(expected_counters)} counters" in result.stderr and "doesn`t match" not in result.stderr,
+                      "profile is loaded and matches the program", f"stderr: {result.stderr}")
+        run()
+
+        # profile with other checksum is rejected: program is compiled without it
+        write_profile(profile, checksum + 1, expected_counters)
+        result = compile(f"--profile-use={profile}")
+        checks.expect(result.returncode == 0 and "profile doesn`t match the program" in result.stderr,
+                      "profile with other checksum is not used", f"stderr: {result.stderr}")
+        run()
+
+        # not a profile at all
+        with open(profile, 'w') as f:
+            f.write("print 1;\n")
+        result = compile(f"--profile-use={profile}")
+        checks.expect(result.returncode != 0 and "Bad profile" in result.stderr,
+                      "file, which is not a profile, is an error", f"exit code {result.returncode}, stderr: {result.stderr}")
+
+    if checks.errors == 0:
+        color_print(Colors.GREEN, "TEST PASSED")
+        return 0
+
+    color_print(Colors.RED, f"\n\nTEST FAILED ({checks.errors} checks)")
+    return 1
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -2,16 +2,31 @@ module;
 
 #include "projInfo.hpp"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/ADT/Statistic.h"
 #include <string>
 #include <iostream>
 #include <utility>
 #include <exception>
+#include <stdexcept>
 #include <sstream>
 #include <filesystem>
 #include <vector>
+#include <thread>
+#include <algorithm>
 
 export module compileOpts;
 
+export namespace ParaCL::general
+{
+
+enum class EmitFormat
+{
+    JSON, /* text format of last::write  */
+    BIN , /* binary format of last::write_binary: no parsing on reading */
+};
+
+} /* namespace ParaCL::general */
+
 
 llvm::cl::list<std::string> InputFiles(
     llvm::cl::Positional,
@@ -47,6 +62,51 @@ llvm::cl::alias AstDumpAlias(
     llvm::cl::aliasopt(AstDumpFile)
 );
 
+llvm::cl::opt<ParaCL::general::EmitFormat> Emit(
+    "emit",
+    llvm::cl::desc("Format of output AST"),
+    llvm::cl::values(
+        clEnumValN(ParaCL::general::EmitFormat::JSON, "json", "Text json format (default)"),
+        clEnumValN(ParaCL::general::EmitFormat::BIN , "bin" , "Binary format, which backends read without parsing")
+    ),
+    llvm::cl::init(ParaCL::general::EmitFormat::JSON)
+);
+
+llvm::cl::opt<char> OptimizationLevel(
+    "O",
+    llvm::cl::desc("Optimization level of AST: -O0 (default), -O1 or -O2"),
+    llvm::cl::value_desc("level"),
+    llvm::cl::Prefix,
+    llvm::cl::init('0')
+);
+
+llvm::cl::opt<unsigned> Jobs(
+    "j",
+    llvm::cl::desc("Number of input files, parsed in parallel: -j1 (default), -j0 - number of cpus"),
+    llvm::cl::value_desc("jobs"),
+    llvm::cl::Prefix,
+    llvm::cl::init(1)
+);
+
+llvm::cl::alias JobsAlias(
+    "jobs",
+    llvm::cl::desc("Alias for -j"),
+    llvm::cl::aliasopt(Jobs)
+);
+
+llvm::cl::opt<bool> TimeReport(
+    "time-report",
+    llvm::cl::desc("Print time of every phase (parse, ast optimization, ast serialization) to stderr"),
+    llvm::cl::init(false)
+);
+
+llvm::cl::opt<std::string> TimeTrace(
+    "time-trace",
+    llvm::cl::desc("Write phases to <file> in chrome trace event format (chrome://tracing, ui.perfetto.dev)"),
+    llvm::cl::value_desc("file"),
+    llvm::cl::init("")
+);
+
 llvm::cl::opt<bool> ShowVersion(
     "v",
     llvm::cl::desc("Show version information"),
@@ -86,6 +146,13 @@ struct CommandLineData
 {
     std::vector<std::filesystem::path> inputFiles;
     std::vector<std::filesystem::path> outputFiles;
+    EmitFormat emitFormat;
+    unsigned optimizationLevel;
+    unsigned jobs; /* threads of parsing, at most one per input */
+
+    bool        timeReport;
+    bool        stats;
+    std::string timeTrace; /* empty - no trace */
 };
 
 CommandLineData handleCompileOpts(int argc, char** argv)
@@ -111,14 +178,32 @@ CommandLineData handleCompileOpts(int argc, char** argv)
         throw std::runtime_error(noInputFilesErrorMsg);
     }
 
+    const char optLevel = OptimizationLevel.getValue();
+    if ((optLevel < '0') || ('2' < optLevel))
+    {
+        throw std::invalid_argument(std::string("Optimization level '-O") + optLevel + "' is not supported.");
+    }
+
     CommandLineData data;
     for (const auto& f : InputFiles) data.inputFiles.emplace_back(f);
 
+    data.optimizationLevel = static_cast<unsigned>(optLevel - '0');
+
+    data.jobs = (Jobs == 0) ? std::max(std::thread::hardware_concurrency(), 1u) : Jobs.getValue();
+    data.jobs = static_cast<unsigned>(std::min<size_t>(data.jobs, data.inputFiles.size()));
+
+    data.timeReport = TimeReport;
+    data.stats      = llvm::AreStatisticsEnabled(); /* --stats is registered by llvm itself */
+    data.timeTrace  = TimeTrace.getValue();
+
+    data.emitFormat = Emit.getValue();
+    const std::string outputExtension = (data.emitFormat == EmitFormat::BIN) ? ".ast.bin" : ".ast.json";
+
     if (OutputPaths.empty()) 
     {
         data.outputFiles.push_back(InputFiles[0]);
         for (size_t i = 1; i < data.inputFiles.size(); ++i) {
-            data.outputFiles.push_back(data.inputFiles[i].stem().string() + ".ast.json");
+            data.outputFiles.push_back(data.inputFiles[i].stem().string() + outputExtension);
         }
     }
     else if (OutputPaths.size() == 1 && std::filesystem::is_directory(OutputPaths[0]))
@@ -126,7 +211,7 @@ CommandLineData handleCompileOpts(int argc, char** argv)
         std::filesystem::path outDir = OutputPaths[0];
         for (const auto& in : data.inputFiles)
         {
-            data.outputFiles.push_back(outDir / in.filename().replace_extension(".ast.json"));
+            data.outputFiles.push_back(outDir / in.filename().replace_extension(outputExtension));
         }
     }
     else 
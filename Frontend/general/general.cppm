@@ -3,41 +3,71 @@ module;
 import thelast;
 
 #include "parser.tab.hpp"
+#include "lexer.hpp"
 
 #include <boost/json.hpp>
-#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
 #include <string_view>
+#include <utility>
 // #include "spdlog/sinks/stdout_color_sinks.h"
 // #include "spdlog/spdlog.h"
 
-extern void set_current_paracl_file(std::string_view);
-extern FILE* yyin;
-extern last::AST program;
-
 export module general;
 
 export namespace ParaCL::general
 {
 
-last::AST generateAST(std::string_view inputFileName)
+/* nodes of optimized tree get the same signatures as nodes of parser */
+struct NodeFactory
 {
+    template <typename NodeT>
+    static last::node::BasicNode create(NodeT node)
+    { return ParaCL::general::create(std::move(node)); }
+};
+
+/*
+optimization_level: passes of last::optimizer (0 - tree as it is written).
+parser has no global state: different files may be parsed in different threads at the same time.
+*/
+last::AST generateAST(std::string_view inputFileName, unsigned optimization_level = 0)
+{
+    /* text of file is mapped: tokens are views into it, only distinct names and strings are copied (to symbol table) */
+    auto&& source  = ParaCL::Source{std::filesystem::path{inputFileName}};
+    auto&& context = ParaCL::ParseContext{.file = std::string(inputFileName)};
+    auto&& scanner = ParaCL::Scanner{source, context};
+
+    last::stats::count(last::stats::Counter::BYTES_READ, source.text().size());
+
+    yy::parser paracl_parser{scanner.get(), context};
+
+    /* all nodes of the program are placed in one arena, which is owned by the returned AST (arena of thread is used) */
+    auto&& arena = std::make_unique<last::node::Arena>();
+    auto&& result = [&]
+    {
+        /* lexer is called by parser, and nodes are built by its actions: one phase */
+        auto&& timer = last::stats::Timer{"parse"};
+        auto&& use_arena   = last::node::Arena::Use{*arena};
+        auto&& use_symbols = last::node::Symbols::Use{context.symbols.get()};
+        return paracl_parser.parse();
+    }();
+
+    /* messages go with exception: caller prints them at once, after messages of previous files */
+    if (result != 0 or not context.diagnostics.empty())
+        throw std::runtime_error(context.diagnostics + "Parsing errors occured in '" + std::string(inputFileName) + "'.");
+
+    auto&& timer = last::stats::Timer{"ast optimization"};
+    return last::optimizer::optimize<NodeFactory>(last::AST{std::move(context.program), std::move(arena), std::move(context.symbols)}, optimization_level);
+}
 
-    FILE* inputFile = std::fopen(std::string(inputFileName).c_str(), "r");
-    set_current_paracl_file(inputFileName);
-
-    if (!inputFile) throw std::runtime_error("Can't open file: " + std::string(inputFileName));
-
-    yyin = inputFile;
-
-    yy::parser paracl_parser;
-    
-    int result = paracl_parser.parse();
-    
-    if (result != 0) throw std::runtime_error("Parsing errors occured.");
-
-    std::fclose(inputFile);
-
-    return program;
+/*
+ast for backends in the same process.
+nodes of frontend have frontend visit signatures, so backends build their own nodes from the image.
+*/
+last::binary::Image generateASTImage(std::string_view inputFileName, unsigned optimization_level = 0)
+{
+    return last::binary::Image{last::write_binary(generateAST(inputFileName, optimization_level))};
 }
 
 
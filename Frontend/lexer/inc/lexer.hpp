@@ -1,8 +1,27 @@
 #pragma once
 
 #include "parser.tab.hpp"
-#include <string>
+#include "source.hpp"
 
-extern int current_num_value;
-extern std::string current_var_value;
-extern int yylex();
+int yylex(yy::parser::semantic_type* yylval, yy::parser::location_type* yylloc, yyscan_t yyscanner);
+
+namespace ParaCL
+{
+
+/* reentrant flex scanner, which reads text of source in place and reports errors to its context of parse */
+class Scanner final
+{
+  private:
+    yyscan_t scanner_ = nullptr;
+
+  public:
+    Scanner(Source& source, ParseContext& context);
+    ~Scanner();
+
+    Scanner(Scanner const &) = delete;
+    Scanner& operator=(Scanner const &) = delete;
+
+    yyscan_t get() const noexcept { return scanner_; }
+};
+
+} /* namespace ParaCL */
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace ParaCL
+{
+
+/*
+text of source file for the scanner. regular file is mapped (private copy-on-write mapping: flex writes
+terminators of tokens into its buffer), other files are read. text is followed by two zero bytes,
+which flex needs at the end of buffer (yy_scan_buffer). tokens and error messages refer to it by views,
+so it lives until the end of parse.
+*/
+class Source final
+{
+  private:
+    char*  data_   = nullptr;
+    size_t size_   = 0;
+    size_t mapped_ = 0;         /* 0 - text is in fallback_ */
+    std::vector<char> fallback_;
+
+  public:
+    explicit Source(std::filesystem::path const & file);
+
+    Source(Source const &) = delete;
+    Source& operator=(Source const &) = delete;
+
+    ~Source();
+
+  public:
+    std::string_view text() const noexcept
+    { return {data_, size_}; }
+
+    /* text with two zero bytes */
+    char* buffer() noexcept
+    { return data_; }
+
+    size_t buffer_size() const noexcept
+    { return size_ + 2; }
+};
+
+} /* namespace ParaCL */
@@ -0,0 +1,83 @@
+#include "source.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+namespace ParaCL
+{
+
+namespace
+{
+
+/* zero pages of size + 2 bytes with file over them: bytes after the end of file are zero */
+char* map_with_padding(int fd, size_t size)
+{
+    auto* region = ::mmap(nullptr, size + 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) return nullptr;
+
+    auto* text = ::mmap(region, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if (text == MAP_FAILED)
+    {
+        ::munmap(region, size + 2);
+        return nullptr;
+    }
+
+    return static_cast<char*>(text);
+}
+
+} /* anonymous namespace */
+
+Source::Source(std::filesystem::path const & file)
+{
+    auto&& fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Can't open file: " + file.string());
+
+    struct stat info{};
+    if (::fstat(fd, &info) == 0 and S_ISREG(info.st_mode) and info.st_size > 0)
+    {
+        auto&& size = static_cast<size_t>(info.st_size);
+
+        if (auto* data = map_with_padding(fd, size))
+        {
+            LOGINFO("paracl: lexer: {} mapped, {} bytes", file.string(), size);
+
+            data_   = data;
+            size_   = size;
+            mapped_ = size + 2;
+        }
+    }
+
+    ::close(fd);
+
+    if (mapped_ != 0) return;
+
+    /* pipes, empty files, and files, which can`t be mapped */
+    auto&& stream = std::ifstream{file, std::ios::binary};
+    if (not stream.is_open())
+        throw std::runtime_error("Can't open file: " + file.string());
+
+    fallback_.assign(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{});
+
+    size_ = fallback_.size();
+    fallback_.resize(size_ + 2, '\0');
+    data_ = fallback_.data();
+}
+
+Source::~Source()
+{
+    if (mapped_ != 0)
+        ::munmap(data_, mapped_);
+}
+
+} /* namespace ParaCL */
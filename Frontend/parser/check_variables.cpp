@@ -26,13 +26,13 @@ void ParserNameTable::leave_scope()
     scopes_.pop_back();
 }
 
-bool ParserNameTable::is_declare(std::string_view variable) const
+bool ParserNameTable::is_declare(last::node::Symbol variable) const
 {
     LOGINFO("paracl: parser: nametable: check declaration of: \"{}\"", variable);
 
     for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it)
     {
-        if (it->count(std::string(variable)))
+        if (it->contains(variable))
         {
             LOGINFO("paracl: parser: nametable: \"{}\" FOUND → already declared, return true", 
                           variable);
@@ -44,12 +44,23 @@ bool ParserNameTable::is_declare(std::string_view variable) const
     return false;
 }
 
-bool ParserNameTable::is_not_declare(std::string_view variable) const
+bool ParserNameTable::is_not_declare(last::node::Symbol variable) const
 {
     return !is_declare(variable);
 }
 
-void ParserNameTable::declare_or_do_nothing_if_already_declared(std::string_view variable)
+bool ParserNameTable::is_array(last::node::Symbol variable) const
+{
+    for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it)
+    {
+        if (auto&& found = it->find(variable); found != it->end())
+            return found->second;
+    }
+
+    return false;
+}
+
+void ParserNameTable::declare_or_do_nothing_if_already_declared(last::node::Symbol variable)
 {
     LOGINFO("paracl: parser: nametable: try to declare: \"{}\"", variable);
 
@@ -65,9 +76,19 @@ void ParserNameTable::declare_or_do_nothing_if_already_declared(std::string_view
         return;
     }
 
-    scopes_.back().insert(std::string(variable));
+    scopes_.back().emplace(variable, false);
     LOGINFO("Parser nametable msg: DECLARED \"{}\" in scope depth {}", 
                   variable, scopes_.size());
 }
 
+/* the same as for variables: repeat of visible array gives it new elements, it`s not a new array */
+void ParserNameTable::declare_array_or_do_nothing_if_already_declared(last::node::Symbol array)
+{
+    if (is_declare(array) or scopes_.empty()) return;
+
+    scopes_.back().emplace(array, true);
+    LOGINFO("Parser nametable msg: DECLARED array \"{}\" in scope depth {}",
+                  array, scopes_.size());
+}
+
 } // namespace ParaCL
@@ -1,26 +1,31 @@
 #pragma once
 
-#include <string>
-#include <unordered_set>
+#include <unordered_map>
 #include <iostream>
 #include <vector>
 
+import thelast;
+
 namespace ParaCL
 {
 
+/* variables of scopes. names are interned by lexer (last::node::Symbols): lookups don`t allocate and don`t compare strings */
 struct ParserNameTable
 {
   private:
-    std::vector<std::unordered_set<std::string>> scopes_;
+    /* name is an array from its 'repeat' to the end of the scope */
+    std::vector<std::unordered_map<last::node::Symbol, bool /* is array */, last::node::SymbolHash>> scopes_;
 
   public:
     ParserNameTable() = default;
     void new_scope();
     void leave_scope();
-    bool is_not_declare(std::string_view variable) const;
-    bool is_declare(std::string_view variable) const;
+    bool is_not_declare(last::node::Symbol variable) const;
+    bool is_declare(last::node::Symbol variable) const;
+    bool is_array(last::node::Symbol variable) const;
 
-    void declare_or_do_nothing_if_already_declared(std::string_view variable);
+    void declare_or_do_nothing_if_already_declared(last::node::Symbol variable);
+    void declare_array_or_do_nothing_if_already_declared(last::node::Symbol array);
 };
 
 } /* namespace ParaCL*/
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "check_variables.hpp"
+
+import thelast;
+
+namespace ParaCL
+{
+
+/*
+state of one parse: every file gets its own context and its own scanner,
+so several files may be parsed at the same time (paraclf -j).
+*/
+struct ParseContext
+{
+    std::string file;              /* name of file in messages: they show lines of it */
+    last::node::BasicNode program; /* root of parsed program                          */
+    ParserNameTable name_table;    /* declared variables of current scopes            */
+
+    /* error messages of this file in order. they are not printed here: generateAST throws them,
+       so the caller prints them at once (paraclf -j - in order of input files, not of threads) */
+    std::string diagnostics;
+
+    /* names and strings, interned by lexer. generateAST gives it to last::AST with the tree */
+    std::shared_ptr<last::node::Symbols> symbols = std::make_shared<last::node::Symbols>();
+};
+
+} /* namespace ParaCL */
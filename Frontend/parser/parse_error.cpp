@@ -3,19 +3,17 @@
 #include <algorithm>
 #include <cstring>
 #include <exception>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string.h>
 #include <string>
 #include <vector>
 
-
-extern FILE *yyin;
-extern std::string current_file;
-
 void yy::parser::error(const location &loc, const std::string &msg)
 {
-    ErrorHandler::throwError(loc, msg, {false, true, false});
+    ErrorHandler::throwError(parse_context, loc, msg, {false, true, false});
 }
 
 namespace ErrorHandler
@@ -24,91 +22,90 @@ namespace ErrorHandler
 namespace Detail
 {
 
-void show_error_context(const yy::location &loc);
+std::string read_line(const std::string &file, int line);
+void show_error_context(std::ostream &out, const std::string &line, const yy::location &loc);
 size_t levenshtein_distance(std::string_view s1, std::string_view s2);
 std::string find_possible_token(const char *unexpected);
-std::string extract_token_at_position(const yy::location &loc);
+std::string extract_token_at_position(const std::string &line, const yy::location &loc);
 
 } /* namespace Detail */
 
-void throwError(const yy::location &loc, std::string_view msg, const ErrorParseOptions &options)
+void throwError(ParaCL::ParseContext &context, const yy::location &loc, std::string_view msg,
+                const ErrorParseOptions &options)
 {
-    std::cerr << current_file << ":" << loc.begin.line << ":" << loc.begin.column
-              << ": paracl: error:"
-                 " ---> "
-              << msg << "\n";
+    // Message is kept in context: files of paraclf -j are parsed in parallel, caller prints them in order of files
+    std::ostringstream out;
 
-    std::string bad_token = ErrorHandler::Detail::extract_token_at_position(loc);
+    out << context.file << ":" << loc.begin.line << ":" << loc.begin.column
+        << ": paracl: error:"
+           " ---> "
+        << msg << "\n";
+
+    std::string line = ErrorHandler::Detail::read_line(context.file, loc.begin.line);
+    std::string bad_token = ErrorHandler::Detail::extract_token_at_position(line, loc);
 
     if (options.show_bad_token)
     {
-        std::cerr << "Problematic place: '";
-        bad_token.empty() ? std::cerr << "???" : std::cerr << bad_token;
-        std::cerr << "'\n\n";
+        out << "Problematic place: '";
+        bad_token.empty() ? out << "???" : out << bad_token;
+        out << "'\n\n";
     }
 
     if (options.show_error_context)
     {
-        ErrorHandler::Detail::show_error_context(loc);
+        ErrorHandler::Detail::show_error_context(out, line, loc);
     }
 
     if (options.show_posible_token)
     {
         std::string possible_token = ErrorHandler::Detail::find_possible_token(bad_token.c_str());
-        std::cerr << "\nPossible fix: ";
-        possible_token.empty() ? std::cerr << "no suggestions"
-                               : std::cerr << "Did you mean: '" << possible_token << "'?";
-        std::cerr << "\n";
+        out << "\nPossible fix: ";
+        possible_token.empty() ? out << "no suggestions"
+                               : out << "Did you mean: '" << possible_token << "'?";
+        out << "\n";
     }
+
+    context.diagnostics += out.str();
 }
 
 namespace Detail
 {
 
-void show_error_context(const yy::location &loc)
+std::string read_line(const std::string &file, int line)
 {
-    if (!yyin)
-        return;
+    // Text of source is in the buffer of lexer, which writes terminators of tokens into it: line is read from file
+    std::ifstream input(file);
+    std::string text;
 
-    long current_file_pos = ftell(yyin);
+    for (int current_line = 1; std::getline(input, text); ++current_line)
+        if (current_line == line)
+            return text;
 
-    // Go to start of the file
-    rewind(yyin);
+    return "";
+}
 
-    char buffer[1024];
-    int current_line = 1;
+void show_error_context(std::ostream &out, const std::string &line, const yy::location &loc)
+{
+    if (line.empty())
+        return;
 
-    while (current_line < loc.begin.line && fgets(buffer, sizeof(buffer), yyin))
-        current_line++;
+    out << loc.begin.line << " | " << line << "\n";
 
-    if (current_line == loc.begin.line && fgets(buffer, sizeof(buffer), yyin))
+    out << "  | ";
+    int i = 1;
+    for (; i < loc.begin.column; i++)
     {
-        size_t len = strlen(buffer);
-
-        if (len > 0 && buffer[len - 1] == '\n')
-            buffer[len - 1] = '\0';
-
-        std::cerr << loc.begin.line << " | " << buffer << std::endl;
-
-        std::cerr << "  | ";
-        int i = 1;
-        for (; i < loc.begin.column; i++)
-        {
-            if (i < (int)strlen(buffer) && buffer[i - 1] == '\t')
-                std::cerr << "~~~~";
-            else
-                std::cerr << "~";
-        }
-        std::cerr << "^";
-
-        for (; i < (int)strlen(buffer); i++)
-            std::cerr << "~";
-
-        std::cerr << "\n";
+        if (i < (int)line.size() && line[i - 1] == '\t')
+            out << "~~~~";
+        else
+            out << "~";
     }
+    out << "^";
+
+    for (; i < (int)line.size(); i++)
+        out << "~";
 
-    // Restoring the position in the file
-    fseek(yyin, current_file_pos, SEEK_SET);
+    out << "\n";
 }
 
 size_t levenshtein_distance(std::string_view s1, std::string_view s2)
@@ -159,31 +156,8 @@ std::string find_possible_token(const char *unexpected)
     return best_match;
 }
 
-std::string extract_token_at_position(const yy::location &loc)
+std::string extract_token_at_position(const std::string &target_line, const yy::location &loc)
 {
-    if (!yyin)
-        return "";
-
-    long current_file_pos = ftell(yyin);
-
-    rewind(yyin);
-
-    char buffer[1024];
-    int current_line = 1;
-    std::string target_line;
-
-    while (current_line < loc.begin.line && fgets(buffer, sizeof(buffer), yyin))
-    {
-        ++current_line;
-    }
-
-    if (current_line == loc.begin.line && fgets(buffer, sizeof(buffer), yyin))
-    {
-        target_line = buffer;
-    }
-
-    fseek(yyin, current_file_pos, SEEK_SET);
-
     if (target_line.empty())
         return "";
 
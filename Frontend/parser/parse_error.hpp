@@ -16,6 +16,8 @@ struct ErrorParseOptions
     bool show_posible_token : 1 = false;
 };
 
-void throwError(const yy::location &loc, std::string_view msg, const ErrorParseOptions &options = {});
+/* message about file of context (with the line of file, where error is). it`s added to context.diagnostics */
+void throwError(ParaCL::ParseContext &context, const yy::location &loc, std::string_view msg,
+                const ErrorParseOptions &options = {});
 
 } /* namespace ErrorHandler */
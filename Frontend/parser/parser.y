@@ -6,35 +6,62 @@
 %define api.namespace {yy}
 %define api.parser.class {parser}
 
+/* pure parser: all state is in the context of parse and in the scanner of flex (see parse_context.hpp) */
+%parse-param {yyscan_t scanner} {ParaCL::ParseContext& parse_context}
+%lex-param {yyscan_t scanner}
+
 %code requires {
     #include <iostream>
     #include <cstdio>
     #include <vector>
     #include <string>
+    #include <string_view>
+    #include <cstdint>
     
     #include <boost/json.hpp>
     #include <boost/json/object.hpp>
 
     import thelast;
-    #include "create-basic-node.hpp"
-    CREATE_SAME(boost::json::value(), last::node::dumpable)
 
-    extern FILE* yyin;
-    extern std::string current_file;
-    extern int current_num_value;
-    extern std::string current_var_value;
+    namespace ParaCL::general
+    {
+    /*
+    frontend doesn`t specialize last::node::create: backends, which are linked with frontend,
+    specialize it with their own signatures. they get the tree as last::binary::Image.
+    */
+    template <typename NodeT>
+    last::node::BasicNode create(NodeT node)
+    {
+        using Actions = last::node::BasicNode::Actions<boost::json::value(), last::node::dumpable, last::node::binary_writable>;
+        return Actions::create(std::move(node));
+    }
+
+    /* node with its position in source. LocationT is yy::location: it`s declared after this code */
+    template <typename NodeT, typename LocationT>
+    last::node::BasicNode create(NodeT node, LocationT const & location)
+    {
+        auto&& result = ParaCL::general::create(std::move(node));
+        result.set_location({
+            {static_cast<uint32_t>(location.begin.line), static_cast<uint32_t>(location.begin.column)},
+            {static_cast<uint32_t>(location.end.line)  , static_cast<uint32_t>(location.end.column)  }
+        });
+
+        return result;
+    }
+    } /* namespace ParaCL::general */
+
+    #include "parse_context.hpp"
+
+    /* scanner of reentrant flex (%option reentrant) */
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void* yyscan_t;
+    #endif /* YY_TYPEDEF_YY_SCANNER_T */
 }
 
 %code {
     #include "parse_error.hpp"
     #include "lexer.hpp"
-    #include "check_variables.hpp"
-
-
-    last::AST program;
-    ParaCL::ParserNameTable name_table;
-
-    int yylex(yy::parser::semantic_type* yylval, yy::parser::location_type* yylloc);
 }
 
 %precedence OR
@@ -51,14 +78,16 @@
 %precedence ELSE
 
 %token <int> NUM
-%token <std::string> VAR
-%token LCIB RCIB LCUB RCUB
-%token WH IN PRINT IF ELIF ELSE
+%token <last::node::Symbol> VAR /* name, interned by lexer in the symbol table of tree */
+%token LCIB RCIB LCUB RCUB LSQB RSQB
+%token WH IN PRINT IF ELIF ELSE REPEAT
 %token SC COMMA
-%token <std::string> STRING
+%token <last::node::Symbol> STRING /* value without quotes, interned as names */
 
 %type <std::vector<last::node::BasicNode>> statements print_args
 %type <last::node::BasicNode> statement assignment combined_assignment
+%type <last::node::BasicNode> array_declaration array_assignment
+%type <last::node::BinaryOperator::BinaryOperatorT> array_assignment_operator
 %type <last::node::BasicNode> print_statement while_statement condition_statement
 %type <last::node::BasicNode> expression assignment_expression logical_or_expression
 %type <last::node::BasicNode> logical_and_expression equality_expression relational_expression
@@ -72,16 +101,16 @@
 program:
     create_global_scope statements leave_global_scope {
         auto&& root_scope = last::node::Scope(std::move($2));
-        program = last::AST(last::node::create(std::move(root_scope)));
+        parse_context.program = ParaCL::general::create(std::move(root_scope), @$); /* generateAST moves it to last::AST */
     }
     ;
 
 create_global_scope:
-    %empty { name_table.new_scope(); }
+    %empty { parse_context.name_table.new_scope(); }
     ;
 
 leave_global_scope:
-    %empty { name_table.leave_scope(); }
+    %empty { parse_context.name_table.leave_scope(); }
     ;
 
 statements:
@@ -99,93 +128,138 @@ statements:
 statement:
     assignment SC { $$ = std::move($1); }
     | combined_assignment SC { $$ = std::move($1); }
+    | array_declaration SC { $$ = std::move($1); }
+    | array_assignment SC { $$ = std::move($1); }
     | print_statement SC { $$ = std::move($1); }
     | while_statement { $$ = std::move($1); }
     | condition_statement { $$ = std::move($1); }
-    | SC { $$ = last::node::create(last::node::Scope{}); }
+    | SC { $$ = ParaCL::general::create(last::node::Scope{}, @$); }
     | expression SC { $$ = std::move($1); }
     ;
 
 assignment:
     VAR AS expression {
-        name_table.declare_or_do_nothing_if_already_declared($1);
+        if (parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "array can`t be assigned as a whole: " + std::string($1.name()));
+            YYABORT;
+        }
+        parse_context.name_table.declare_or_do_nothing_if_already_declared($1);
 
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::ASGN,
-            last::node::create(last::node::Variable(std::move($1))),
+            ParaCL::general::create(last::node::Variable($1), @1),
             std::move($3)
         );
 
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | VAR AS error {
-        ErrorHandler::throwError(@3, "expected expression after assignment");
+        ErrorHandler::throwError(parse_context, @3, "expected expression after assignment");
         YYABORT;
     }
     ;
 
 combined_assignment:
     VAR ADDASGN expression {
-        if (name_table.is_not_declare($1)) {
-            ErrorHandler::throwError(@1, "using undeclared variable: " + $1);
+        if (parse_context.name_table.is_not_declare($1) or parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "using undeclared variable: " + std::string($1.name()));
             YYABORT;
         }
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::ADDASGN,
-            last::node::create(last::node::Variable(std::move($1))),
+            ParaCL::general::create(last::node::Variable($1), @1),
             std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | VAR SUBASGN expression {
-        if (name_table.is_not_declare($1)) {
-            ErrorHandler::throwError(@1, "using undeclared variable: " + $1);
+        if (parse_context.name_table.is_not_declare($1) or parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "using undeclared variable: " + std::string($1.name()));
             YYABORT;
         }
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::SUBASGN,
-            last::node::create(last::node::Variable(std::move($1))),
+            ParaCL::general::create(last::node::Variable($1), @1),
             std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | VAR MULASGN expression {
-        if (name_table.is_not_declare($1)) {
-            ErrorHandler::throwError(@1, "using undeclared variable: " + $1);
+        if (parse_context.name_table.is_not_declare($1) or parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "using undeclared variable: " + std::string($1.name()));
             YYABORT;
         }
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::MULASGN,
-            last::node::create(last::node::Variable(std::move($1))),
+            ParaCL::general::create(last::node::Variable($1), @1),
             std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | VAR DIVASGN expression {
-        if (name_table.is_not_declare($1)) {
-            ErrorHandler::throwError(@1, "using undeclared variable: " + $1);
+        if (parse_context.name_table.is_not_declare($1) or parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "using undeclared variable: " + std::string($1.name()));
             YYABORT;
         }
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::DIVASGN,
-            last::node::create(last::node::Variable(std::move($1))),
+            ParaCL::general::create(last::node::Variable($1), @1),
             std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
+    }
+    | VAR ADDASGN error { ErrorHandler::throwError(parse_context, @3, "expected expression after '+='"); YYABORT; }
+    | VAR SUBASGN error { ErrorHandler::throwError(parse_context, @3, "expected expression after '-='"); YYABORT; }
+    | VAR MULASGN error { ErrorHandler::throwError(parse_context, @3, "expected expression after '*='"); YYABORT; }
+    | VAR DIVASGN error { ErrorHandler::throwError(parse_context, @3, "expected expression after '/='"); YYABORT; }
+    ;
+
+/* a = repeat(value, size): size elements, every one is value */
+array_declaration:
+    VAR AS REPEAT LCIB expression COMMA expression RCIB {
+        if (parse_context.name_table.is_declare($1) and not parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "variable can`t be redeclared as array: " + std::string($1.name()));
+            YYABORT;
+        }
+        parse_context.name_table.declare_array_or_do_nothing_if_already_declared($1);
+
+        auto&& declaration = last::node::ArrayDeclaration($1, std::move($5), std::move($7));
+        $$ = ParaCL::general::create(std::move(declaration), @$);
+    }
+    | VAR AS REPEAT error { ErrorHandler::throwError(parse_context, @4, "expected '(value, size)' after repeat"); YYABORT; }
+    ;
+
+/* element is assigned by statement only: a[i] = a[j] = 0 is not allowed */
+array_assignment:
+    VAR LSQB expression RSQB array_assignment_operator expression {
+        if (not parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "using undeclared array: " + std::string($1.name()));
+            YYABORT;
+        }
+        auto&& assignment = last::node::ArrayAssignment($5, $1, std::move($3), std::move($6));
+        $$ = ParaCL::general::create(std::move(assignment), @$);
     }
-    | VAR ADDASGN error { ErrorHandler::throwError(@3, "expected expression after '+='"); YYABORT; }
-    | VAR SUBASGN error { ErrorHandler::throwError(@3, "expected expression after '-='"); YYABORT; }
-    | VAR MULASGN error { ErrorHandler::throwError(@3, "expected expression after '*='"); YYABORT; }
-    | VAR DIVASGN error { ErrorHandler::throwError(@3, "expected expression after '/='"); YYABORT; }
+    | VAR LSQB expression RSQB array_assignment_operator error {
+        ErrorHandler::throwError(parse_context, @6, "expected expression after assignment");
+        YYABORT;
+    }
+    ;
+
+array_assignment_operator:
+    AS        { $$ = last::node::BinaryOperator::BinaryOperatorT::ASGN; }
+    | ADDASGN { $$ = last::node::BinaryOperator::BinaryOperatorT::ADDASGN; }
+    | SUBASGN { $$ = last::node::BinaryOperator::BinaryOperatorT::SUBASGN; }
+    | MULASGN { $$ = last::node::BinaryOperator::BinaryOperatorT::MULASGN; }
+    | DIVASGN { $$ = last::node::BinaryOperator::BinaryOperatorT::DIVASGN; }
     ;
 
 print_statement:
     PRINT print_args {
         auto&& p = last::node::Print(std::move($2));
-        $$ = last::node::create(std::move(p));
+        $$ = ParaCL::general::create(std::move(p), @$);
     }
     | PRINT error {
-        ErrorHandler::throwError(@2, "expected expressions after print");
+        ErrorHandler::throwError(parse_context, @2, "expected expressions after print");
         YYABORT;
     }
     ;
@@ -199,16 +273,16 @@ print_args:
 while_statement:
     WH LCIB expression RCIB LCUB scope RCUB {
         auto&& w = last::node::While(std::move($3), std::move($6));
-        $$ = last::node::create(std::move(w));
+        $$ = ParaCL::general::create(std::move(w), @$);
     }
     | WH LCIB expression RCIB one_stmt_scope {
         auto&& w = last::node::While(std::move($3), std::move($5));
-        $$ = last::node::create(std::move(w));
+        $$ = ParaCL::general::create(std::move(w), @$);
     }
-    | WH LCIB error RCIB LCUB scope RCUB { ErrorHandler::throwError(@3, "expected condition in while"); YYABORT; }
-    | WH LCIB expression error LCUB scope RCUB { ErrorHandler::throwError(@4, "expected ')' after while condition"); YYABORT; }
-    | WH LCIB expression RCIB error { ErrorHandler::throwError(@5, "expected scope after while"); YYABORT; }
-    | WH error { ErrorHandler::throwError(@2, "expected '(' after while"); YYABORT; }
+    | WH LCIB error RCIB LCUB scope RCUB { ErrorHandler::throwError(parse_context, @3, "expected condition in while"); YYABORT; }
+    | WH LCIB expression error LCUB scope RCUB { ErrorHandler::throwError(parse_context, @4, "expected ')' after while condition"); YYABORT; }
+    | WH LCIB expression RCIB error { ErrorHandler::throwError(parse_context, @5, "expected scope after while"); YYABORT; }
+    | WH error { ErrorHandler::throwError(parse_context, @2, "expected '(' after while"); YYABORT; }
     ;
 
 condition_statement:
@@ -217,35 +291,35 @@ condition_statement:
         cond.add_condition(std::move($1));
         for (auto&& e : $2) cond.add_condition(std::move(e));
         if ($3) cond.set_else(std::move($3));
-        $$ = last::node::create(std::move(cond));
+        $$ = ParaCL::general::create(std::move(cond), @$);
     }
     ;
 
 if_statement:
     IF LCIB expression RCIB LCUB scope RCUB {
         auto&& i = last::node::If(std::move($3), std::move($6));
-        $$ = last::node::create(std::move(i));
+        $$ = ParaCL::general::create(std::move(i), @$);
     }
     | IF LCIB expression RCIB one_stmt_scope %prec THEN {
         auto&& i = last::node::If(std::move($3), std::move($5));
-        $$ = last::node::create(std::move(i));
+        $$ = ParaCL::general::create(std::move(i), @$);
     }
-    | IF LCIB error RCIB LCUB scope RCUB { ErrorHandler::throwError(@3, "expected condition in if"); YYABORT; }
-    | IF LCIB expression error LCUB scope RCUB { ErrorHandler::throwError(@4, "expected ')' after if"); YYABORT; }
-    | IF LCIB expression RCIB error { ErrorHandler::throwError(@5, "expected scope after if"); YYABORT; }
-    | IF error { ErrorHandler::throwError(@2, "expected '(' after if"); YYABORT; }
+    | IF LCIB error RCIB LCUB scope RCUB { ErrorHandler::throwError(parse_context, @3, "expected condition in if"); YYABORT; }
+    | IF LCIB expression error LCUB scope RCUB { ErrorHandler::throwError(parse_context, @4, "expected ')' after if"); YYABORT; }
+    | IF LCIB expression RCIB error { ErrorHandler::throwError(parse_context, @5, "expected scope after if"); YYABORT; }
+    | IF error { ErrorHandler::throwError(parse_context, @2, "expected '(' after if"); YYABORT; }
     ;
 
 elif_statements:
     %empty { $$ = std::vector<last::node::BasicNode>(); }
     | elif_statements ELIF LCIB expression RCIB LCUB scope RCUB %prec ELIF {
         auto&& e = last::node::If(std::move($4), std::move($7));
-        $1.push_back(last::node::create(std::move(e)));
+        $1.push_back(ParaCL::general::create(std::move(e), yy::location{@2.begin, @8.end}));
         $$ = std::move($1);
     }
     | elif_statements ELIF LCIB expression RCIB one_stmt_scope %prec ELIF {
         auto&& e = last::node::If(std::move($4), std::move($6));
-        $1.push_back(last::node::create(std::move(e)));
+        $1.push_back(ParaCL::general::create(std::move(e), yy::location{@2.begin, @6.end}));
         $$ = std::move($1);
     }
     ;
@@ -254,13 +328,13 @@ else_statement:
     %empty { $$ = last::node::BasicNode{}; }
     | ELSE LCUB scope RCUB %prec ELSE {
         auto&& e = last::node::Else(std::move($3));
-        $$ = last::node::create(std::move(e));
+        $$ = ParaCL::general::create(std::move(e), @$);
     }
     | ELSE one_stmt_scope %prec ELSE {
         auto&& e = last::node::Else(std::move($2));
-        $$ = last::node::create(std::move(e));
+        $$ = ParaCL::general::create(std::move(e), @$);
     }
-    | ELSE error { ErrorHandler::throwError(@2, "expected scope after else"); YYABORT; }
+    | ELSE error { ErrorHandler::throwError(parse_context, @2, "expected scope after else"); YYABORT; }
     ;
 
 expression:
@@ -271,15 +345,19 @@ expression:
 assignment_expression:
     logical_or_expression { $$ = std::move($1); }
     | VAR AS assignment_expression %prec AS {
-        name_table.declare_or_do_nothing_if_already_declared($1);
+        if (parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "array can`t be assigned as a whole: " + std::string($1.name()));
+            YYABORT;
+        }
+        parse_context.name_table.declare_or_do_nothing_if_already_declared($1);
 
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::ASGN,
-            last::node::create(last::node::Variable(std::move($1))),
+            ParaCL::general::create(last::node::Variable($1), @1),
             std::move($3)
         );
         
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     ;
 
@@ -290,7 +368,7 @@ logical_or_expression:
             last::node::BinaryOperator::BinaryOperatorT::OR,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     ;
 
@@ -301,7 +379,7 @@ logical_and_expression:
             last::node::BinaryOperator::BinaryOperatorT::AND,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     ;
 
@@ -312,14 +390,14 @@ equality_expression:
             last::node::BinaryOperator::BinaryOperatorT::ISEQ,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | equality_expression ISNE relational_expression %prec ISNE {
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::ISNE,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     ;
 
@@ -330,28 +408,28 @@ relational_expression:
             last::node::BinaryOperator::BinaryOperatorT::ISAB,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | relational_expression ISABE additive_expression %prec ISABE {
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::ISABE,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | relational_expression ISLS additive_expression %prec ISLS {
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::ISLS,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | relational_expression ISLSE additive_expression %prec ISLSE {
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::ISLSE,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     ;
 
@@ -362,14 +440,14 @@ additive_expression:
             last::node::BinaryOperator::BinaryOperatorT::ADD,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | additive_expression SUB multiplicative_expression %prec SUB {
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::SUB,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     ;
 
@@ -380,21 +458,21 @@ multiplicative_expression:
             last::node::BinaryOperator::BinaryOperatorT::MUL,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | multiplicative_expression DIV unary_expression %prec DIV {
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::DIV,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     | multiplicative_expression REM unary_expression %prec REM {
         auto&& binop = last::node::BinaryOperator(
             last::node::BinaryOperator::BinaryOperatorT::REM,
             std::move($1), std::move($3)
         );
-        $$ = last::node::create(std::move(binop));
+        $$ = ParaCL::general::create(std::move(binop), @$);
     }
     ;
 
@@ -405,48 +483,60 @@ unary_expression:
             last::node::UnaryOperator::UnaryOperatorT::MINUS,
             std::move($2)
         );
-        $$ = last::node::create(std::move(unop));
+        $$ = ParaCL::general::create(std::move(unop), @$);
     }
     | NOT unary_expression %prec NOT {
         auto&& unop = last::node::UnaryOperator(
             last::node::UnaryOperator::UnaryOperatorT::NOT,
             std::move($2)
         );
-        $$ = last::node::create(std::move(unop));
+        $$ = ParaCL::general::create(std::move(unop), @$);
     }
     | ADD unary_expression %prec NEG { $$ = std::move($2); }
     ;
 
 factor:
-    NUM { $$ = last::node::create(last::node::NumberLiteral($1)); }
+    NUM { $$ = ParaCL::general::create(last::node::NumberLiteral($1), @$); }
     | VAR {
-        if (name_table.is_not_declare($1)) {
-            ErrorHandler::throwError(@1, "using undeclared variable: " + $1);
+        if (parse_context.name_table.is_not_declare($1)) {
+            ErrorHandler::throwError(parse_context, @1, "using undeclared variable: " + std::string($1.name()));
+            YYABORT;
+        }
+        if (parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "array is used without index: " + std::string($1.name()));
+            YYABORT;
+        }
+        $$ = ParaCL::general::create(last::node::Variable($1), @$);
+    }
+    | VAR LSQB expression RSQB {
+        if (not parse_context.name_table.is_array($1)) {
+            ErrorHandler::throwError(parse_context, @1, "using undeclared array: " + std::string($1.name()));
             YYABORT;
         }
-        $$ = last::node::create(last::node::Variable(std::move($1)));
+        $$ = ParaCL::general::create(last::node::ArrayElement($1, std::move($3)), @$);
     }
     | LCIB expression RCIB { $$ = std::move($2); }
-    | IN { $$ = last::node::create(last::node::Scan{}); }
-    | STRING { $$ = last::node::create(last::node::StringLiteral(std::move($1))); }
+    | IN { $$ = ParaCL::general::create(last::node::Scan{}, @$); }
+    | STRING { $$ = ParaCL::general::create(last::node::StringLiteral($1), @$); }
     ;
 
 scope:
     scope_enter_action statements scope_leave_action {
         auto&& s = last::node::Scope(std::move($2));
-        $$ = last::node::create(std::move(s));
+        $$ = ParaCL::general::create(std::move(s), @$);
     }
     ;
 
 one_stmt_scope:
     scope_enter_action statement scope_leave_action {
-        std::vector<last::node::BasicNode> vec{std::move($2)};
+        auto&& vec = std::vector<last::node::BasicNode>{}; /* not initializer list: it would copy the statement */
+        vec.push_back(std::move($2));
         auto&& s = last::node::Scope(std::move(vec));
-        $$ = last::node::create(std::move(s));
+        $$ = ParaCL::general::create(std::move(s), @$);
     }
     ;
 
-scope_enter_action: %empty { name_table.new_scope(); } ;
-scope_leave_action: %empty { name_table.leave_scope(); } ;
+scope_enter_action: %empty { parse_context.name_table.new_scope(); } ;
+scope_leave_action: %empty { parse_context.name_table.leave_scope(); } ;
 
 %%
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+#include "lexer.hpp"
+
+import general;
+import thelast;
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+throughput of frontend in MB/s on generated source of given size:
+lexing only (tokens of reentrant scanner) and parsing (lexer, parser and building of AST).
+paraclf-bench [megabytes = 32] [repetitions = 3]
+*/
+
+namespace
+{
+
+constexpr size_t variables = 64;
+
+/* machine-like program: every variable is declared at the beginning, then blocks of statements are repeated */
+void generate(std::filesystem::path const & file, size_t bytes)
+{
+    auto&& out = std::ofstream{file, std::ios::binary};
+    if (not out.is_open())
+        throw std::runtime_error("Failed to create '" + file.string() + "'");
+
+    for (auto&& it = size_t{0}; it != variables; ++it)
+        out << "value_" << it << " = " << it << ";\n";
+
+    for (auto&& block = size_t{0}; static_cast<size_t>(out.tellp()) < bytes; ++block)
+    {
+        auto&& a = "value_" + std::to_string(block % variables);
+        auto&& b = "value_" + std::to_string((block * 7 + 3) % variables);
+        auto&& c = "value_" + std::to_string((block * 13 + 5) % variables);
+
+        out << "// block " << block << "\n"
+            << a << " = (" << b << " + " << block % 1000 << ") * " << c << " - 7;\n"
+            << "while (" << a << " < " << block % 100 << ")\n"
+            << "{\n"
+            << "    " << a << " += 1;\n"
+            << "    if (" << b << " == " << c << " && !(" << a << " > 3)) { print " << a << ", \" iteration\"; }\n"
+            << "    else if (" << c << " % 5 != 0) " << b << " = " << c << " / 2;\n"
+            << "    else { " << c << " -= " << b << "; }\n"
+            << "}\n";
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+size_t lex(std::filesystem::path const & file)
+{
+    auto&& source  = ParaCL::Source{file};
+    auto&& context = ParaCL::ParseContext{.file = file.string()};
+    auto&& scanner = ParaCL::Scanner{source, context};
+
+    auto&& location = yy::parser::location_type{};
+    auto&& tokens   = size_t{0};
+
+    /* values of tokens are int and last::node::Symbol: nothing to destroy */
+    for (auto&& value = yy::parser::semantic_type{};
+         yylex(&value, &location, scanner.get()) != yy::parser::token::YYEOF; value = yy::parser::semantic_type{})
+        ++tokens;
+
+    return tokens;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+template <typename Function>
+double best_seconds(size_t repetitions, Function&& function)
+{
+    auto&& best = std::chrono::duration<double>::max();
+
+    for (auto&& it = size_t{0}; it != repetitions; ++it)
+    {
+        auto&& start = std::chrono::steady_clock::now();
+        function();
+        best = std::min<std::chrono::duration<double>>(best, std::chrono::steady_clock::now() - start);
+    }
+
+    return best.count();
+}
+
+} /* anonymous namespace */
+
+//---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    auto&& megabytes   = (argc > 1) ? std::stoul(argv[1]) : 32ul;
+    auto&& repetitions = (argc > 2) ? std::stoul(argv[2]) : 3ul;
+
+    auto&& file = std::filesystem::temp_directory_path() / ("paraclf-bench-" + std::to_string(::getpid()) + ".cl");
+    generate(file, megabytes * 1024 * 1024);
+
+    auto&& size = static_cast<double>(std::filesystem::file_size(file)) / (1024 * 1024);
+    auto&& tokens = size_t{0};
+
+    auto&& lex_seconds   = best_seconds(repetitions, [&] { tokens = lex(file); });
+    auto&& parse_seconds = best_seconds(repetitions, [&] { ParaCL::general::generateAST(file.string()); });
+
+    auto&& ec = std::error_code{};
+    std::filesystem::remove(file, ec);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "source: " << size << " MB, " << tokens << " tokens (best of " << repetitions << ")\n"
+              << "lex:    " << std::setw(8) << size / lex_seconds   << " MB/s\n"
+              << "parse:  " << std::setw(8) << size / parse_seconds << " MB/s (lexer, parser and ast)\n";
+
+    return EXIT_SUCCESS;
+}
+catch (std::exception const & e)
+{
+    std::cerr << "paraclf-bench: " << e.what() << "\n";
+    return EXIT_FAILURE;
+}
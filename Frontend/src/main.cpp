@@ -1,31 +1,101 @@
+#include <atomic>
+#include <cstddef>
+#include <exception>
 #include <filesystem>
 #include <vector>
 #include <thread>
 #include <iostream>
+#include <string>
 
 import compileOpts;
 import general;
 import thelast;
 
-int main(int argc, char** argv) try
+//---------------------------------------------------------------------------------------------------------------
+
+void translate(std::filesystem::path const & inputPath, std::filesystem::path const & outputPath,
+               ParaCL::general::EmitFormat emitFormat, unsigned optimizationLevel)
 {
-    ParaCL::general::init_logging();
+    auto&& program = ParaCL::general::generateAST(inputPath.string(), optimizationLevel);
+
+    if (emitFormat == ParaCL::general::EmitFormat::BIN)
+        last::write_binary(program, outputPath);
+    else
+        last::write(program, outputPath);
+}
+
+//---------------------------------------------------------------------------------------------------------------
 
-    auto&& [inputs, outputs] = ParaCL::general::handleCompileOpts(argc, argv);
+/*
+-j N: N threads take input files one by one. error of one file doesn`t stop the others,
+errors are reported in order of inputs, after all files are done.
+*/
+bool translate_parallel(ParaCL::general::CommandLineData const & data)
+{
+    auto&& errors = std::vector<std::exception_ptr>(data.inputFiles.size());
+    auto&& next   = std::atomic<size_t>{0};
 
-    for (size_t it = 0, ite = inputs.size(); it != ite; ++it)
+    auto&& worker = [&]
     {
-        auto&& inputPath = inputs[it];
-        auto&& outputPath = outputs[it];
-        auto&& program = ParaCL::general::generateAST(inputPath.string());
-        auto&& parent = outputPath.parent_path();
-        last::write(program, outputPath);
+        for (auto&& it = next++; it < data.inputFiles.size(); it = next++)
+        {
+            try
+            {
+                translate(data.inputFiles[it], data.outputFiles[it], data.emitFormat, data.optimizationLevel);
+            }
+            catch (...)
+            {
+                errors[it] = std::current_exception();
+            }
+        }
+    };
+
+    {
+        auto&& workers = std::vector<std::jthread>{};
+        for (auto&& it = 1u; it < data.jobs; ++it) workers.emplace_back(worker);
+        worker();
+    }
+
+    auto&& success = true;
+
+    for (auto&& error : errors)
+    {
+        if (not error) continue;
+        success = false;
+
+        try
+        {
+            std::rethrow_exception(error);
+        }
+        catch (std::exception const & e)
+        {
+            std::cerr << e.what() << std::endl;
+        }
     }
 
+    return success;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    ParaCL::general::init_logging();
+
+    auto&& data = ParaCL::general::handleCompileOpts(argc, argv);
+
+    last::stats::start("paraclf", {.time_report = data.timeReport, .stats = data.stats, .time_trace = data.timeTrace});
+
+    if (data.jobs > 1)
+        return translate_parallel(data) ? 0 : 1;
+
+    for (size_t it = 0, ite = data.inputFiles.size(); it != ite; ++it)
+        translate(data.inputFiles[it], data.outputFiles[it], data.emitFormat, data.optimizationLevel);
+
     return 0;
 }
 catch (const std::exception& e)
-{    
+{
     std::cerr << e.what() << std::endl;
     return 1;
 }
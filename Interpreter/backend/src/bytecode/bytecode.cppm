@@ -0,0 +1,479 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module bytecode;
+
+//---------------------------------------------------------------------------------------------------------------
+
+import resolver;
+import thelast;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace interpreter::bytecode
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+stack machine instructions.
+operand meaning (if it has one) is written near every instruction.
+*/
+export
+enum class Opcode : uint8_t
+{
+    NOP          ,
+    PUSH         , /* operand: value */
+    POP          ,
+    DUP          ,
+    LOAD         , /* operand: slot. variable is surely declared here */
+    LOAD_CHECKED , /* operand: slot. variable may be not declared yet */
+    STORE        , /* operand: slot. pops stored value */
+    STORE_DECLARE, /* operand: slot. same as STORE, but also marks slot as declared */
+    NEG          ,
+    NOT          , /* 'and' and 'or' are jumps: right operand is not calculated, if result is known by left */
+    ADD          ,
+    SUB          ,
+    MUL          ,
+    DIV          ,
+    REM          ,
+    ISAB         ,
+    ISABE        ,
+    ISLS         ,
+    ISLSE        ,
+    ISEQ         ,
+    ISNE         ,
+    JMP          , /* operand: instruction index */
+    JZ           , /* operand: instruction index. pops condition */
+    JNZ          , /* operand: instruction index. pops condition */
+    ENTER        , /* operand: frame index. forgets declarations of frame slots */
+    NEW_ARRAY    , /* operand: array. pops size, then value of elements */
+    LOAD_ELEMENT , /* operand: array. replaces index on top by the element */
+    STORE_ELEMENT, /* operand: array. pops value, then index */
+    FREE_ARRAY   , /* operand: array. on exit from its scope */
+    SCAN         ,
+    PRINT_INT    ,
+    PRINT_STR    , /* operand: string index */
+    PRINT_END    ,
+    HALT         ,
+
+    OPCODES_COUNT
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+export
+struct Instruction
+{
+    Opcode  opcode;
+    int32_t operand;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* slots [first_slot, first_slot + size), which must be undeclared on every scope entry */
+export
+struct Frame
+{
+    int32_t first_slot;
+    int32_t size;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+export
+struct Program
+{
+    std::vector<Instruction> code;
+    std::vector<std::string> strings;
+    std::vector<Frame>       frames;
+    std::vector<std::string> slot_names; /* slot_names[slot] - for error messages only */
+    std::vector<std::string> array_names; /* the same for arrays */
+    size_t                   max_stack_depth;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+builds Program.
+every variable declaration gets its own slot, so slots are never reused and
+execution doesn`t need frames at all. the only runtime work of scopes is to forget
+declarations of variables, that can be read before they are surely declared.
+*/
+export
+class Builder final
+{
+  public:
+    using Label = size_t;
+  private:
+    struct Scope
+    {
+        size_t first_slot;
+        size_t enter_position;
+        size_t conditional_depth;
+        std::vector<int32_t> slots;  /* resolver slot -> program slot */
+        std::vector<int32_t> arrays; /* the same for arrays */
+    };
+  private:
+    std::vector<Instruction> code_;
+    std::vector<std::string> strings_;
+    std::vector<Frame>       frames_;
+    std::vector<std::string> slot_names_;
+    std::vector<std::string> array_names_;
+    std::vector<bool>        surely_declared_;
+    std::vector<bool>        checked_;
+    std::vector<size_t>      labels_;
+    std::vector<std::optional<size_t>> label_stack_depths_; /* stack depth on jumps to label */
+    std::vector<Scope>       scopes_;
+    resolver::Resolver       resolver_;
+    size_t                   conditional_depth_ = 0;
+    size_t                   stack_depth_       = 0;
+    size_t                   max_stack_depth_   = 0;
+  public:
+    void    emit             (Opcode opcode, int32_t operand = 0);
+    void    emit_jump        (Opcode opcode, Label label);
+    Label   new_label        ();
+    void    bind             (Label label);
+    int32_t add_string       (std::string_view string);
+
+    void    enter_scope      ();
+    void    leave_scope      ();
+    void    begin_conditional();
+    void    end_conditional  ();
+
+    void    load             (last::node::Symbol name);
+    void    store            (last::node::Symbol name);
+
+    void    new_array        (last::node::Symbol name);
+    void    load_element     (last::node::Symbol name);
+    void    store_element    (last::node::Symbol name);
+
+    Program finish           () &&;
+  private:
+    static int stack_effect_(Opcode opcode);
+    int32_t    program_slot_(nametable::Slot slot, std::string_view name);
+    int32_t    program_array_(nametable::Slot slot, std::string_view name);
+    int32_t    array_       (last::node::Symbol name);
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+int Builder::stack_effect_(Opcode opcode)
+{
+    switch (opcode)
+    {
+        case Opcode::PUSH:
+        case Opcode::DUP:
+        case Opcode::LOAD:
+        case Opcode::LOAD_CHECKED:
+        case Opcode::SCAN:          return +1;
+
+        case Opcode::POP:
+        case Opcode::STORE:
+        case Opcode::STORE_DECLARE:
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::DIV:
+        case Opcode::REM:
+        case Opcode::ISAB:
+        case Opcode::ISABE:
+        case Opcode::ISLS:
+        case Opcode::ISLSE:
+        case Opcode::ISEQ:
+        case Opcode::ISNE:
+        case Opcode::JZ:
+        case Opcode::JNZ:
+        case Opcode::PRINT_INT:     return -1;
+
+        case Opcode::NEW_ARRAY:
+        case Opcode::STORE_ELEMENT: return -2;
+
+        default:                    return 0;
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::emit(Opcode opcode, int32_t operand)
+{
+    stack_depth_ += stack_effect_(opcode);
+    max_stack_depth_ = std::max(max_stack_depth_, stack_depth_);
+
+    /* result of assignment statement is not used: 'DUP, STORE, POP' is the same as 'STORE' */
+    auto&& size = code_.size();
+    if (opcode == Opcode::POP and size >= 2 and code_[size - 2].opcode == Opcode::DUP and
+        (code_[size - 1].opcode == Opcode::STORE or code_[size - 1].opcode == Opcode::STORE_DECLARE))
+    {
+        code_.erase(code_.end() - 2);
+        return;
+    }
+
+    code_.push_back(Instruction{opcode, operand});
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* jump operands are label ids until finish() */
+void Builder::emit_jump(Opcode opcode, Label label)
+{
+    emit(opcode, static_cast<int32_t>(label));
+    label_stack_depths_.at(label) = stack_depth_;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+Builder::Label Builder::new_label()
+{
+    labels_.push_back(0);
+    label_stack_depths_.emplace_back();
+    return labels_.size() - 1;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::bind(Label label)
+{
+    labels_.at(label) = code_.size();
+
+    /* code after JMP is reached only by jumps: its stack is the stack of jumps (e.g. 'PUSH 1, JMP end, label: PUSH 0') */
+    if (not code_.empty() and code_.back().opcode == Opcode::JMP and label_stack_depths_.at(label).has_value())
+        stack_depth_ = *label_stack_depths_.at(label);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+int32_t Builder::add_string(std::string_view string)
+{
+    strings_.emplace_back(string);
+    return static_cast<int32_t>(strings_.size() - 1);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::enter_scope()
+{
+    LOGINFO("paracl: interpreter: bytecode: enter scope");
+
+    resolver_.new_scope();
+    scopes_.push_back(Scope{
+        .first_slot        = slot_names_.size(),
+        .enter_position    = code_.size(),
+        .conditional_depth = conditional_depth_,
+        .slots             = {},
+        .arrays            = {}
+    });
+
+    /* frame is known only at the end of scope */
+    emit(Opcode::ENTER);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::leave_scope()
+{
+    LOGINFO("paracl: interpreter: bytecode: leave scope");
+
+    if (scopes_.empty())
+        throw std::runtime_error("cannot leave scope: no active scopes");
+
+    auto&& scope = scopes_.back();
+    auto&& first = scope.first_slot;
+    auto&& last  = slot_names_.size();
+
+    /* arrays are freed, so every entry to the scope starts with empty ones (as in tree engine) */
+    for (auto&& array : scope.arrays)
+        emit(Opcode::FREE_ARRAY, array);
+
+    auto&& enter = code_[scope.enter_position];
+
+    /* nobody reads slots of this scope before they are surely declared: nothing to forget */
+    if (std::none_of(checked_.begin() + first, checked_.begin() + last, [](bool checked) { return checked; }))
+        enter.opcode = Opcode::NOP;
+    else
+    {
+        frames_.push_back(Frame{static_cast<int32_t>(first), static_cast<int32_t>(last - first)});
+        enter.operand = static_cast<int32_t>(frames_.size() - 1);
+    }
+
+    scopes_.pop_back();
+    resolver_.leave_scope();
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* code between begin_conditional and end_conditional may be not executed (or executed many times) */
+void Builder::begin_conditional()
+{
+    ++conditional_depth_;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::end_conditional()
+{
+    --conditional_depth_;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+int32_t Builder::program_slot_(nametable::Slot slot, std::string_view name)
+{
+    auto&& slots = scopes_.at(slot.depth).slots;
+
+    if (slot.slot < slots.size())
+        return slots[slot.slot];
+
+    LOGINFO("paracl: interpreter: bytecode: new slot for \"{}\"", name);
+
+    auto&& program_slot = static_cast<int32_t>(slot_names_.size());
+    slot_names_.emplace_back(name);
+    surely_declared_.push_back(false);
+    checked_.push_back(false);
+    slots.push_back(program_slot);
+    return program_slot;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::load(last::node::Symbol name)
+{
+    auto&& slot = resolver_.lookup(name);
+
+    if (not slot.has_value())
+        throw std::runtime_error(std::string("requests value of not exists variable: ") + std::string(name.name()));
+
+    auto&& program_slot = program_slot_(*slot, name.name());
+
+    if (surely_declared_[program_slot])
+        return emit(Opcode::LOAD, program_slot);
+
+    checked_[program_slot] = true;
+    emit(Opcode::LOAD_CHECKED, program_slot);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::store(last::node::Symbol name)
+{
+    auto&& slot = resolver_.lookup_or_declare(name);
+    auto&& program_slot = program_slot_(slot, name.name());
+
+    if (surely_declared_[program_slot])
+        return emit(Opcode::STORE, program_slot);
+
+    emit(Opcode::STORE_DECLARE, program_slot);
+
+    /* every next load in this scope will see the declaration, if store is not conditional in variable scope */
+    if (conditional_depth_ == scopes_.at(slot.depth).conditional_depth)
+        surely_declared_[program_slot] = true;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* every array declaration of resolver gets its own program array, as variables get program slots */
+int32_t Builder::program_array_(nametable::Slot slot, std::string_view name)
+{
+    auto&& arrays = scopes_.at(slot.depth).arrays;
+
+    if (slot.slot < arrays.size())
+        return arrays[slot.slot];
+
+    LOGINFO("paracl: interpreter: bytecode: new array \"{}\"", name);
+
+    auto&& program_array = static_cast<int32_t>(array_names_.size());
+    array_names_.emplace_back(name);
+    arrays.push_back(program_array);
+    return program_array;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+int32_t Builder::array_(last::node::Symbol name)
+{
+    auto&& slot = resolver_.lookup_array(name);
+
+    if (not slot.has_value())
+        throw std::runtime_error(std::string("requests element of not exists array: ") + std::string(name.name()));
+
+    return program_array_(*slot, name.name());
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::new_array(last::node::Symbol name)
+{
+    emit(Opcode::NEW_ARRAY, program_array_(resolver_.lookup_or_declare_array(name), name.name()));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::load_element(last::node::Symbol name)
+{
+    emit(Opcode::LOAD_ELEMENT, array_(name));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Builder::store_element(last::node::Symbol name)
+{
+    emit(Opcode::STORE_ELEMENT, array_(name));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+Program Builder::finish() &&
+{
+    LOGINFO("paracl: interpreter: bytecode: finish program");
+
+    emit(Opcode::HALT);
+
+    /* drop NOP-s and turn labels to instruction indexes */
+    auto&& new_positions = std::vector<size_t>(code_.size() + 1);
+    auto&& code = std::vector<Instruction>{};
+    code.reserve(code_.size());
+
+    for (size_t it = 0; it < code_.size(); ++it)
+    {
+        new_positions[it] = code.size();
+        if (code_[it].opcode != Opcode::NOP)
+            code.push_back(code_[it]);
+    }
+    new_positions[code_.size()] = code.size();
+
+    for (auto&& instruction : code)
+    {
+        if (instruction.opcode != Opcode::JMP and instruction.opcode != Opcode::JZ and instruction.opcode != Opcode::JNZ)
+            continue;
+        instruction.operand = static_cast<int32_t>(new_positions[labels_.at(instruction.operand)]);
+    }
+
+    return Program{
+        .code            = std::move(code),
+        .strings         = std::move(strings_),
+        .frames          = std::move(frames_),
+        .slot_names      = std::move(slot_names_),
+        .array_names     = std::move(array_names_),
+        .max_stack_depth = max_stack_depth_
+    };
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace interpreter::bytecode */
+//---------------------------------------------------------------------------------------------------------------
@@ -1,7 +1,8 @@
 module;
 
+#include <cstdint>
 #include <cstdlib>
-#include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <filesystem>
@@ -19,6 +20,12 @@ module;
 export module interpreter;
 
 import nametable;
+import io;
+import resolver;
+import tiering;
+import profile;
+import bytecode;
+import vm;
 import thelast;
 
 //-----------------------------------------------------------------------------
@@ -30,6 +37,8 @@ using executable_expression                     = int(interpreter::nametable::Na
 using executable_statement                      = void(interpreter::nametable::Nametable&);
 using printable_string                          = std::string_view();
 using executable_if_with_return_codition_status = bool(interpreter::nametable::Nametable&);
+using resolvable                                = BasicNode(interpreter::resolver::Resolver&);
+using compilable                                = size_t(interpreter::bytecode::Builder&);
 
 static_assert(not std::is_same_v<executable_expression, executable_statement>                       , "visit specializations must be different");
 static_assert(not std::is_same_v<executable_expression, printable_string>                           , "visit specializations must be different");
@@ -37,6 +46,10 @@ static_assert(not std::is_same_v<executable_statement, printable_string>
 static_assert(not std::is_same_v<executable_if_with_return_codition_status, executable_statement>   , "visit specializations must be different");
 static_assert(not std::is_same_v<executable_if_with_return_codition_status, executable_expression>  , "visit specializations must be different");
 static_assert(not std::is_same_v<executable_if_with_return_codition_status, printable_string>       , "visit specializations must be different");
+static_assert(not std::is_same_v<resolvable, executable_expression>                                 , "visit specializations must be different");
+static_assert(not std::is_same_v<resolvable, executable_statement>                                  , "visit specializations must be different");
+static_assert(not std::is_same_v<compilable, executable_expression>                                 , "visit specializations must be different");
+static_assert(not std::is_same_v<compilable, resolvable>                                            , "visit specializations must be different");
 
 } /* namespace last::node */
 
@@ -65,6 +78,67 @@ decltype(auto) execute_if_with_return_codition_status(BasicNode const & node, in
     return visit<bool, interpreter::nametable::Nametable&>(node, nametable);
 }
 
+decltype(auto) resolve(BasicNode const & node, interpreter::resolver::Resolver& resolver)
+{
+    return visit<BasicNode, interpreter::resolver::Resolver&>(node, resolver);
+}
+
+/* returns how many values compiled code leaves on the stack */
+decltype(auto) compile(BasicNode const & node, interpreter::bytecode::Builder& builder)
+{
+    return visit<size_t, interpreter::bytecode::Builder&>(node, builder);
+}
+
+void compile_statement(BasicNode const & node, interpreter::bytecode::Builder& builder)
+{
+    if (compile(node, builder) != 0)
+        builder.emit(interpreter::bytecode::Opcode::POP);
+}
+
+/*
+jumps to label, if truth of condition is jump_if, else goes to the next instruction.
+'and', 'or' and 'not' are only jumps here: their values are never pushed on the stack.
+*/
+void compile_branch(BasicNode const & node, interpreter::bytecode::Builder& builder,
+                    interpreter::bytecode::Builder::Label label, bool jump_if);
+
+/* 'and' or 'or': right is calculated, only if result isn`t known by left */
+void compile_logical_branch(BinaryOperator const & node, interpreter::bytecode::Builder& builder,
+                            interpreter::bytecode::Builder::Label label, bool jump_if)
+{
+    /* result of 'and' is known by left, if left is false. result of 'or' - if left is true */
+    auto&& known_by_left = (node.type() == BinaryOperator::OR);
+
+    /* left, which decides the result, goes to label or skips right */
+    auto&& skip_right = builder.new_label();
+    compile_branch(node.larg(), builder, (known_by_left == jump_if) ? label : skip_right, known_by_left);
+
+    builder.begin_conditional();
+    compile_branch(node.rarg(), builder, label, jump_if);
+    builder.end_conditional();
+
+    builder.bind(skip_right);
+}
+
+void compile_branch(BasicNode const & node, interpreter::bytecode::Builder& builder,
+                    interpreter::bytecode::Builder::Label label, bool jump_if)
+{
+    using interpreter::bytecode::Opcode;
+
+    if (node.is_a<UnaryOperator>() and static_cast<UnaryOperator const &>(node).type() == UnaryOperator::NOT)
+        return compile_branch(static_cast<UnaryOperator const &>(node).arg(), builder, label, not jump_if);
+
+    if (node.is_a<BinaryOperator>())
+    {
+        auto&& binary = static_cast<BinaryOperator const &>(node);
+        if (binary.type() == BinaryOperator::AND or binary.type() == BinaryOperator::OR)
+            return compile_logical_branch(binary, builder, label, jump_if);
+    }
+
+    compile(node, builder);
+    builder.emit_jump(jump_if ? Opcode::JNZ : Opcode::JZ, label);
+}
+
 } /* namespace last::node */
 
 //-----------------------------------------------------------------------------
@@ -78,8 +152,7 @@ namespace last::node::visit_specializations
 template <>
 int visit(Scan const& node, interpreter::nametable::Nametable& nametable)
 {
-    int value;
-    std::cin >> value;
+    auto&& value = interpreter::io::input().read_int();
     LOGINFO("paracl: interpreter: scan value: {}", value);
     return value;
 }
@@ -96,19 +169,18 @@ void visit(Scan const& node, interpreter::nametable::Nametable& nametable)
 // VARIABLE
 //-----------------------------------------------------------------------------
 template <>
-int visit(Variable const& node, interpreter::nametable::Nametable& nametable)
+int visit(interpreter::resolver::nodes::ResolvedVariable const& node, interpreter::nametable::Nametable& nametable)
 {
-    auto&& var_name = node.name();
-    auto&& value = nametable.get_variable_value(var_name);
+    auto&& value = nametable.get_variable_value(node.slot(), node.name());
 
-    LOGINFO("paracl: interpreter: get variable '{}' = {}", var_name, value);
+    LOGINFO("paracl: interpreter: get variable '{}' = {}", node.name(), value);
     return value;
 }
 
 template <>
-void visit(Variable const& node, interpreter::nametable::Nametable& nametable)
+void visit(interpreter::resolver::nodes::ResolvedVariable const& node, interpreter::nametable::Nametable& nametable)
 {
-    (void) visit<Variable, int, interpreter::nametable::Nametable&>(node, nametable);
+    (void) visit<interpreter::resolver::nodes::ResolvedVariable, int, interpreter::nametable::Nametable&>(node, nametable);
 }
 
 //-----------------------------------------------------------------------------
@@ -171,19 +243,24 @@ int visit(BinaryOperator const& node, interpreter::nametable::Nametable& nametab
 
     if (node.type() == BinaryOperator::ASGN)
     {
-        auto&& variable = static_cast<Variable const &>(node.larg());
+        auto&& variable = static_cast<interpreter::resolver::nodes::ResolvedVariable const &>(node.larg());
         auto&& right = execute_expsession(node.rarg(), nametable);
-        nametable.set_value(variable.name(), right);
+        nametable.set_value(variable.slot(), right);
         return right;
     }
 
+    /* right is not executed, if result is known by left */
+    if (node.type() == BinaryOperator::AND)
+        return execute_expsession(node.larg(), nametable) && execute_expsession(node.rarg(), nametable);
+
+    if (node.type() == BinaryOperator::OR)
+        return execute_expsession(node.larg(), nametable) || execute_expsession(node.rarg(), nametable);
+
     auto&& left  = execute_expsession(node.larg(), nametable);
     auto&& right = execute_expsession(node.rarg(), nametable);
 
     switch (node.type())
     {
-        case BinaryOperator::AND:     return left && right;
-        case BinaryOperator::OR:      return left || right;
         case BinaryOperator::ADD:     return left +  right;
         case BinaryOperator::SUB:     return left -  right;
         case BinaryOperator::MUL:     return left *  right;
@@ -210,8 +287,8 @@ int visit(BinaryOperator const& node, interpreter::nametable::Nametable& nametab
         default: __builtin_unreachable();
     }
 
-    auto&& variable = static_cast<Variable const &>(node.larg());
-    nametable.set_value(variable.name(), left);
+    auto&& variable = static_cast<interpreter::resolver::nodes::ResolvedVariable const &>(node.larg());
+    nametable.set_value(variable.slot(), left);
     return left;
 }
 
@@ -221,6 +298,61 @@ void visit(BinaryOperator const& node, interpreter::nametable::Nametable& nameta
     (void) visit<BinaryOperator, int, interpreter::nametable::Nametable&>(node, nametable);
 }
 
+//-----------------------------------------------------------------------------
+// ARRAYS
+//-----------------------------------------------------------------------------
+template <>
+void visit(interpreter::resolver::nodes::ResolvedArrayDeclaration const& node, interpreter::nametable::Nametable& nametable)
+{
+    LOGINFO("paracl: interpreter: execute array declaration '{}'", node.name());
+
+    auto&& value = execute_expsession(node.value(), nametable);
+    auto&& size  = execute_expsession(node.size(), nametable);
+    nametable.create_array(node.slot(), size, value, node.name());
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+int visit(interpreter::resolver::nodes::ResolvedArrayElement const& node, interpreter::nametable::Nametable& nametable)
+{
+    auto&& index = execute_expsession(node.index(), nametable);
+    return nametable.get_element(node.slot(), index, node.name());
+}
+
+template <>
+void visit(interpreter::resolver::nodes::ResolvedArrayElement const& node, interpreter::nametable::Nametable& nametable)
+{
+    (void) visit<interpreter::resolver::nodes::ResolvedArrayElement, int, interpreter::nametable::Nametable&>(node, nametable);
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+void visit(interpreter::resolver::nodes::ResolvedArrayAssignment const& node, interpreter::nametable::Nametable& nametable)
+{
+    auto&& index = execute_expsession(node.index(), nametable);
+
+    if (node.type() == BinaryOperator::ASGN)
+        return nametable.set_element(node.slot(), index, execute_expsession(node.value(), nametable), node.name());
+
+    /* element is read before value is calculated, as left of the same operator for variables */
+    auto&& element = nametable.get_element(node.slot(), index, node.name());
+    auto&& value   = execute_expsession(node.value(), nametable);
+
+    switch (node.type())
+    {
+        case BinaryOperator::ADDASGN: element += value; break;
+        case BinaryOperator::SUBASGN: element -= value; break;
+        case BinaryOperator::MULASGN: element *= value; break;
+        case BinaryOperator::DIVASGN: element /= value; break;
+        case BinaryOperator::REMASGN: element %= value; break;
+        default: __builtin_unreachable();
+    }
+
+    nametable.set_element(node.slot(), index, element, node.name());
+}
+
 //-----------------------------------------------------------------------------
 // WHILE
 //-----------------------------------------------------------------------------
@@ -233,6 +365,41 @@ void visit(While const& node, interpreter::nametable::Nametable& nametable)
         execute_statement(node.body(), nametable);
 }
 
+//-----------------------------------------------------------------------------
+
+template <>
+void visit(interpreter::tiering::TieredWhile const& node, interpreter::nametable::Nametable& nametable)
+{
+    LOGINFO("paracl: interpreter: execute tiered WHILE statement");
+
+    if (node.run_compiled(nametable)) return;
+
+    while (execute_expsession(node.condition(), nametable))
+    {
+        execute_statement(node.body(), nametable);
+        if (node.tier_up(nametable)) return;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// PROFILE
+//-----------------------------------------------------------------------------
+template <>
+void visit(interpreter::profile::nodes::Profiled const& node, interpreter::nametable::Nametable& nametable)
+{
+    [[maybe_unused]] auto&& measure = node.measure();
+    execute_statement(node.statement(), nametable);
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+void visit(interpreter::profile::nodes::Iteration const& node, interpreter::nametable::Nametable& nametable)
+{
+    node.count();
+    execute_statement(node.body(), nametable);
+}
+
 //-----------------------------------------------------------------------------
 // IF
 //-----------------------------------------------------------------------------
@@ -291,14 +458,16 @@ void visit(Print const& node, interpreter::nametable::Nametable& nametable)
 {
     LOGINFO("paracl: interpreter: execute print statement");
 
+    auto&& output = interpreter::io::output();
+
     for (auto&& arg : node)
     {
         if (arg.support<printable_string>())
-            std::cout << print_string(arg);
+            output.write(print_string(arg));
         else
-            std::cout << execute_expsession(arg, nametable);
+            output.write(execute_expsession(arg, nametable));
     }
-    std::cout << std::endl;
+    output.end_line();
 }
 
 //-----------------------------------------------------------------------------
@@ -306,11 +475,11 @@ void visit(Print const& node, interpreter::nametable::Nametable& nametable)
 //-----------------------------------------------------------------------------
 
 template <>
-void visit(Scope const& node, interpreter::nametable::Nametable& nametable)
+void visit(interpreter::resolver::nodes::ResolvedScope const& node, interpreter::nametable::Nametable& nametable)
 {
     LOGINFO("paracl: interpreter: execute scope statement");
 
-    nametable.new_scope();
+    nametable.new_scope(node.frame_size(), node.array_frame_size());
 
     for (auto&& arg : node)
         execute_statement(arg, nametable);
@@ -322,18 +491,564 @@ void visit(Scope const& node, interpreter::nametable::Nametable& nametable)
 } /* namespace last::node::visit_specializations */
 //-----------------------------------------------------------------------------
 
-SPECIALIZE_CREATE(last::node::Scan           , last::node::executable_statement  , last::node::executable_expression                      )
-SPECIALIZE_CREATE(last::node::Variable       , last::node::executable_statement  , last::node::executable_expression                      )
-SPECIALIZE_CREATE(last::node::NumberLiteral  , last::node::executable_statement  , last::node::executable_expression                      )
-SPECIALIZE_CREATE(last::node::UnaryOperator  , last::node::executable_statement  , last::node::executable_expression                      )
-SPECIALIZE_CREATE(last::node::BinaryOperator , last::node::executable_statement  , last::node::executable_expression                      )
-SPECIALIZE_CREATE(last::node::If             , last::node::executable_statement  , last::node::executable_if_with_return_codition_status  )
-SPECIALIZE_CREATE(last::node::Print          , last::node::executable_statement                                                           )
-SPECIALIZE_CREATE(last::node::While          , last::node::executable_statement                                                           )
-SPECIALIZE_CREATE(last::node::Else           , last::node::executable_statement                                                           )
-SPECIALIZE_CREATE(last::node::Condition      , last::node::executable_statement                                                           )
-SPECIALIZE_CREATE(last::node::Scope          , last::node::executable_statement                                                           )
-SPECIALIZE_CREATE(last::node::StringLiteral  , last::node::printable_string                                                               )
+//-----------------------------------------------------------------------------
+// RESOLUTION PASS
+//-----------------------------------------------------------------------------
+/*
+runs once before execution.
+builds the same tree, but Variable-s are replaced by ResolvedVariable-s (bound to slots)
+and Scope-s by ResolvedScope-s (which know size of their frames),
+so execution never searches variables by name.
+*/
+
+namespace last::node::visit_specializations
+{
+
+using interpreter::resolver::Resolver;
+using interpreter::resolver::nodes::ResolvedVariable;
+using interpreter::resolver::nodes::ResolvedScope;
+using interpreter::resolver::nodes::ResolvedArrayDeclaration;
+using interpreter::resolver::nodes::ResolvedArrayElement;
+using interpreter::resolver::nodes::ResolvedArrayAssignment;
+
+/*
+resolved tree is only executed, so its nodes are created directly with execution signatures:
+every extra signature costs one more check on each visit.
+*/
+using expression_node = BasicNode::Actions<executable_statement, executable_expression>;
+using statement_node  = BasicNode::Actions<executable_statement>;
+using if_node         = BasicNode::Actions<executable_statement, executable_if_with_return_codition_status>;
+using string_node     = BasicNode::Actions<printable_string>;
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit([[maybe_unused]] Scan const& node, [[maybe_unused]] Resolver& resolver)
+{
+    return expression_node::create(Scan{});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(Variable const& node, Resolver& resolver)
+{
+    auto&& slot = resolver.lookup(node.symbol());
+
+    if (not slot.has_value())
+        throw std::runtime_error(std::string("requests value of not exists variable: ") + std::string(node.name()));
+
+    LOGINFO("paracl: interpreter: resolve variable '{}' to ({}, {})", node.name(), slot->depth, slot->slot);
+    return expression_node::create(ResolvedVariable{*slot, node.symbol()});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(NumberLiteral const& node, [[maybe_unused]] Resolver& resolver)
+{
+    return expression_node::create(NumberLiteral{node.value()});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(StringLiteral const& node, [[maybe_unused]] Resolver& resolver)
+{
+    return string_node::create(StringLiteral{node.symbol()});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(UnaryOperator const& node, Resolver& resolver)
+{
+    return expression_node::create(UnaryOperator{node.type(), resolve(node.arg(), resolver)});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(BinaryOperator const& node, Resolver& resolver)
+{
+    if (node.type() == BinaryOperator::ASGN)
+    {
+        /* right first: variable is declared only after its value was calculated */
+        auto&& right = resolve(node.rarg(), resolver);
+        auto&& variable = static_cast<Variable const &>(node.larg());
+        auto&& slot = resolver.lookup_or_declare(variable.symbol());
+        auto&& left = expression_node::create(ResolvedVariable{slot, variable.symbol()});
+        return expression_node::create(BinaryOperator{node.type(), std::move(left), std::move(right)});
+    }
+
+    auto&& left  = resolve(node.larg(), resolver);
+    auto&& right = resolve(node.rarg(), resolver);
+    return expression_node::create(BinaryOperator{node.type(), std::move(left), std::move(right)});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(ArrayDeclaration const& node, Resolver& resolver)
+{
+    /* as for variables: array is declared only after its value and size were calculated */
+    auto&& value = resolve(node.value(), resolver);
+    auto&& size  = resolve(node.size(), resolver);
+    auto&& slot  = resolver.lookup_or_declare_array(node.symbol());
+    return statement_node::create(ResolvedArrayDeclaration{slot, node.symbol(), std::move(value), std::move(size)});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(ArrayElement const& node, Resolver& resolver)
+{
+    auto&& slot = resolver.lookup_array(node.symbol());
+
+    if (not slot.has_value())
+        throw std::runtime_error(std::string("requests element of not exists array: ") + std::string(node.name()));
+
+    return expression_node::create(ResolvedArrayElement{*slot, node.symbol(), resolve(node.index(), resolver)});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(ArrayAssignment const& node, Resolver& resolver)
+{
+    auto&& index = resolve(node.index(), resolver);
+    auto&& value = resolve(node.value(), resolver);
+    auto&& slot  = resolver.lookup_array(node.symbol());
+
+    if (not slot.has_value())
+        throw std::runtime_error(std::string("requests element of not exists array: ") + std::string(node.name()));
+
+    return statement_node::create(ResolvedArrayAssignment{node.type(), *slot, node.symbol(), std::move(index), std::move(value)});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(While const& node, Resolver& resolver)
+{
+    if (resolver.tiering().compiler)
+    {
+        resolver.begin_loop();
+        auto&& condition = resolve(node.condition(), resolver);
+        auto&& body      = resolve(node.body(), resolver);
+        auto&& captures  = resolver.end_loop();
+
+        /* loop with outer arrays is only interpreted */
+        if (not captures.has_value())
+            return statement_node::create(While{std::move(condition), std::move(body)});
+
+        return statement_node::create(interpreter::tiering::TieredWhile{
+            std::move(condition), std::move(body), node, std::move(*captures), resolver.tiering()
+        });
+    }
+
+    auto&& condition = resolve(node.condition(), resolver);
+    auto&& body      = resolve(node.body(), resolver);
+    return statement_node::create(While{std::move(condition), std::move(body)});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(If const& node, Resolver& resolver)
+{
+    auto&& condition = resolve(node.condition(), resolver);
+    auto&& body      = resolve(node.body(), resolver);
+    return if_node::create(If{std::move(condition), std::move(body)});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(Else const& node, Resolver& resolver)
+{
+    return statement_node::create(Else{resolve(node.body(), resolver)});
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(Condition const& node, Resolver& resolver)
+{
+    auto&& condition = Condition{};
+
+    for (auto&& if_node : node.get_ifs())
+        condition.add_condition(resolve(if_node, resolver));
+
+    if (node.has_else())
+        condition.set_else(resolve(node.get_else(), resolver));
+
+    return statement_node::create(std::move(condition));
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(Print const& node, Resolver& resolver)
+{
+    auto&& args = std::vector<BasicNode>{};
+    args.reserve(node.size());
+
+    for (auto&& arg : node)
+        args.push_back(resolve(arg, resolver));
+
+    return statement_node::create(Print{std::move(args)});
+}
+
+//-----------------------------------------------------------------------------
+
+/*
+with profiler every statement (besides nested scopes, which have no line) is measured.
+body of while also counts iterations: it goes to the same counter as the loop.
+*/
+BasicNode resolve_statement(BasicNode const & statement, Resolver& resolver)
+{
+    using interpreter::profile::nodes::Profiled;
+    using interpreter::profile::nodes::Iteration;
+
+    auto&& profiler = resolver.profiler();
+    if (not profiler or statement.is_a<Scope>()) return resolve(statement, resolver);
+
+    auto&& loop    = statement.is_a<While>();
+    auto&& counter = profiler->add(statement.location(), loop);
+
+    if (not loop)
+        return statement_node::create(Profiled{resolve(statement, resolver), counter, *profiler});
+
+    auto&& source    = static_cast<While const &>(statement);
+    auto&& condition = resolve(source.condition(), resolver);
+    auto&& body      = statement_node::create(Iteration{resolve(source.body(), resolver), counter});
+
+    return statement_node::create(Profiled{
+        statement_node::create(While{std::move(condition), std::move(body)}), counter, *profiler
+    });
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+BasicNode visit(Scope const& node, Resolver& resolver)
+{
+    resolver.new_scope();
+
+    auto&& statements = std::vector<BasicNode>{};
+    statements.reserve(node.size());
+
+    for (auto&& statement : node)
+        statements.push_back(resolve_statement(statement, resolver));
+
+    auto&& frame_size       = resolver.frame_size();
+    auto&& array_frame_size = resolver.array_frame_size();
+
+    resolver.leave_scope();
+
+    return statement_node::create(ResolvedScope{frame_size, array_frame_size, std::move(statements)});
+}
+
+//-----------------------------------------------------------------------------
+} /* namespace last::node::visit_specializations */
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// BYTECODE COMPILATION
+//-----------------------------------------------------------------------------
+/*
+used only with --engine=bytecode.
+compiles the parsed tree to bytecode::Program, which is executed by vm.
+*/
+
+namespace last::node::visit_specializations
+{
+
+using interpreter::bytecode::Builder;
+using interpreter::bytecode::Opcode;
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit([[maybe_unused]] Scan const& node, Builder& builder)
+{
+    builder.emit(Opcode::SCAN);
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(Variable const& node, Builder& builder)
+{
+    builder.load(node.symbol());
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(NumberLiteral const& node, Builder& builder)
+{
+    builder.emit(Opcode::PUSH, node.value());
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(UnaryOperator const& node, Builder& builder)
+{
+    compile(node.arg(), builder);
+
+    switch (node.type())
+    {
+        case UnaryOperator::MINUS: builder.emit(Opcode::NEG); break;
+        case UnaryOperator::PLUS:                             break;
+        case UnaryOperator::NOT:   builder.emit(Opcode::NOT); break;
+        default: __builtin_unreachable();
+    }
+
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(BinaryOperator const& node, Builder& builder)
+{
+    if (node.type() == BinaryOperator::ASGN)
+    {
+        compile(node.rarg(), builder);
+        builder.emit(Opcode::DUP); /* assignment is an expression. if it`s a statement, builder will drop DUP */
+        builder.store(static_cast<Variable const &>(node.larg()).symbol());
+        return 1;
+    }
+
+    if (node.type() == BinaryOperator::AND or node.type() == BinaryOperator::OR)
+    {
+        /* value is needed only if 'and'/'or' is not a condition of while or if (they use compile_branch) */
+        auto&& is_false = builder.new_label();
+        auto&& end      = builder.new_label();
+
+        compile_logical_branch(node, builder, is_false, false);
+        builder.emit(Opcode::PUSH, 1);
+        builder.emit_jump(Opcode::JMP, end);
+        builder.bind(is_false);
+        builder.emit(Opcode::PUSH, 0);
+        builder.bind(end);
+        return 1;
+    }
+
+    compile(node.larg(), builder);
+    compile(node.rarg(), builder);
+
+    switch (node.type())
+    {
+        case BinaryOperator::ADD:     builder.emit(Opcode::ADD);   return 1;
+        case BinaryOperator::SUB:     builder.emit(Opcode::SUB);   return 1;
+        case BinaryOperator::MUL:     builder.emit(Opcode::MUL);   return 1;
+        case BinaryOperator::DIV:     builder.emit(Opcode::DIV);   return 1;
+        case BinaryOperator::REM:     builder.emit(Opcode::REM);   return 1;
+        case BinaryOperator::ISAB:    builder.emit(Opcode::ISAB);  return 1;
+        case BinaryOperator::ISABE:   builder.emit(Opcode::ISABE); return 1;
+        case BinaryOperator::ISLS:    builder.emit(Opcode::ISLS);  return 1;
+        case BinaryOperator::ISLSE:   builder.emit(Opcode::ISLSE); return 1;
+        case BinaryOperator::ISEQ:    builder.emit(Opcode::ISEQ);  return 1;
+        case BinaryOperator::ISNE:    builder.emit(Opcode::ISNE);  return 1;
+        default: break;
+    }
+
+    /* left is a variable value, if we`re here */
+
+    switch (node.type())
+    {
+        case BinaryOperator::ADDASGN: builder.emit(Opcode::ADD); break;
+        case BinaryOperator::SUBASGN: builder.emit(Opcode::SUB); break;
+        case BinaryOperator::MULASGN: builder.emit(Opcode::MUL); break;
+        case BinaryOperator::DIVASGN: builder.emit(Opcode::DIV); break;
+        case BinaryOperator::REMASGN: builder.emit(Opcode::REM); break;
+        default: __builtin_unreachable();
+    }
+
+    builder.emit(Opcode::DUP);
+    builder.store(static_cast<Variable const &>(node.larg()).symbol());
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(ArrayDeclaration const& node, Builder& builder)
+{
+    compile(node.value(), builder);
+    compile(node.size(), builder);
+    builder.new_array(node.symbol());
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(ArrayElement const& node, Builder& builder)
+{
+    compile(node.index(), builder);
+    builder.load_element(node.symbol());
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(ArrayAssignment const& node, Builder& builder)
+{
+    compile(node.index(), builder);
+
+    if (node.type() == BinaryOperator::ASGN)
+    {
+        compile(node.value(), builder);
+        builder.store_element(node.symbol());
+        return 0;
+    }
+
+    /* index is needed twice: to load element and to store the result */
+    builder.emit(Opcode::DUP);
+    builder.load_element(node.symbol());
+    compile(node.value(), builder);
+
+    switch (node.type())
+    {
+        case BinaryOperator::ADDASGN: builder.emit(Opcode::ADD); break;
+        case BinaryOperator::SUBASGN: builder.emit(Opcode::SUB); break;
+        case BinaryOperator::MULASGN: builder.emit(Opcode::MUL); break;
+        case BinaryOperator::DIVASGN: builder.emit(Opcode::DIV); break;
+        case BinaryOperator::REMASGN: builder.emit(Opcode::REM); break;
+        default: __builtin_unreachable();
+    }
+
+    builder.store_element(node.symbol());
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(While const& node, Builder& builder)
+{
+    /*
+    condition is compiled twice: before the loop (it`s the first one in the source, so it declares variables)
+    and after body, so iteration costs one jump instead of two
+    */
+    auto&& body = builder.new_label();
+    auto&& end  = builder.new_label();
+
+    compile_branch(node.condition(), builder, end, false);
+
+    builder.begin_conditional();
+
+    builder.bind(body);
+    compile_statement(node.body(), builder);
+    compile_branch(node.condition(), builder, body, true);
+
+    builder.end_conditional();
+
+    builder.bind(end);
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(Condition const& node, Builder& builder)
+{
+    auto&& end = builder.new_label();
+    auto&& ifs = node.get_ifs();
+
+    for (auto&& if_node : ifs)
+    {
+        auto&& if_statement = static_cast<If const &>(if_node);
+        auto&& next = builder.new_label();
+
+        compile_branch(if_statement.condition(), builder, next, false);
+
+        /* everything after the first condition may be not executed */
+        builder.begin_conditional();
+
+        compile_statement(if_statement.body(), builder);
+        builder.emit_jump(Opcode::JMP, end);
+        builder.bind(next);
+    }
+
+    if (node.has_else())
+        compile_statement(static_cast<Else const &>(node.get_else()).body(), builder);
+
+    for ([[maybe_unused]] auto&& if_node : ifs)
+        builder.end_conditional();
+
+    builder.bind(end);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(Print const& node, Builder& builder)
+{
+    for (auto&& arg : node)
+    {
+        if (arg.is_a<StringLiteral>())
+        {
+            builder.emit(Opcode::PRINT_STR, builder.add_string(static_cast<StringLiteral const &>(arg).value()));
+            continue;
+        }
+
+        compile(arg, builder);
+        builder.emit(Opcode::PRINT_INT);
+    }
+
+    builder.emit(Opcode::PRINT_END);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+template <>
+size_t visit(Scope const& node, Builder& builder)
+{
+    builder.enter_scope();
+
+    for (auto&& statement : node)
+        compile_statement(statement, builder);
+
+    builder.leave_scope();
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+} /* namespace last::node::visit_specializations */
+//-----------------------------------------------------------------------------
+
+/*
+only the parsed tree is resolved (or compiled), execution works with nodes created by resolution pass.
+parsed tree is also written to binary format: so hot loops are passed to the compiler (see tiering)
+*/
+SPECIALIZE_CREATE(last::node::Scan            , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::Variable        , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::NumberLiteral   , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::UnaryOperator   , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::BinaryOperator  , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::ArrayDeclaration, last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::ArrayElement    , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::ArrayAssignment , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::Print           , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::While           , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::Condition       , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::Scope           , last::node::resolvable, last::node::compilable, last::node::binary_writable)
+SPECIALIZE_CREATE(last::node::If              , last::node::resolvable, last::node::binary_writable) /* compiled by Condition */
+SPECIALIZE_CREATE(last::node::Else            , last::node::resolvable, last::node::binary_writable) /* compiled by Condition */
+SPECIALIZE_CREATE(last::node::StringLiteral   , last::node::resolvable, last::node::binary_writable) /* compiled by Print     */
 
 //-----------------------------------------------------------------------------
 
@@ -349,20 +1064,124 @@ namespace interpreter
 using namespace last::node;
 
 export
-void interpret(std::filesystem::path const & ast_txt)
+enum class Engine
+{
+    TREE,     /* walks the tree. reference implementation */
+    BYTECODE, /* compiles the tree to bytecode and runs it in vm */
+};
+
+//-----------------------------------------------------------------------------
+
+void interpret_tree(BasicNode const & root, tiering::Options tiering, profile::Profiler* profiler)
+{
+    auto&& resolver = resolver::Resolver{tiering, profiler};
+    resolver.new_scope(); /* global scope */
+    auto&& resolved_root = [&]
+    {
+        auto&& timer = last::stats::Timer{"resolve"};
+        return resolve(root, resolver);
+    }();
+
+    auto&& nametable = nametable::Nametable{};
+    nametable.new_scope(resolver.frame_size(), resolver.array_frame_size()); /* global scope */
+    resolver.leave_scope();
+
+    auto&& timer = last::stats::Timer{"execution"};
+    execute_statement(resolved_root, nametable);
+}
+
+//-----------------------------------------------------------------------------
+
+void interpret_bytecode(BasicNode const & root)
+{
+    auto&& builder = bytecode::Builder{};
+    {
+        auto&& timer = last::stats::Timer{"bytecode generation"};
+        compile_statement(root, builder);
+    }
+
+    auto&& timer = last::stats::Timer{"execution"};
+    vm::run(std::move(builder).finish());
+}
+
+//-----------------------------------------------------------------------------
+
+void interpret(last::AST const & ast, Engine engine, tiering::Options tiering, profile::Profiler* profiler = nullptr)
 {
     LOGINFO("paracl: interpreter: start");
 
-    auto&& ast = last::read(ast_txt);
+    if (tiering.compiler and engine != Engine::TREE)
+        throw std::invalid_argument("loops compilation is supported only by tree engine");
+
+    if (profiler and (engine != Engine::TREE or tiering.compiler))
+        throw std::invalid_argument("profiling is supported only by tree engine without loops compilation");
 
-    nametable::Nametable nametable;
-    nametable.new_scope(); /* global scope */
+    switch (engine)
+    {
+        case Engine::TREE:     interpret_tree    (ast.root(), tiering, profiler); break;
+        case Engine::BYTECODE: interpret_bytecode(ast.root()); break;
+        default: __builtin_unreachable();
+    }
 
-    execute_statement(ast.root(), nametable);
+    io::output().flush();
 
     LOGINFO("paracl: interpreter: end");
 }
 
+//-----------------------------------------------------------------------------
+
+/* ast from file: text or binary format */
+export
+void interpret(std::filesystem::path const & ast_txt, Engine engine = Engine::TREE)
+{
+    interpret(last::read(ast_txt), engine, tiering::Options{});
+}
+
+//-----------------------------------------------------------------------------
+
+/* ast from frontend in the same process */
+export
+void interpret(last::binary::Image const & image, Engine engine = Engine::TREE)
+{
+    interpret(last::read(image), engine, tiering::Options{});
+}
+
+//-----------------------------------------------------------------------------
+
+/* tree, read with nodes of interpreter: paracl-bench measures reading of ast apart from execution */
+export
+last::AST load(last::binary::Image const & image)
+{
+    return last::read(image);
+}
+
+//-----------------------------------------------------------------------------
+
+/* ast, which is already read by load */
+export
+void interpret(last::AST const & ast, Engine engine = Engine::TREE)
+{
+    interpret(ast, engine, tiering::Options{});
+}
+
+//-----------------------------------------------------------------------------
+
+/* tree engine, which compiles hot loops with tiering.compiler */
+export
+void interpret(last::binary::Image const & image, tiering::Options tiering)
+{
+    interpret(last::read(image), Engine::TREE, tiering);
+}
+
+//-----------------------------------------------------------------------------
+
+/* tree engine, which measures every statement of the program (paracl --profile) */
+export
+void interpret(last::binary::Image const & image, profile::Profiler& profiler)
+{
+    interpret(last::read(image), Engine::TREE, tiering::Options{}, &profiler);
+}
+
 } /* namespace ParaCL::interpreter */
 
-//-----------------------------------------------------------------------------
\ No newline at end of file
+//-----------------------------------------------------------------------------
@@ -0,0 +1,199 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+#include <unistd.h>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module io;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace interpreter::io
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+export
+enum class Flush
+{
+    LINE, /* every print is written at once */
+    FULL, /* output is written by big blocks and at the end of program */
+    AUTO, /* LINE, if stdout is terminal, else FULL */
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+stdout of interpreter: integers are formatted with to_chars into own buffer, which is passed to stdio by big blocks.
+code compiled by tiering prints through paracl-rt, which passes its buffer to the same stdio stream,
+so buffer is drained before such code runs (see TieredWhile), and output keeps its order.
+*/
+export
+class Output
+{
+  private:
+    static constexpr size_t capacity = 1 << 16;
+
+    std::array<char, capacity> buffer_;
+    size_t size_ = 0;
+    bool line_buffered_ = false;
+
+  public:
+    Output() = default;
+    Output(Output const &) = delete;
+    Output& operator=(Output const &) = delete;
+    ~Output() { flush(); }
+
+  public:
+    void set_line_buffered(bool line_buffered) noexcept
+    { line_buffered_ = line_buffered; }
+
+    void write(int value)
+    {
+        if (capacity - size_ < std::numeric_limits<int>::digits10 + 2) drain();
+
+        auto&& [end, error] = std::to_chars(buffer_.data() + size_, buffer_.data() + capacity, value);
+        size_ = static_cast<size_t>(end - buffer_.data());
+    }
+
+    void write(std::string_view string)
+    {
+        if (capacity - size_ < string.size()) drain();
+
+        if (capacity < string.size())
+        {
+            std::fwrite(string.data(), 1, string.size(), stdout);
+            return;
+        }
+
+        std::memcpy(buffer_.data() + size_, string.data(), string.size());
+        size_ += string.size();
+    }
+
+    /* end of print statement */
+    void end_line()
+    {
+        if (size_ == capacity) drain();
+        buffer_[size_++] = '\n';
+
+        if (line_buffered_) flush();
+    }
+
+    /* buffer -> stdio. after it output of compiled code goes after everything printed by interpreter */
+    void drain()
+    {
+        std::fwrite(buffer_.data(), 1, size_, stdout);
+        size_ = 0;
+    }
+
+    /* buffer -> stdout file */
+    void flush()
+    {
+        drain();
+        std::fflush(stdout);
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+stdin of interpreter: integers are parsed by hand from stdio buffer of stdin.
+stdio reads the file by big blocks, and position in stream is shared with scanf of compiled loops.
+*/
+export
+class Input
+{
+  public:
+    int read_int()
+    {
+        auto&& symbol = getc_unlocked(stdin);
+
+        while (symbol == ' ' or symbol == '\n' or symbol == '\t' or symbol == '\r' or symbol == '\v' or symbol == '\f')
+            symbol = getc_unlocked(stdin);
+
+        if (symbol == EOF)
+            throw std::runtime_error("scan: unexpected end of input");
+
+        auto&& negative = (symbol == '-');
+        if (symbol == '-' or symbol == '+')
+            symbol = getc_unlocked(stdin);
+
+        if (symbol < '0' or '9' < symbol)
+            throw std::runtime_error("scan: expected integer");
+
+        /* accumulated as negative: |INT_MIN| doesn`t fit in int */
+        auto&& value = 0LL;
+        for (; '0' <= symbol and symbol <= '9'; symbol = getc_unlocked(stdin))
+        {
+            value = value * 10 - (symbol - '0');
+
+            if (value < std::numeric_limits<int>::min())
+                throw std::runtime_error("scan: integer is out of range");
+        }
+
+        if (symbol != EOF) std::ungetc(symbol, stdin);
+
+        if (not negative and -value > std::numeric_limits<int>::max())
+            throw std::runtime_error("scan: integer is out of range");
+
+        return static_cast<int>(negative ? value : -value);
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* streams of the process: one for tree interpreter, vm and tiering */
+export
+Output& output()
+{
+    static Output instance;
+    return instance;
+}
+
+export
+Input& input()
+{
+    static Input instance;
+    return instance;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+must be called before any input or output.
+stdio buffers are set too: they are used by code compiled with tiering and jit.
+returns true, if output is line buffered
+*/
+export
+bool configure(Flush flush)
+{
+    static constexpr size_t stdio_buffer_size = 1 << 16;
+
+    auto&& line_buffered = (flush == Flush::LINE) or (flush == Flush::AUTO and ::isatty(STDOUT_FILENO));
+
+    std::setvbuf(stdout, nullptr, line_buffered ? _IOLBF : _IOFBF, stdio_buffer_size);
+    std::setvbuf(stdin , nullptr, _IOFBF, stdio_buffer_size);
+
+    output().set_line_buffered(line_buffered);
+
+    LOGINFO("paracl: interpreter: io: stdout is {}", line_buffered ? "line buffered" : "fully buffered");
+    return line_buffered;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace interpreter::io */
+//---------------------------------------------------------------------------------------------------------------
@@ -1,9 +1,38 @@
 #warning "Using version with stupid ooptions parsing"
 
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
 import interpreter;
+import io;
+import thelast;
 
 int main(int argc, char* argv[])
 {
-    interpreter::interpret(argv[1]);
+    auto&& engine = interpreter::Engine::TREE;
+    auto&& flush  = interpreter::io::Flush::AUTO;
+
+    for (int it = 2; it < argc; ++it)
+    {
+        auto&& option = std::string_view{argv[it]};
+
+        if      (option == "--engine=tree")     engine = interpreter::Engine::TREE;
+        else if (option == "--engine=bytecode") engine = interpreter::Engine::BYTECODE;
+        else if (option == "--flush=line")      flush  = interpreter::io::Flush::LINE;
+        else if (option == "--flush=full")      flush  = interpreter::io::Flush::FULL;
+        else if (option == "--flush=auto")      flush  = interpreter::io::Flush::AUTO;
+        else
+        {
+            std::cerr << "Unknown option: " << option << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* --time-report, --stats and --time-trace of paracli --via-files come through environment */
+    last::stats::start("paracl-interpreter", {});
+
+    interpreter::io::configure(flush);
+    interpreter::interpret(argv[1], engine);
     return 0;
 }
@@ -2,10 +2,11 @@ module;
 
 //---------------------------------------------------------------------------------------------------------------
 
-#include <ranges>
+#include <cstddef>
+#include <optional>
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 #define LOGINFO(...)
@@ -17,32 +18,81 @@ export module nametable;
 
 //---------------------------------------------------------------------------------------------------------------
 
+import last_stats;
+
+//---------------------------------------------------------------------------------------------------------------
+
 namespace interpreter::nametable
 {
 
 //---------------------------------------------------------------------------------------------------------------
 
+/* place of variable in the value stack: scope depth and index of variable in this scope frame */
+export
+struct Slot
+{
+    size_t depth;
+    size_t slot;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* array errors read the same in every engine (and in compiled code, see paracl-rt) */
+export
+std::string out_of_range_message(std::string_view name, int index, size_t size)
+{
+    return "array index " + std::to_string(index) + " is out of range of '" + std::string(name) +
+           "' (size " + std::to_string(size) + ")";
+}
+
+export
+std::string negative_size_message(std::string_view name, int size)
+{
+    return "negative size of array '" + std::string(name) + "': " + std::to_string(size);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+runtime nametable.
+all variables are resolved to slots before execution (see resolver),
+so here is only flat value stack, which is reused by all scopes on the same depth
+and doesn`t allocate after the first pass through the deepest scope.
+arrays have their own stack: elements of every array are contiguous, they are freed on scope exit.
+array, which is not created yet, is empty: every access to it is out of range.
+*/
 export
 class Nametable final
 {
   private:
-    std::vector<std::unordered_map<std::string_view, int>> scopes_;
-  private:
-    int* lookup            (std::string_view name);
-    void declare           (std::string_view name, int value);
+    std::vector<std::optional<int>> values_;
+    std::vector<size_t> frames_; /* frames_[depth] = index of first frame slot in values_ */
+    std::vector<std::vector<int>> arrays_;
+    std::vector<size_t> array_frames_;
   public:
-    void new_scope         ();
+    void new_scope         (size_t frame_size, size_t array_frame_size = 0);
     void leave_scope       ();
-    void set_value         (std::string_view name, int value);
-    int  get_variable_value(std::string_view name) const;
+    void set_value         (Slot slot, int value);
+    int  get_variable_value(Slot slot, std::string_view name) const;
+    bool is_declared       (Slot slot) const;
+
+    void create_array      (Slot slot, int size, int value, std::string_view name);
+    int  get_element       (Slot slot, int index, std::string_view name) const;
+    void set_element       (Slot slot, int index, int value, std::string_view name);
+  private:
+    static size_t checked_index_(std::vector<int> const & array, int index, std::string_view name);
 };
 
 //---------------------------------------------------------------------------------------------------------------
 
-void Nametable::new_scope()
+void Nametable::new_scope(size_t frame_size, size_t array_frame_size)
 {
-    LOGINFO("paracl: interpreter: nametable: create next scope");
-    scopes_.emplace_back();
+    LOGINFO("paracl: interpreter: nametable: create next scope with {} slots", frame_size);
+    last::stats::count(last::stats::Counter::SCOPES_PUSHED);
+    frames_.push_back(values_.size());
+    values_.resize(values_.size() + frame_size); /* new slots are std::nullopt = not declared yet */
+    array_frames_.push_back(arrays_.size());
+    arrays_.resize(arrays_.size() + array_frame_size);
 }
 
 //---------------------------------------------------------------------------------------------------------------
@@ -51,74 +101,93 @@ void Nametable::leave_scope()
 {
     LOGINFO("paracl: interpreter: nametable: exiting scope");
 
-    if (scopes_.empty()) return;
-    scopes_.pop_back();
+    if (frames_.empty()) return;
+    values_.resize(frames_.back()); /* never shrinks capacity, so next scope will not allocate */
+    frames_.pop_back();
+    arrays_.resize(array_frames_.back()); /* elements are freed */
+    array_frames_.pop_back();
 }
 
 //---------------------------------------------------------------------------------------------------------------
 
-int Nametable::get_variable_value(std::string_view name) const
+int Nametable::get_variable_value(Slot slot, std::string_view name) const
 {
-    LOGINFO("paracl: interpreter: nametable: searching variable: \"{}\"", name);
+    LOGINFO("paracl: interpreter: nametable: get variable: \"{}\" ({}, {})", name, slot.depth, slot.slot);
+
+    auto&& value = values_[frames_[slot.depth] + slot.slot];
 
-    for (auto&& scope : scopes_ | std::views::reverse)
-    {
-        auto&& found = scope.find(name);
-        if (found == scope.end()) continue;
-        LOGINFO("paracl: interpreter: nametable: variable found: \"{}\" = {}", name, found->second);
-        return found->second;
-    }
+    if (value.has_value()) return *value;
 
-    LOGINFO("paracl: interpreter: nametable: variable NOT found: \"{}\"", name);
+    LOGINFO("paracl: interpreter: nametable: variable NOT declared: \"{}\"", name);
     throw std::runtime_error(std::string("requests value of not exists variable: ") + std::string(name));
 }
 
 //---------------------------------------------------------------------------------------------------------------
 
-void Nametable::set_value(std::string_view name, int value)
+bool Nametable::is_declared(Slot slot) const
 {
-    LOGINFO("paracl: interpreter: nametable: set {} to \"{}\"", value, name);
+    return values_[frames_[slot.depth] + slot.slot].has_value();
+}
 
-    if (scopes_.empty())
-        throw std::runtime_error("cannot set_value variable: no active scopes");
+//---------------------------------------------------------------------------------------------------------------
 
-    auto&& name_ptr = lookup(name);
+void Nametable::set_value(Slot slot, int value)
+{
+    LOGINFO("paracl: interpreter: nametable: set {} to ({}, {})", value, slot.depth, slot.slot);
 
-    if (not name_ptr) return declare(name, value);
+    if (frames_.size() <= slot.depth)
+        throw std::runtime_error("cannot set_value variable: no active scope on this depth");
 
-    LOGINFO("paracl: interpreter: nametable: set {} to \"{}\"", value, name);
-    *name_ptr = value;
+    values_[frames_[slot.depth] + slot.slot] = value;
 }
 
-// private
-//---------------------------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------------------------
+
+/* array is created again on every execution of its declaration */
+void Nametable::create_array(Slot slot, int size, int value, std::string_view name)
+{
+    LOGINFO("paracl: interpreter: nametable: create array \"{}\" of {} elements ({}, {})", name, size, slot.depth, slot.slot);
+
+    if (size < 0)
+        throw std::runtime_error(negative_size_message(name, size));
+
+    if (array_frames_.size() <= slot.depth)
+        throw std::runtime_error("cannot create array: no active scope on this depth");
+
+    arrays_[array_frames_[slot.depth] + slot.slot].assign(static_cast<size_t>(size), value);
+}
+
 //---------------------------------------------------------------------------------------------------------------
 
-int *Nametable::lookup(std::string_view name)
+size_t Nametable::checked_index_(std::vector<int> const & array, int index, std::string_view name)
 {
-    for (auto &&scope: scopes_ | std::views::reverse)
-    {
-        auto&& found = scope.find(name);
-        if (found == scope.end()) continue;
-        return &(found->second);
-    }
-
-    return nullptr;
+    /* negative index is a huge unsigned one: one comparison checks both bounds */
+    auto&& unsigned_index = static_cast<size_t>(static_cast<unsigned>(index));
+
+    if (unsigned_index >= array.size())
+        throw std::runtime_error(out_of_range_message(name, index, array.size()));
+
+    return unsigned_index;
 }
 
 //---------------------------------------------------------------------------------------------------------------
 
-void Nametable::declare(std::string_view name, int value)
+int Nametable::get_element(Slot slot, int index, std::string_view name) const
 {
-    LOGINFO("paracl: interpreter: nametable: declate {} = \"{}\"", name, value);
+    LOGINFO("paracl: interpreter: nametable: get element {} of \"{}\" ({}, {})", index, name, slot.depth, slot.slot);
+    auto&& array = arrays_[array_frames_[slot.depth] + slot.slot];
+    return array[checked_index_(array, index, name)];
+}
 
-    if (scopes_.empty())
-        throw std::runtime_error("cannot declare variable: no active scopes");
+//---------------------------------------------------------------------------------------------------------------
 
-    scopes_.back()[name] = value;
+void Nametable::set_element(Slot slot, int index, int value, std::string_view name)
+{
+    LOGINFO("paracl: interpreter: nametable: set element {} of \"{}\" to {}", index, name, value);
+    auto&& array = arrays_[array_frames_[slot.depth] + slot.slot];
+    array[checked_index_(array, index, name)] = value;
 }
 
 //---------------------------------------------------------------------------------------------------------------
-} /* namespace ParaCL::backend::interpreter::nametable */
+} /* namespace interpreter::nametable */
 //---------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,223 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module profile;
+
+//---------------------------------------------------------------------------------------------------------------
+
+import thelast;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace interpreter::profile
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* one statement of the program (or one while with its body) */
+export
+struct Counter
+{
+    last::node::Location     location;
+    bool                     loop       = false;
+    size_t                   executions = 0;
+    size_t                   iterations = 0; /* only for loops */
+    std::chrono::nanoseconds total      {0};
+    std::chrono::nanoseconds children   {0}; /* time of statements, nested in this one */
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+counters of paracl --profile. resolver creates counter for every statement,
+and nodes of resolved tree measure their execution.
+*/
+export
+class Profiler final
+{
+  private:
+    using clock = std::chrono::steady_clock;
+
+    std::deque<Counter> counters_; /* deque: nodes keep addresses of counters */
+    Counter* current_ = nullptr;   /* statement, which is being executed */
+
+  public:
+    /* time of one execution of statement: it`s added to the statement and to the enclosing one */
+    class Measure final
+    {
+      private:
+        Profiler& profiler_;
+        Counter& counter_;
+        Counter* parent_;
+        clock::time_point start_;
+      public:
+        Measure(Profiler& profiler, Counter& counter) :
+        profiler_(profiler), counter_(counter), parent_(profiler.current_), start_(clock::now())
+        {
+            ++counter_.executions;
+            profiler_.current_ = &counter_;
+        }
+
+        Measure(Measure const &) = delete;
+        Measure& operator=(Measure const &) = delete;
+
+        ~Measure()
+        {
+            auto&& elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_);
+
+            counter_.total += elapsed;
+            if (parent_) parent_->children += elapsed;
+
+            profiler_.current_ = parent_;
+        }
+    };
+
+  public:
+    Counter& add(last::node::Location const & location, bool loop)
+    {
+        LOGINFO("paracl: interpreter: profile: counter for {}:{}", location.begin.line, location.begin.column);
+        return counters_.emplace_back(Counter{.location = location, .loop = loop});
+    }
+
+    /* the hottest statements: sorted by total time, with the lines of source */
+    void report(std::ostream& out, std::filesystem::path const & source, size_t limit = 20) const;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::vector<std::string> read_lines(std::filesystem::path const & source)
+{
+    auto&& file  = std::ifstream{source};
+    auto&& lines = std::vector<std::string>{};
+
+    for (auto&& line = std::string{}; std::getline(file, line);)
+        lines.push_back(std::move(line));
+
+    return lines;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* line of statement without indentation. empty, if source was changed or location is unknown */
+std::string source_line(std::vector<std::string> const & lines, last::node::Location const & location)
+{
+    static constexpr size_t max_width = 60;
+
+    if (location.empty() or location.begin.line > lines.size()) return "";
+
+    auto&& line  = lines[location.begin.line - 1];
+    auto&& first = line.find_first_not_of(" \t");
+    if (first == std::string::npos) return "";
+
+    auto&& text = line.substr(first, max_width);
+    return (line.size() - first > max_width) ? text + "..." : text;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Profiler::report(std::ostream& out, std::filesystem::path const & source, size_t limit) const
+{
+    auto&& hottest = std::vector<Counter const *>{};
+    for (auto&& counter : counters_)
+        if (counter.executions != 0) hottest.push_back(&counter);
+
+    std::ranges::stable_sort(hottest, [](auto&& lhs, auto&& rhs) { return lhs->total > rhs->total; });
+    if (hottest.size() > limit) hottest.resize(limit);
+
+    auto&& lines = read_lines(source);
+    auto&& ms = [](std::chrono::nanoseconds time) { return std::chrono::duration<double, std::milli>(time).count(); };
+
+    out << "paracl: profile of " << source.string() << " (" << hottest.size() << " hottest statements)\n"
+        << std::setw(12) << "total ms" << std::setw(12) << "self ms" << std::setw(12) << "executions"
+        << std::setw(12) << "iterations" << "  " << std::left << std::setw(10) << "line:col" << std::right << "source\n";
+
+    for (auto&& counter : hottest)
+    {
+        auto&& position = counter->location.empty()
+                        ? std::string{"?"}
+                        : std::to_string(counter->location.begin.line) + ":" + std::to_string(counter->location.begin.column);
+
+        out << std::fixed << std::setprecision(3)
+            << std::setw(12) << ms(counter->total) << std::setw(12) << ms(counter->total - counter->children)
+            << std::setw(12) << counter->executions;
+
+        if (counter->loop) out << std::setw(12) << counter->iterations;
+        else               out << std::setw(12) << "-";
+
+        out << "  " << std::left << std::setw(10) << position << std::right << source_line(lines, counter->location) << "\n";
+    }
+
+    out << std::defaultfloat;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace interpreter::profile */
+//---------------------------------------------------------------------------------------------------------------
+
+namespace interpreter::profile::nodes
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* statement of resolved tree, which execution is measured */
+export
+class Profiled final
+{
+  private:
+    last::node::BasicNode statement_;
+    Counter* counter_;
+    Profiler* profiler_;
+  public:
+    Profiled(last::node::BasicNode&& statement, Counter& counter, Profiler& profiler) :
+    statement_(std::move(statement)), counter_(&counter), profiler_(&profiler)
+    {}
+  public:
+    last::node::BasicNode const & statement() const & noexcept
+    { return statement_; }
+
+    Profiler::Measure measure() const
+    { return Profiler::Measure{*profiler_, *counter_}; }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* body of profiled while: counts iterations of the loop */
+export
+class Iteration final
+{
+  private:
+    last::node::BasicNode body_;
+    Counter* counter_;
+  public:
+    Iteration(last::node::BasicNode&& body, Counter& counter) :
+    body_(std::move(body)), counter_(&counter)
+    {}
+  public:
+    last::node::BasicNode const & body() const & noexcept
+    { return body_; }
+
+    void count() const noexcept
+    { ++counter_->iterations; }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace interpreter::profile::nodes */
+//---------------------------------------------------------------------------------------------------------------
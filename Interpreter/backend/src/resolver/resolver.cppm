@@ -0,0 +1,413 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module resolver;
+
+//---------------------------------------------------------------------------------------------------------------
+
+export import nametable;
+export import tiering;
+export import profile;
+import thelast;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace interpreter::resolver
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+nametable, which works before execution.
+it does the same lookups as runtime nametable did, but only once per variable in source,
+and gives every variable a slot in scope frame.
+*/
+export
+class Resolver final
+{
+  private:
+    /* loop, which is being resolved: variables from scopes up to depth are captured by it */
+    struct Loop
+    {
+        size_t depth;
+        std::vector<tiering::Capture> captures;
+        bool arrays = false; /* uses arrays from scopes up to depth: they can`t be passed in frame */
+    };
+
+    using ScopeT = std::unordered_map<last::node::Symbol, size_t, last::node::SymbolHash>;
+
+    std::vector<ScopeT> scopes_;
+    std::vector<ScopeT> array_scopes_; /* arrays have their own slots: Nametable keeps them apart from values */
+    std::vector<Loop> loops_;
+    tiering::Options tiering_;
+    profile::Profiler* profiler_ = nullptr;
+  public:
+    Resolver() = default;
+    explicit Resolver(tiering::Options tiering, profile::Profiler* profiler = nullptr) :
+    tiering_(tiering), profiler_(profiler)
+    {}
+  public:
+    void new_scope      ();
+    void leave_scope    ();
+    size_t frame_size   () const;
+    size_t array_frame_size() const;
+    std::optional<nametable::Slot> lookup                 (last::node::Symbol name);
+    nametable::Slot                lookup_or_declare      (last::node::Symbol name);
+    std::optional<nametable::Slot> lookup_array           (last::node::Symbol name);
+    nametable::Slot                lookup_or_declare_array(last::node::Symbol name);
+
+    tiering::Options const & tiering() const noexcept
+    { return tiering_; }
+
+    /* not null, if statements of resolved tree must be profiled */
+    profile::Profiler* profiler() const noexcept
+    { return profiler_; }
+
+    /*
+    between begin_loop and end_loop resolver collects variables, which live outside of the loop.
+    std::nullopt - loop uses outer arrays, so it can`t be compiled
+    */
+    void                                         begin_loop();
+    std::optional<std::vector<tiering::Capture>> end_loop  ();
+  private:
+    void capture_      (last::node::Symbol name, nametable::Slot slot);
+    void capture_array_(nametable::Slot slot);
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Resolver::new_scope()
+{
+    LOGINFO("paracl: interpreter: resolver: create next scope");
+    last::stats::count(last::stats::Counter::SCOPES_PUSHED);
+    scopes_.emplace_back();
+    array_scopes_.emplace_back();
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Resolver::leave_scope()
+{
+    LOGINFO("paracl: interpreter: resolver: exiting scope");
+
+    if (scopes_.empty()) return;
+    scopes_.pop_back();
+    array_scopes_.pop_back();
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+size_t Resolver::frame_size() const
+{
+    if (scopes_.empty())
+        throw std::runtime_error("cannot get frame size: no active scopes");
+
+    return scopes_.back().size();
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+size_t Resolver::array_frame_size() const
+{
+    if (array_scopes_.empty())
+        throw std::runtime_error("cannot get array frame size: no active scopes");
+
+    return array_scopes_.back().size();
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::optional<nametable::Slot> Resolver::lookup(last::node::Symbol name)
+{
+    LOGINFO("paracl: interpreter: resolver: searching variable: \"{}\"", name);
+    last::stats::count(last::stats::Counter::NAMETABLE_LOOKUPS);
+
+    for (auto&& depth = scopes_.size(); depth != 0; --depth)
+    {
+        auto&& scope = scopes_[depth - 1];
+        auto&& found = scope.find(name);
+        if (found == scope.end()) continue;
+
+        auto&& slot = nametable::Slot{.depth = depth - 1, .slot = found->second};
+        capture_(name, slot);
+        return slot;
+    }
+
+    LOGINFO("paracl: interpreter: resolver: variable NOT found: \"{}\"", name);
+    return std::nullopt;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+nametable::Slot Resolver::lookup_or_declare(last::node::Symbol name)
+{
+    if (auto&& found = lookup(name); found.has_value())
+        return *found;
+
+    if (scopes_.empty())
+        throw std::runtime_error("cannot declare variable: no active scopes");
+
+    LOGINFO("paracl: interpreter: resolver: declare \"{}\"", name);
+
+    auto&& scope = scopes_.back();
+    auto&& slot = nametable::Slot{.depth = scopes_.size() - 1, .slot = scope.size()};
+    scope.emplace(name, slot.slot);
+
+    /* declared in the scope of loop (by condition or body without braces), so it lives outside of the loop */
+    capture_(name, slot);
+
+    return slot;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::optional<nametable::Slot> Resolver::lookup_array(last::node::Symbol name)
+{
+    LOGINFO("paracl: interpreter: resolver: searching array: \"{}\"", name);
+    last::stats::count(last::stats::Counter::NAMETABLE_LOOKUPS);
+
+    for (auto&& depth = array_scopes_.size(); depth != 0; --depth)
+    {
+        auto&& scope = array_scopes_[depth - 1];
+        auto&& found = scope.find(name);
+        if (found == scope.end()) continue;
+
+        auto&& slot = nametable::Slot{.depth = depth - 1, .slot = found->second};
+        capture_array_(slot);
+        return slot;
+    }
+
+    LOGINFO("paracl: interpreter: resolver: array NOT found: \"{}\"", name);
+    return std::nullopt;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+nametable::Slot Resolver::lookup_or_declare_array(last::node::Symbol name)
+{
+    if (auto&& found = lookup_array(name); found.has_value())
+        return *found;
+
+    if (array_scopes_.empty())
+        throw std::runtime_error("cannot declare array: no active scopes");
+
+    LOGINFO("paracl: interpreter: resolver: declare array \"{}\"", name);
+
+    auto&& scope = array_scopes_.back();
+    auto&& slot = nametable::Slot{.depth = array_scopes_.size() - 1, .slot = scope.size()};
+    scope.emplace(name, slot.slot);
+
+    capture_array_(slot);
+
+    return slot;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Resolver::begin_loop()
+{
+    if (scopes_.empty())
+        throw std::runtime_error("cannot begin loop: no active scopes");
+
+    loops_.push_back(Loop{.depth = scopes_.size() - 1, .captures = {}});
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+std::optional<std::vector<tiering::Capture>> Resolver::end_loop()
+{
+    if (loops_.empty())
+        throw std::runtime_error("cannot end loop: no active loops");
+
+    auto&& loop = Loop{std::move(loops_.back())};
+    loops_.pop_back();
+
+    if (loop.arrays) return std::nullopt;
+    return std::move(loop.captures);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Resolver::capture_(last::node::Symbol name, nametable::Slot slot)
+{
+    for (auto&& loop : loops_)
+    {
+        if (slot.depth > loop.depth) continue;
+
+        auto&& captured = std::ranges::any_of(loop.captures, [slot](auto&& capture)
+        { return capture.slot.depth == slot.depth and capture.slot.slot == slot.slot; });
+
+        if (not captured)
+            loop.captures.push_back(tiering::Capture{.name = name.name(), .slot = slot});
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void Resolver::capture_array_(nametable::Slot slot)
+{
+    for (auto&& loop : loops_)
+        if (slot.depth <= loop.depth) loop.arrays = true;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace interpreter::resolver */
+//---------------------------------------------------------------------------------------------------------------
+
+namespace interpreter::resolver::nodes
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* Variable, bound to its slot. name is kept only for error messages (symbol table of ast outlives resolved tree) */
+export
+class ResolvedVariable final
+{
+  private:
+    nametable::Slot slot_;
+    last::node::Symbol name_;
+  public:
+    ResolvedVariable(nametable::Slot slot, last::node::Symbol name) noexcept :
+    slot_(slot), name_(name)
+    {}
+  public:
+    nametable::Slot slot() const noexcept
+    { return slot_; }
+
+    std::string_view name() const & noexcept
+    { return name_.name(); }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* ArrayDeclaration, bound to its array slot */
+export
+class ResolvedArrayDeclaration final
+{
+  private:
+    nametable::Slot slot_;
+    last::node::Symbol name_;
+    last::node::BasicNode value_;
+    last::node::BasicNode size_;
+  public:
+    ResolvedArrayDeclaration(nametable::Slot slot, last::node::Symbol name,
+                             last::node::BasicNode&& value, last::node::BasicNode&& size) :
+    slot_(slot), name_(name), value_(std::move(value)), size_(std::move(size))
+    {}
+  public:
+    nametable::Slot slot() const noexcept
+    { return slot_; }
+
+    std::string_view name() const & noexcept
+    { return name_.name(); }
+
+    last::node::BasicNode const & value() const & noexcept
+    { return value_; }
+
+    last::node::BasicNode const & size() const & noexcept
+    { return size_; }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* ArrayElement, bound to its array slot */
+export
+class ResolvedArrayElement final
+{
+  private:
+    nametable::Slot slot_;
+    last::node::Symbol name_;
+    last::node::BasicNode index_;
+  public:
+    ResolvedArrayElement(nametable::Slot slot, last::node::Symbol name, last::node::BasicNode&& index) :
+    slot_(slot), name_(name), index_(std::move(index))
+    {}
+  public:
+    nametable::Slot slot() const noexcept
+    { return slot_; }
+
+    std::string_view name() const & noexcept
+    { return name_.name(); }
+
+    last::node::BasicNode const & index() const & noexcept
+    { return index_; }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* ArrayAssignment, bound to its array slot */
+export
+class ResolvedArrayAssignment final
+{
+  private:
+    nametable::Slot slot_;
+    last::node::Symbol name_;
+    last::node::BasicNode index_;
+    last::node::BasicNode value_;
+    last::node::BinaryOperator::BinaryOperatorT type_;
+  public:
+    ResolvedArrayAssignment(last::node::BinaryOperator::BinaryOperatorT type, nametable::Slot slot, last::node::Symbol name,
+                            last::node::BasicNode&& index, last::node::BasicNode&& value) :
+    slot_(slot), name_(name), index_(std::move(index)), value_(std::move(value)), type_(type)
+    {}
+  public:
+    last::node::BinaryOperator::BinaryOperatorT type() const noexcept
+    { return type_; }
+
+    nametable::Slot slot() const noexcept
+    { return slot_; }
+
+    std::string_view name() const & noexcept
+    { return name_.name(); }
+
+    last::node::BasicNode const & index() const & noexcept
+    { return index_; }
+
+    last::node::BasicNode const & value() const & noexcept
+    { return value_; }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* Scope, which knows how many slots it needs in value stack (and how many arrays it declares) */
+export
+class ResolvedScope final : private std::vector<last::node::BasicNode>
+{
+  private:
+    size_t frame_size_;
+    size_t array_frame_size_;
+  public:
+    using std::vector<last::node::BasicNode>::begin;
+    using std::vector<last::node::BasicNode>::end;
+    using std::vector<last::node::BasicNode>::size;
+  public:
+    ResolvedScope(size_t frame_size, size_t array_frame_size, std::vector<last::node::BasicNode>&& statements) :
+    std::vector<last::node::BasicNode>(std::move(statements)), frame_size_(frame_size), array_frame_size_(array_frame_size)
+    {}
+  public:
+    size_t frame_size() const noexcept
+    { return frame_size_; }
+
+    size_t array_frame_size() const noexcept
+    { return array_frame_size_; }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace interpreter::resolver::nodes */
+//---------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,185 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <exception>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module tiering;
+
+//---------------------------------------------------------------------------------------------------------------
+
+export import nametable;
+import io;
+import thelast;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace interpreter::tiering
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* native code of the whole loop. values of captured variables are passed in frame, in order of captures */
+export
+using CompiledLoop = void (*)(int* frame);
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+compiles loops, which became hot, to native code.
+interpreter doesn`t depend on the compiler, implementation is given by the caller (paracl --tiered).
+loop is passed in binary ast format: its root is While.
+*/
+export
+class LoopCompiler
+{
+  public:
+    virtual ~LoopCompiler() = default;
+    virtual CompiledLoop compile(last::binary::Image const & loop, std::vector<std::string_view> const & captures) = 0;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* without compiler loops are only interpreted */
+export
+struct Options
+{
+    LoopCompiler* compiler  = nullptr;
+    size_t        threshold = 1000; /* iterations of one loop (in all its executions) before compilation */
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* variable, which is used in loop, but lives outside of it */
+export
+struct Capture
+{
+    std::string_view name;
+    nametable::Slot  slot;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+While of resolved tree, which counts its iterations.
+when the loop became hot, it is compiled from the parsed tree (source) and the next iterations run natively.
+*/
+export
+class TieredWhile final
+{
+  private:
+    last::node::BasicNode condition_;
+    last::node::BasicNode body_;
+    last::node::While const * source_;
+    std::vector<Capture> captures_;
+    Options options_;
+
+    mutable size_t iterations_ = 0;
+    mutable CompiledLoop compiled_ = nullptr;
+    mutable bool failed_ = false;
+
+  public:
+    TieredWhile(last::node::BasicNode&& condition, last::node::BasicNode&& body,
+                last::node::While const & source, std::vector<Capture>&& captures, Options options) :
+    condition_(std::move(condition)), body_(std::move(body)), source_(&source),
+    captures_(std::move(captures)), options_(options)
+    {}
+
+  public:
+    last::node::BasicNode const & condition() const & noexcept
+    { return condition_; }
+
+    last::node::BasicNode const & body() const & noexcept
+    { return body_; }
+
+    /* runs the rest of the loop natively, if it`s compiled. false - loop must be interpreted */
+    bool run_compiled(nametable::Nametable& nametable) const;
+
+    /* called after every interpreted iteration. true - the rest of the loop was executed natively */
+    bool tier_up(nametable::Nametable& nametable) const;
+
+  private:
+    void compile_() const;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+bool TieredWhile::run_compiled(nametable::Nametable& nametable) const
+{
+    if (not compiled_) return false;
+
+    /* native code has no 'not declared' state: such loop is interpreted until its variables are set */
+    for (auto&& capture : captures_)
+        if (not nametable.is_declared(capture.slot)) return false;
+
+    auto&& frame = std::vector<int>{};
+    frame.reserve(captures_.size());
+
+    for (auto&& capture : captures_)
+        frame.push_back(nametable.get_variable_value(capture.slot, capture.name));
+
+    /* compiled code prints through stdio too: everything printed by interpreter must be before it */
+    io::output().drain();
+    compiled_(frame.data());
+
+    for (size_t it = 0; it < captures_.size(); ++it)
+        nametable.set_value(captures_[it].slot, frame[it]);
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+bool TieredWhile::tier_up(nametable::Nametable& nametable) const
+{
+    if (not compiled_)
+    {
+        if (failed_ or ++iterations_ < options_.threshold) return false;
+        compile_();
+    }
+
+    return run_compiled(nametable);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void TieredWhile::compile_() const
+{
+    LOGINFO("paracl: interpreter: tiering: loop is hot after {} iterations, compiling", iterations_);
+
+    /* children of parsed loop are copied, only to serialize it as one tree */
+    auto&& loop = last::node::BasicNode::Actions<last::node::binary_writable>::create(
+        last::node::While{source_->condition(), source_->body()}
+    );
+
+    auto&& names = std::vector<std::string_view>{};
+    names.reserve(captures_.size());
+    for (auto&& capture : captures_)
+        names.push_back(capture.name);
+
+    try
+    {
+        compiled_ = options_.compiler->compile(last::binary::Image{last::write_binary(loop)}, names);
+    }
+    catch (std::exception const & e)
+    {
+        /* loop stays in interpreter: it`s slower, but still correct */
+        LOGERR("paracl: interpreter: tiering: failed to compile loop: {}", e.what());
+        compiled_ = nullptr;
+    }
+
+    failed_ = (compiled_ == nullptr);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace interpreter::tiering */
+//---------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,298 @@
+module;
+
+//---------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define LOGINFO(...)
+#define LOGERR(...)
+
+/* computed goto is gnu extension. with other compilers we use switch dispatch */
+#if defined(__GNUC__) or defined(__clang__)
+#define PARACL_VM_THREADED_DISPATCH
+#endif /* defined(__GNUC__) or defined(__clang__) */
+
+//---------------------------------------------------------------------------------------------------------------
+
+export module vm;
+
+//---------------------------------------------------------------------------------------------------------------
+
+import bytecode;
+import nametable;
+import io;
+
+//---------------------------------------------------------------------------------------------------------------
+
+namespace interpreter::vm
+{
+
+//---------------------------------------------------------------------------------------------------------------
+
+export
+void run(bytecode::Program const & program)
+{
+    using bytecode::Opcode;
+
+    LOGINFO("paracl: interpreter: vm: start");
+
+    auto&& values   = std::vector<int>(program.slot_names.size());
+    auto&& declared = std::vector<unsigned char>(program.slot_names.size());
+    auto&& arrays   = std::vector<std::vector<int>>(program.array_names.size());
+    auto&& stack    = std::vector<int>(program.max_stack_depth + 1);
+    auto&& output   = io::output();
+
+    auto* ip = program.code.data();
+    auto* sp = stack.data(); /* stack[0] is never used: sp points to top of stack */
+
+#if defined(PARACL_VM_THREADED_DISPATCH)
+
+    /* in order of bytecode::Opcode */
+    static void* const dispatch_table[] =
+    {
+        &&NOP          ,
+        &&PUSH         ,
+        &&POP          ,
+        &&DUP          ,
+        &&LOAD         ,
+        &&LOAD_CHECKED ,
+        &&STORE        ,
+        &&STORE_DECLARE,
+        &&NEG          ,
+        &&NOT          ,
+        &&ADD          ,
+        &&SUB          ,
+        &&MUL          ,
+        &&DIV          ,
+        &&REM          ,
+        &&ISAB         ,
+        &&ISABE        ,
+        &&ISLS         ,
+        &&ISLSE        ,
+        &&ISEQ         ,
+        &&ISNE         ,
+        &&JMP          ,
+        &&JZ           ,
+        &&JNZ          ,
+        &&ENTER        ,
+        &&NEW_ARRAY    ,
+        &&LOAD_ELEMENT ,
+        &&STORE_ELEMENT,
+        &&FREE_ARRAY   ,
+        &&SCAN         ,
+        &&PRINT_INT    ,
+        &&PRINT_STR    ,
+        &&PRINT_END    ,
+        &&HALT         ,
+    };
+
+    static_assert(std::size(dispatch_table) == static_cast<size_t>(Opcode::OPCODES_COUNT),
+                  "every opcode must have its label in dispatch table");
+
+#define VM_CASE(opcode) opcode
+#define VM_NEXT()       goto *dispatch_table[static_cast<size_t>(ip->opcode)]
+
+    VM_NEXT();
+
+#else /* defined(PARACL_VM_THREADED_DISPATCH) */
+
+#define VM_CASE(opcode) case Opcode::opcode
+#define VM_NEXT()       continue
+
+    for (;;)
+    switch (ip->opcode)
+    {
+
+#endif /* defined(PARACL_VM_THREADED_DISPATCH) */
+
+    VM_CASE(NOP):
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(PUSH):
+        *++sp = ip->operand;
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(POP):
+        --sp;
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(DUP):
+        sp[1] = sp[0];
+        ++sp;
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(LOAD):
+        *++sp = values[ip->operand];
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(LOAD_CHECKED):
+        if (not declared[ip->operand])
+            throw std::runtime_error(std::string("requests value of not exists variable: ") + program.slot_names[ip->operand]);
+        *++sp = values[ip->operand];
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(STORE):
+        values[ip->operand] = *sp--;
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(STORE_DECLARE):
+        values[ip->operand] = *sp--;
+        declared[ip->operand] = true;
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(NEG):
+        *sp = -*sp;
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(NOT):
+        *sp = !*sp;
+        ++ip;
+        VM_NEXT();
+
+#define VM_BINARY_OPERATOR(opcode, expression)  \
+    VM_CASE(opcode):                            \
+    {                                           \
+        auto&& right = *sp--;                   \
+        auto&& left  = *sp;                     \
+        *sp = (expression);                     \
+        ++ip;                                   \
+        VM_NEXT();                              \
+    }
+
+    VM_BINARY_OPERATOR(ADD  , left +  right)
+    VM_BINARY_OPERATOR(SUB  , left -  right)
+    VM_BINARY_OPERATOR(MUL  , left *  right)
+    VM_BINARY_OPERATOR(DIV  , left /  right)
+    VM_BINARY_OPERATOR(REM  , left %  right)
+    VM_BINARY_OPERATOR(ISAB , left >  right)
+    VM_BINARY_OPERATOR(ISABE, left >= right)
+    VM_BINARY_OPERATOR(ISLS , left <  right)
+    VM_BINARY_OPERATOR(ISLSE, left <= right)
+    VM_BINARY_OPERATOR(ISEQ , left == right)
+    VM_BINARY_OPERATOR(ISNE , left != right)
+
+#undef VM_BINARY_OPERATOR
+
+    VM_CASE(JMP):
+        ip = program.code.data() + ip->operand;
+        VM_NEXT();
+
+    VM_CASE(JZ):
+        if (*sp-- == 0)
+            ip = program.code.data() + ip->operand;
+        else
+            ++ip;
+        VM_NEXT();
+
+    VM_CASE(JNZ):
+        if (*sp-- != 0)
+            ip = program.code.data() + ip->operand;
+        else
+            ++ip;
+        VM_NEXT();
+
+    VM_CASE(ENTER):
+    {
+        auto&& frame = program.frames[ip->operand];
+        std::fill_n(declared.begin() + frame.first_slot, frame.size, false);
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_CASE(NEW_ARRAY):
+    {
+        auto&& size  = *sp--;
+        auto&& value = *sp--;
+        if (size < 0)
+            throw std::runtime_error(nametable::negative_size_message(program.array_names[ip->operand], size));
+        arrays[ip->operand].assign(static_cast<size_t>(size), value);
+        ++ip;
+        VM_NEXT();
+    }
+
+    /* negative index is a huge unsigned one: one comparison checks both bounds */
+#define VM_CHECK_INDEX(array, index)                                                                              \
+    if (static_cast<size_t>(static_cast<unsigned>(index)) >= (array).size())                                      \
+        throw std::runtime_error(nametable::out_of_range_message(program.array_names[ip->operand], (index), (array).size()))
+
+    VM_CASE(LOAD_ELEMENT):
+    {
+        auto&& array = arrays[ip->operand];
+        VM_CHECK_INDEX(array, *sp);
+        *sp = array[static_cast<size_t>(*sp)];
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_CASE(STORE_ELEMENT):
+    {
+        auto&& array = arrays[ip->operand];
+        auto&& value = *sp--;
+        auto&& index = *sp--;
+        VM_CHECK_INDEX(array, index);
+        array[static_cast<size_t>(index)] = value;
+        ++ip;
+        VM_NEXT();
+    }
+
+#undef VM_CHECK_INDEX
+
+    VM_CASE(FREE_ARRAY):
+        arrays[ip->operand] = std::vector<int>{};
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(SCAN):
+    {
+        auto&& value = io::input().read_int();
+        LOGINFO("paracl: interpreter: vm: scan value: {}", value);
+        *++sp = value;
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_CASE(PRINT_INT):
+        output.write(*sp--);
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(PRINT_STR):
+        output.write(program.strings[ip->operand]);
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(PRINT_END):
+        output.end_line();
+        ++ip;
+        VM_NEXT();
+
+    VM_CASE(HALT):
+        LOGINFO("paracl: interpreter: vm: end");
+        return;
+
+#if not defined(PARACL_VM_THREADED_DISPATCH)
+        default: throw std::runtime_error("unknown bytecode instruction");
+    }
+#endif /* not defined(PARACL_VM_THREADED_DISPATCH) */
+
+#undef VM_CASE
+#undef VM_NEXT
+}
+
+//---------------------------------------------------------------------------------------------------------------
+} /* namespace interpreter::vm */
+//---------------------------------------------------------------------------------------------------------------
@@ -29,6 +29,8 @@ file(CHMOD ${PYTHON_RUN_TEST_SCRIPT}
 # =================================================================================================
 
 # creating run_test from run_test.in
+set(PARACL_E2E_OPTIONS "")
+
 configure_file(
     ${RUN_TEST_SCRIPT_IN}
     ${E2E_OUTPUT_SCRIPT}
@@ -41,3 +43,67 @@ file(CHMOD ${E2E_OUTPUT_SCRIPT}
 )
 
 # =================================================================================================
+
+# the same tests with bytecode engine
+set(E2E_BYTECODE_OUTPUT_SCRIPT    ${PROJECT_BINARY_DIR}/rt-bytecode)
+set(PARACL_E2E_OPTIONS "--engine=bytecode")
+
+configure_file(
+    ${RUN_TEST_SCRIPT_IN}
+    ${E2E_BYTECODE_OUTPUT_SCRIPT}
+    @ONLY
+)
+
+file(CHMOD ${E2E_BYTECODE_OUTPUT_SCRIPT}
+    PERMISSIONS OWNER_READ OWNER_WRITE OWNER_EXECUTE
+)
+
+# =================================================================================================
+
+# the same tests with llvm jit
+set(E2E_JIT_OUTPUT_SCRIPT         ${PROJECT_BINARY_DIR}/rt-jit)
+set(PARACL_E2E_OPTIONS "--jit")
+
+configure_file(
+    ${RUN_TEST_SCRIPT_IN}
+    ${E2E_JIT_OUTPUT_SCRIPT}
+    @ONLY
+)
+
+file(CHMOD ${E2E_JIT_OUTPUT_SCRIPT}
+    PERMISSIONS OWNER_READ OWNER_WRITE OWNER_EXECUTE
+)
+
+# =================================================================================================
+
+# the same tests with tiered execution: small threshold, so loops of tests are really compiled
+set(E2E_TIERED_OUTPUT_SCRIPT      ${PROJECT_BINARY_DIR}/rt-tiered)
+set(PARACL_E2E_OPTIONS "--tiered=2")
+
+configure_file(
+    ${RUN_TEST_SCRIPT_IN}
+    ${E2E_TIERED_OUTPUT_SCRIPT}
+    @ONLY
+)
+
+file(CHMOD ${E2E_TIERED_OUTPUT_SCRIPT}
+    PERMISSIONS OWNER_READ OWNER_WRITE OWNER_EXECUTE
+)
+
+# =================================================================================================
+
+# the same tests without ast optimizer: tree as it is written
+set(E2E_O0_OUTPUT_SCRIPT          ${PROJECT_BINARY_DIR}/rt-O0)
+set(PARACL_E2E_OPTIONS "-O0")
+
+configure_file(
+    ${RUN_TEST_SCRIPT_IN}
+    ${E2E_O0_OUTPUT_SCRIPT}
+    @ONLY
+)
+
+file(CHMOD ${E2E_O0_OUTPUT_SCRIPT}
+    PERMISSIONS OWNER_READ OWNER_WRITE OWNER_EXECUTE
+)
+
+# =================================================================================================
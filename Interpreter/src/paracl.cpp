@@ -12,27 +12,197 @@
 #include <stdexcept>
 #include <filesystem>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <system_error>
+#include <cstddef>
 #include <cstdlib>
+#include <utility>
 
-int main(int argc, char* argv[]) try
-{
-    if (argc != 2)
-        throw std::invalid_argument("Usage:\n" + std::string(argv[0]) + " <source>.cl [-o executable]");
+import general;
+import interpreter;
+import tiering;
+import profile;
+import io;
+import jit;
+import thelast;
 
-    auto&& source = std::filesystem::path{argv[1]};
+//---------------------------------------------------------------------------------------------------------------
+
+/* debug mode: frontend and interpreter are separate processes, ast is passed through <source>.ast.bin */
+void interpret_via_files(std::filesystem::path source, std::string_view engine_option, std::string_view flush_option,
+                         unsigned optimization_level)
+{
     auto&& frontend_command = std::ostringstream{};
-    frontend_command << PARACL_FRONT " " << source.string() << " -o " << source.replace_extension(".ast.json");
+    frontend_command << PARACL_FRONT " " << source.string() << " --emit=bin -O" << optimization_level
+                     << " -o " << source.replace_extension(".ast.bin");
 
     auto&& frontend_exit_code = std::system(frontend_command.str().c_str());
     if (frontend_exit_code != EXIT_SUCCESS)
         throw std::runtime_error("Fronted failed with exit code " + std::to_string(frontend_exit_code));
 
     auto&& intepreter_command = std::ostringstream{};
-    intepreter_command << PARACL_INTERPRETER " " << source.string();
+    intepreter_command << PARACL_INTERPRETER " " << source.string() << " " << engine_option << " " << flush_option;
 
     auto&& intepreter_exit_code = std::system(intepreter_command.str().c_str());
     if (intepreter_exit_code != EXIT_SUCCESS)
         throw std::runtime_error("Intepretation failed with exit code " + std::to_string(intepreter_exit_code));
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* --tiered: interpreter passes hot loops to llvm jit */
+class JitLoopCompiler final : public interpreter::tiering::LoopCompiler
+{
+  private:
+    compiler::jit::LoopJit jit_;
+  public:
+    interpreter::tiering::CompiledLoop compile(last::binary::Image const & loop, std::vector<std::string_view> const & captures) override
+    { return jit_.compile_loop(loop, captures); }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* --profile: report of the hottest statements goes to stderr, even if program failed */
+void interpret_with_profile(std::filesystem::path const & source, unsigned optimization_level)
+{
+    auto&& profiler = interpreter::profile::Profiler{};
+
+    try
+    {
+        interpreter::interpret(ParaCL::general::generateASTImage(source.string(), optimization_level), profiler);
+    }
+    catch (...)
+    {
+        interpreter::io::output().flush();
+        profiler.report(std::cerr, source);
+        throw;
+    }
+
+    profiler.report(std::cerr, source);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+size_t parse_threshold(std::string_view value)
+{
+    auto&& threshold = size_t{0};
+    auto&& [end, error] = std::from_chars(value.data(), value.data() + value.size(), threshold);
+
+    if (error != std::errc{} or end != value.data() + value.size() or threshold == 0)
+        throw std::invalid_argument("Invalid threshold for --tiered: " + std::string(value));
+
+    return threshold;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+interpreter::io::Flush parse_flush(std::string_view value)
+{
+    if (value == "line") return interpreter::io::Flush::LINE;
+    if (value == "full") return interpreter::io::Flush::FULL;
+    if (value == "auto") return interpreter::io::Flush::AUTO;
+
+    throw std::invalid_argument("Invalid value for --flush: " + std::string(value) + " (expected line, full or auto)");
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* -O<level> of ast optimizer */
+unsigned parse_optimization_level(std::string_view value)
+{
+    if (value == "0") return 0;
+    if (value == "1") return 1;
+    if (value == "2") return 2;
+
+    throw std::invalid_argument("Invalid optimization level: -O" + std::string(value) + " (expected -O0, -O1 or -O2)");
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[]) try
+{
+    if (argc < 2)
+        throw std::invalid_argument("Usage:\n" + std::string(argv[0]) + " <source>.cl [--engine=tree|bytecode|--jit|--tiered[=<threshold>]] [--flush=line|full|auto] [-O0|-O1|-O2] [--profile] [--via-files] [--time-report] [--stats] [--time-trace=<file>]");
+
+    auto&& engine        = interpreter::Engine::TREE;
+    auto&& engine_option = std::string_view{};
+    auto&& via_files     = false;
+    auto&& jit           = false;
+    auto&& tiered        = false;
+    auto&& tiering       = interpreter::tiering::Options{};
+    auto&& flush         = interpreter::io::Flush::AUTO;
+    auto&& flush_option  = std::string_view{};
+    auto&& optimization  = 0u;
+    auto&& profile       = false;
+    auto&& stats         = last::stats::Options{};
+
+    for (int it = 2; it < argc; ++it)
+    {
+        auto&& option = std::string_view{argv[it]};
+
+        if      (option == "--engine=tree")     { engine = interpreter::Engine::TREE;     engine_option = option; }
+        else if (option == "--engine=bytecode") { engine = interpreter::Engine::BYTECODE; engine_option = option; }
+        else if (option == "--jit")               jit = true;
+        else if (option == "--tiered")            tiered = true;
+        else if (option.starts_with("--tiered=")) { tiered = true; tiering.threshold = parse_threshold(option.substr(9)); }
+        else if (option.starts_with("--flush="))  { flush = parse_flush(option.substr(8)); flush_option = option; }
+        else if (option.starts_with("-O"))        optimization = parse_optimization_level(option.substr(2));
+        else if (option == "--profile")           profile = true;
+        else if (option == "--via-files")         via_files = true;
+        else if (option == "--time-report")       stats.time_report = true;
+        else if (option == "--stats")             stats.stats = true;
+        else if (option.starts_with("--time-trace=")) stats.time_trace = option.substr(13);
+        else throw std::invalid_argument("Unknown option: " + std::string(option));
+    }
+
+    if ((jit or tiered) and not engine_option.empty())
+        throw std::invalid_argument("--jit, --tiered and --engine are mutually exclusive");
+
+    if (jit and tiered)
+        throw std::invalid_argument("--jit and --tiered are mutually exclusive");
+
+    if ((jit or tiered) and via_files)
+        throw std::invalid_argument("--jit and --tiered work only in one process, they cannot be used with --via-files");
+
+    if (profile and (jit or tiered or via_files or engine == interpreter::Engine::BYTECODE))
+        throw std::invalid_argument("--profile works only with tree engine in one process");
+
+    auto&& source = std::filesystem::path{argv[1]};
+
+    /* with --via-files frontend and interpreter processes inherit these options and write to the same trace */
+    last::stats::start("paracli", std::move(stats));
+
+    /* before any output. compiled code (--jit, --tiered) prints through paracl-rt, which follows the same policy */
+    compiler::jit::set_line_buffered(interpreter::io::configure(flush));
+
+    if (jit)
+    {
+        return compiler::jit::run(ParaCL::general::generateASTImage(source.string(), optimization), source.string(), optimization);
+    }
+
+    if (tiered)
+    {
+        auto&& loop_compiler = JitLoopCompiler{};
+        tiering.compiler = &loop_compiler;
+        interpreter::interpret(ParaCL::general::generateASTImage(source.string(), optimization), tiering);
+        return EXIT_SUCCESS;
+    }
+
+    if (via_files)
+    {
+        interpret_via_files(source, engine_option, flush_option, optimization);
+        return EXIT_SUCCESS;
+    }
+
+    if (profile)
+    {
+        interpret_with_profile(source, optimization);
+        return EXIT_SUCCESS;
+    }
+
+    interpreter::interpret(ParaCL::general::generateASTImage(source.string(), optimization), engine);
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,31 @@
+k = 2 * 3 + 1;
+print k;
+
+m = 0;
+j = 0;
+while (j < 4)
+{
+    m += j;
+    j += 1;
+}
+
+i = 0;
+s = 0;
+while (i < 5)
+{
+    s = s + (m * 2 - 1) * 1 + 0;
+    i += 1;
+}
+print s;
+
+d = 0;
+while (d)
+{
+    print m / d;
+}
+
+if (0) { print 1; } else if (1 - 1) { print 2; } else { print 3; }
+;;;
+
+x = 0 - m;
+print -(-x), " ", m % 1, " ", !(x < 0);
@@ -0,0 +1,6 @@
+a = repeat(1, 3);
+print a[0] + a[2];
+
+// read after the last element
+print a[3];
+print 7;
@@ -0,0 +1,5 @@
+x = 5;
+print x;
+
+a = repeat(x, x - 6);
+print 7;
@@ -0,0 +1,14 @@
+// arrays are too big for stack: elements are on heap, and every declaration frees the previous ones
+k = 0;
+total = 0;
+while (k < 3)
+{
+    big = repeat(k, 5000);
+    big[4999] += 1;
+    total += big[0] + big[4999];
+
+    big = repeat(k + 10, 6000);
+    total += big[5999];
+    k += 1;
+}
+print total;
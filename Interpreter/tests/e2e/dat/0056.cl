@@ -0,0 +1,8 @@
+// array of loop body: with --tiered the loop is compiled, and index is out of range in compiled code
+k = 0;
+while (k < 10)
+{
+    c = repeat(k, 4);
+    print c[k];
+    k += 1;
+}
@@ -1,5 +1,6 @@
 #!/usr/bin/python3
 
+import os
 import sys
 import subprocess
 
@@ -29,14 +30,20 @@ def extract_numbers(text):
     return numbers
 
 def main():
-    if len(sys.argv) != 4:
-        print(f"Usage: {sys.argv[0]} <paracl_exe> <test>.cl <answer>.ans")
+    if len(sys.argv) < 4:
+        print(f"Usage: {sys.argv[0]} <paracl_exe> <test>.cl <answer>.ans [paracl options...]")
         return 1
 
     executable, test_input, test_answer = sys.argv[1:4]
+    options = sys.argv[4:]
 
     expect_death = False
     exit_code = 0
+    death_message = ""
+
+    # input of program (for '?'), if there is <test>.in near <test>.cl
+    stdin_file = os.path.splitext(test_input)[0] + ".in"
+    program_input = None
 
     try:
         with open(test_answer, 'r') as f:
@@ -48,26 +55,41 @@ def main():
                 color_print(Colors.RED, "bad format of ans file")
                 return 1
 
-            exit_code = int(answer_content.partition(':')[2])
+            # DEATH_WITH: <exit code>, next lines (if any) - message, expected in stderr
+            exit_code_line, _, death_message = answer_content.partition(':')[2].partition('\n')
+            exit_code = int(exit_code_line)
+            death_message = death_message.strip()
 
         else:
             answer_content.strip()
 
+        if os.path.exists(stdin_file):
+            with open(stdin_file, 'r') as f:
+                program_input = f.read()
+
     except Exception as e:
         color_print(Colors.RED, f"Error reading file: {e}")
         sys.exit(1)
 
     result = subprocess.run(
-        [executable, test_input],
+        [executable, test_input, *options],
+        input=program_input,
         capture_output=True,
         text=True
     )
 
 
-    if expect_death and result.returncode == exit_code:
+    if expect_death and result.returncode == exit_code and death_message in result.stderr:
         color_print(Colors.GREEN, "TEST PASSED")
         return 0
 
+    if expect_death and result.returncode == exit_code:
+        color_print(Colors.WHITE, "Expect DEATH", end = '\n\n')
+        color_print(Colors.GREEN, f"[ expected message ]: {death_message}")
+        color_print(Colors.RED,   f"[ program  stderr  ]: {result.stderr}", end = '\n\n')
+        color_print(Colors.RED, "\n\nTEST FAILED")
+        return 1
+
     if expect_death and result.returncode != exit_code:
         color_print(Colors.WHITE, "Expect DEATH", end = '\n\n')
         color_print(Colors.GREEN, f"[ expected exit code ]: {exit_code}")
@@ -0,0 +1,12 @@
+n = 4;
+s = 0;
+i = 0;
+while (i < n) {
+    j = 0;
+    while (j < i) {
+        s = s + j;
+        j = j + 1;
+    }
+    i = i + 1;
+}
+print s;
@@ -0,0 +1,109 @@
+#!/usr/bin/python3
+
+# checks report of 'paracl --profile': every statement must be counted on its line
+# with expected number of executions (and iterations for loops). times are not checked.
+
+import re
+import sys
+import subprocess
+
+class Colors:
+    RED       = '\033[91m'
+    GREEN     = '\033[92m'
+    WHITE     = '\033[97m'
+    RESET     = '\033[0m'
+
+def color_print(color, arg, **kwargs):
+    print(f"{color}{arg}{Colors.RESET}", **kwargs)
+
+# total ms, self ms, executions, iterations, line:col, source
+REPORT_ROW = re.compile(r'^\s*[\d.]+\s+[\d.]+\s+(\d+)\s+(\d+|-)\s+(\d+):\d+\s*(.*)$')
+
+# source line as report shows it: without indentation and cut to 60 symbols
+def shown_line(line):
+    text = line.strip(" \t\n")
+    return text[:60] + "..." if len(text) > 60 else text
+
+def read_expected(expected_file):
+    expected = {}
+    with open(expected_file, 'r') as f:
+        for row in f:
+            row = row.split('#')[0].split()
+            if not row:
+                continue
+            expected[int(row[0])] = (int(row[1]), row[2])
+    return expected
+
+def read_report(report):
+    counted = {}
+    for row in report.splitlines():
+        match = REPORT_ROW.match(row)
+        if match:
+            executions, iterations, line, source = match.groups()
+            counted[int(line)] = (int(executions), iterations, source)
+    return counted
+
+def main():
+    if len(sys.argv) < 4:
+        print(f"Usage: {sys.argv[0]} <paracl_exe> <test>.cl <expected>.prof [paracl options...]")
+        return 1
+
+    executable, test_input, expected_file = sys.argv[1:4]
+    options = sys.argv[4:]
+
+    try:
+        expected = read_expected(expected_file)
+        with open(test_input, 'r') as f:
+            source = f.readlines()
+    except Exception as e:
+        color_print(Colors.RED, f"Error reading file: {e}")
+        return 1
+
+    # without optimizer: statements are counted as they are written
+    result = subprocess.run(
+        [executable, test_input, "--profile", "-O0", *options],
+        capture_output=True,
+        text=True
+    )
+
+    if result.returncode != 0:
+        color_print(Colors.RED, f"Error: Program failed with exit code {result.returncode}")
+        print(f"stderr: {result.stderr}")
+        color_print(Colors.RED, "\n\nTEST FAILED")
+        return 1
+
+    counted = read_report(result.stderr)
+    errors = 0
+
+    for line, (executions, iterations) in sorted(expected.items()):
+        if line not in counted:
+            color_print(Colors.RED, f"[ line {line} ]: not in report")
+            errors += 1
+            continue
+
+        got_executions, got_iterations, got_source = counted[line]
+
+        if (got_executions, got_iterations) != (executions, iterations):
+            color_print(Colors.RED, f"[ line {line} ]: executions {got_executions}, iterations {got_iterations}; "
+                                    f"expected {executions}, {iterations}")
+            errors += 1
+
+        if got_source != shown_line(source[line - 1]):
+            color_print(Colors.RED, f"[ line {line} ]: source '{got_source}', expected '{shown_line(source[line - 1])}'")
+            errors += 1
+
+    for line in sorted(set(counted) - set(expected)):
+        color_print(Colors.RED, f"[ line {line} ]: unexpected statement in report")
+        errors += 1
+
+    if errors == 0:
+        color_print(Colors.GREEN, "TEST PASSED")
+        return 0
+
+    color_print(Colors.WHITE, "\nreport:\n")
+    print(result.stderr)
+    color_print(Colors.RED, "\n\nTEST FAILED")
+    return 1
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,771 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/json.hpp>
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/CommandLine.h>
+
+import general;
+import interpreter;
+import io;
+import llvm_ir_translator;
+import compiler;
+import thelast;
+
+extern char** environ;
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+paracl-bench: every phase of both pipelines is measured apart, in one process:
+    parse     - lexer, parser and ast optimizer (ParaCL::general::generateAST)
+    serialize - binary ast to file (last::write_binary)
+    load      - mapping of file and reading of tree with nodes of interpreter
+    interpret - execution by interpreter, output goes to /dev/null
+    irgen     - translation of ast to llvm ir (with reading of tree by translator)
+    codegen   - llvm passes, object file and linking of executable
+    run       - produced executable, in child process
+*/
+
+llvm::cl::list<std::string> Sources(
+    llvm::cl::Positional,
+    llvm::cl::desc("<source>.cl or directory with them..."),
+    llvm::cl::OneOrMore
+);
+
+llvm::cl::opt<unsigned> Repetitions(
+    "repetitions",
+    llvm::cl::desc("Measured runs of every phase (default: 5)"),
+    llvm::cl::init(5)
+);
+
+llvm::cl::opt<unsigned> Warmup(
+    "warmup",
+    llvm::cl::desc("Runs before measured ones, they are not counted (default: 1)"),
+    llvm::cl::init(1)
+);
+
+llvm::cl::list<std::string> Phases(
+    "phases",
+    llvm::cl::desc("Measured phases (default: all): parse,serialize,load,interpret,irgen,codegen,run. "
+                   "phases, which are needed by measured ones, are run, but not reported"),
+    llvm::cl::CommaSeparated
+);
+
+llvm::cl::opt<unsigned> OptimizationLevel(
+    "O",
+    llvm::cl::desc("Optimization level of compiler: -O0..-O3 (default: -O3), ast is optimized at min(-O, 2)"),
+    llvm::cl::Prefix,
+    llvm::cl::init(3)
+);
+
+llvm::cl::opt<bool> Curves(
+    "curves",
+    llvm::cl::desc("Instead of table of every source: time and memory of every phase by size of source. "
+                   "sources are grouped by name before the last '-' (<shape>-<size>.cl of paracl-gen --corpus)"),
+    llvm::cl::init(false)
+);
+
+llvm::cl::opt<std::string> JsonOutput(
+    "json",
+    llvm::cl::desc("Write results in json to file ('-' - stdout instead of table)"),
+    llvm::cl::value_desc("file")
+);
+
+llvm::cl::opt<std::string> Baseline(
+    "baseline",
+    llvm::cl::desc("Compare medians with json of previous run, exit code 1 if some phase became slower"),
+    llvm::cl::value_desc("file")
+);
+
+llvm::cl::opt<bool> UpdateBaseline(
+    "update-baseline",
+    llvm::cl::desc("Write results to --baseline file instead of comparing"),
+    llvm::cl::init(false)
+);
+
+llvm::cl::opt<double> Tolerance(
+    "tolerance",
+    llvm::cl::desc("Allowed slowdown of median against baseline (default: 0.25 - 25%)"),
+    llvm::cl::init(0.25)
+);
+
+llvm::cl::opt<double> NoiseFloor(
+    "noise-floor",
+    llvm::cl::desc("Slowdown less than this number of milliseconds is not a regression (default: 1)"),
+    llvm::cl::init(1.0)
+);
+
+//---------------------------------------------------------------------------------------------------------------
+
+constexpr std::string_view phases[] = { "parse", "serialize", "load", "interpret", "irgen", "codegen", "run" };
+
+bool enabled(std::string_view phase)
+{
+    return Phases.empty() or std::ranges::find(Phases, phase) != Phases.end();
+}
+
+bool enabled_any(std::initializer_list<std::string_view> any)
+{
+    return std::ranges::any_of(any, enabled);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* one measured run of phase */
+struct Sample
+{
+    double milliseconds;
+    size_t peak_rss_kb;
+};
+
+/* statistics of phase over repetitions */
+struct Summary
+{
+    double min_ms;
+    double median_ms;
+    double p90_ms;
+    double max_ms;
+    size_t peak_rss_kb;
+};
+
+/* one source: its phases or the reason, why it was not measured */
+struct Benchmark
+{
+    size_t bytes = 0;
+    std::map<std::string, Summary> phases;
+    std::string failure;
+};
+
+using Results = std::map<std::string, Benchmark>; /* name of source -> benchmark */
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* peak rss of process is reset before phase (linux >= 4.0), so VmHWM after it is the peak of the phase */
+void reset_peak_rss()
+{
+    auto&& clear_refs = std::ofstream{"/proc/self/clear_refs"};
+    clear_refs << "5";
+}
+
+size_t peak_rss_kb()
+{
+    auto&& status = std::ifstream{"/proc/self/status"};
+
+    for (auto&& line = std::string{}; std::getline(status, line);)
+        if (line.starts_with("VmHWM:")) return std::stoul(line.substr(6));
+
+    auto&& usage = rusage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+template <typename Function>
+auto measure(std::vector<Sample>& samples, Function&& function)
+{
+    reset_peak_rss();
+    auto&& start = std::chrono::steady_clock::now();
+
+    auto&& finish = [&]
+    {
+        auto&& elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+        samples.push_back(Sample{elapsed.count(), peak_rss_kb()});
+    };
+
+    if constexpr (std::is_void_v<decltype(function())>)
+    {
+        function();
+        finish();
+    }
+    else
+    {
+        auto&& result = function();
+        finish();
+        return std::move(result);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* stdout of interpreter goes to /dev/null while it`s alive: results of bench are not mixed with output of program */
+class Silence final
+{
+  private:
+    int saved_;
+
+  public:
+    Silence()
+    {
+        std::fflush(stdout);
+        saved_ = ::dup(STDOUT_FILENO);
+
+        auto&& null = ::open("/dev/null", O_WRONLY);
+        ::dup2(null, STDOUT_FILENO);
+        ::close(null);
+    }
+
+    ~Silence()
+    {
+        std::fflush(stdout);
+        ::dup2(saved_, STDOUT_FILENO);
+        ::close(saved_);
+    }
+
+    Silence(Silence const &) = delete;
+    Silence& operator=(Silence const &) = delete;
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* stdin of program: <source>.in, if it exists */
+std::filesystem::path input_of(std::filesystem::path const & source)
+{
+    auto&& input = std::filesystem::path{source}.replace_extension(".in");
+    return std::filesystem::exists(input) ? input : std::filesystem::path{"/dev/null"};
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* executable in child process: time of its life and its peak rss (from wait4) */
+Sample run_executable(std::filesystem::path const & executable, std::filesystem::path const & input)
+{
+    auto&& actions = posix_spawn_file_actions_t{};
+    ::posix_spawn_file_actions_init(&actions);
+    ::posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, input.c_str(), O_RDONLY, 0);
+    ::posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    auto&& path  = executable.string();
+    char* argv[] = { path.data(), nullptr };
+    auto&& pid   = pid_t{};
+
+    auto&& start = std::chrono::steady_clock::now();
+    auto&& error = ::posix_spawn(&pid, path.c_str(), &actions, nullptr, argv, environ);
+    ::posix_spawn_file_actions_destroy(&actions);
+
+    if (error != 0)
+        throw std::runtime_error("Failed to run '" + path + "': " + std::generic_category().message(error));
+
+    auto&& status = 0;
+    auto&& usage  = rusage{};
+    ::wait4(pid, &status, 0, &usage);
+
+    auto&& elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    if (not WIFEXITED(status) or WEXITSTATUS(status) != EXIT_SUCCESS)
+        throw std::runtime_error("'" + path + "' failed with status " + std::to_string(status));
+
+    return Sample{elapsed.count(), static_cast<size_t>(usage.ru_maxrss)};
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* nearest rank of sorted samples */
+double percentile(std::vector<double> const & sorted, double fraction)
+{
+    auto&& rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+Summary summarize(std::vector<Sample> const & samples)
+{
+    auto&& times = std::vector<double>{};
+    auto&& peak  = size_t{0};
+
+    for (auto&& sample : samples)
+    {
+        times.push_back(sample.milliseconds);
+        peak = std::max(peak, sample.peak_rss_kb);
+    }
+
+    std::ranges::sort(times);
+
+    return Summary{times.front(), percentile(times, 0.5), percentile(times, 0.9), times.back(), peak};
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* both pipelines on one source: warmup runs, then measured ones */
+std::map<std::string, Summary> bench(std::filesystem::path const & source, std::filesystem::path const & work_dir,
+                                     compiler::Codegen& codegen)
+{
+    auto&& options = compiler::CompileOptions{.optimization_level = OptimizationLevel};
+    auto&& ast_level = std::min(OptimizationLevel.getValue(), 2u);
+
+    auto&& ast_file   = work_dir / "program.ast.bin";
+    auto&& executable = work_dir / "program";
+    auto&& input      = input_of(source);
+
+    auto&& samples   = std::map<std::string, std::vector<Sample>>{};
+    auto&& discarded = std::map<std::string, std::vector<Sample>>{};
+
+    for (auto&& it = 0u, ite = Warmup + Repetitions; it != ite; ++it)
+    {
+        auto&& phase = [&, warmup = (it < Warmup)](std::string const & name) -> std::vector<Sample>&
+        { return (warmup or not enabled(name)) ? discarded[name] : samples[name]; };
+
+        auto&& ast = measure(phase("parse"), [&] { return ParaCL::general::generateAST(source.string(), ast_level); });
+
+        measure(phase("serialize"), [&] { last::write_binary(ast, ast_file); });
+
+        auto&& tree = measure(phase("load"), [&] { return interpreter::load(last::binary::Image{ast_file}); });
+
+        if (enabled("interpret"))
+        {
+            /* program reads its input from the beginning in every run */
+            if (not std::freopen(input.c_str(), "r", stdin))
+                throw std::runtime_error("Failed to open '" + input.string() + "'");
+
+            auto&& silence = Silence{};
+            measure(phase("interpret"), [&] { interpreter::interpret(tree); });
+        }
+
+        if (not enabled_any({"irgen", "codegen", "run"})) continue;
+
+        auto&& image   = last::binary::Image{ast_file};
+        auto&& context = llvm::LLVMContext{};
+        auto&& module  = measure(phase("irgen"), [&]
+        { return compiler::llvm_ir_translator::translate(image, source.string(), context); });
+
+        if (not enabled_any({"codegen", "run"})) continue;
+        measure(phase("codegen"), [&] { codegen.build(*module, executable, options); });
+
+        if (not enabled("run")) continue;
+        phase("run").push_back(run_executable(executable, input));
+    }
+
+    auto&& result = std::map<std::string, Summary>{};
+    for (auto&& [name, phase_samples] : samples)
+        result[name] = summarize(phase_samples);
+
+    return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+every source is measured in its own child process: stack exhaustion on deeply nested program (or any other crash)
+is reported as failure of this source, and the rest are measured. child sends summaries through pipe:
+    <phase> <min> <median> <p90> <max> <peak rss>
+or
+    error <message>
+*/
+Benchmark bench_isolated(std::filesystem::path const & source, std::filesystem::path const & work_dir,
+                         compiler::Codegen& codegen)
+{
+    auto&& result = Benchmark{.bytes = static_cast<size_t>(std::filesystem::file_size(source))};
+
+    int channel[2];
+    if (::pipe(channel) != 0)
+        throw std::runtime_error("Failed to create pipe: " + std::generic_category().message(errno));
+
+    std::cout.flush();
+    std::fflush(stdout);
+
+    auto&& pid = ::fork();
+    if (pid < 0)
+        throw std::runtime_error("Failed to fork: " + std::generic_category().message(errno));
+
+    if (pid == 0)
+    {
+        ::close(channel[0]);
+
+        auto&& report = std::ostringstream{};
+        auto&& code   = EXIT_SUCCESS;
+        report << std::setprecision(17);
+
+        try
+        {
+            for (auto&& [phase, summary] : bench(source, work_dir, codegen))
+                report << phase << " " << summary.min_ms << " " << summary.median_ms << " " << summary.p90_ms << " "
+                       << summary.max_ms << " " << summary.peak_rss_kb << "\n";
+        }
+        catch (std::exception const & e)
+        {
+            report << "error " << e.what();
+            code = EXIT_FAILURE;
+        }
+
+        auto&& text = report.str();
+        for (auto&& written = size_t{0}; written < text.size();)
+        {
+            auto&& count = ::write(channel[1], text.data() + written, text.size() - written);
+            if (count <= 0) break;
+            written += static_cast<size_t>(count);
+        }
+
+        ::_exit(code);
+    }
+
+    ::close(channel[1]);
+
+    auto&& text = std::string{};
+    auto&& buffer = std::array<char, 4096>{};
+    for (auto&& count = ::read(channel[0], buffer.data(), buffer.size()); count > 0;
+         count = ::read(channel[0], buffer.data(), buffer.size()))
+        text.append(buffer.data(), static_cast<size_t>(count));
+
+    ::close(channel[0]);
+
+    auto&& status = 0;
+    ::waitpid(pid, &status, 0);
+
+    if (WIFSIGNALED(status))
+    {
+        result.failure = "killed by signal " + std::to_string(WTERMSIG(status)) + " (" + ::strsignal(WTERMSIG(status)) + ")";
+        return result;
+    }
+
+    if (text.starts_with("error "))
+    {
+        result.failure = text.substr(6);
+        return result;
+    }
+
+    auto&& in = std::istringstream{text};
+    for (auto&& phase = std::string{}; in >> phase;)
+    {
+        auto&& summary = Summary{};
+        in >> summary.min_ms >> summary.median_ms >> summary.p90_ms >> summary.max_ms >> summary.peak_rss_kb;
+        result.phases[phase] = summary;
+    }
+
+    return result;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* sources from command line: directories are expanded to their *.cl in order of names */
+std::vector<std::filesystem::path> collect_sources()
+{
+    auto&& sources = std::vector<std::filesystem::path>{};
+
+    for (auto&& source : Sources)
+    {
+        if (not std::filesystem::is_directory(source))
+        {
+            sources.emplace_back(source);
+            continue;
+        }
+
+        auto&& directory = std::vector<std::filesystem::path>{};
+        for (auto&& entry : std::filesystem::directory_iterator{source})
+            if (entry.path().extension() == ".cl") directory.push_back(entry.path());
+
+        std::ranges::sort(directory);
+        sources.insert(sources.end(), directory.begin(), directory.end());
+    }
+
+    return sources;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+boost::json::value to_json(Results const & results)
+{
+    auto&& benchmarks = boost::json::object{};
+
+    for (auto&& [source, benchmark] : results)
+    {
+        auto&& phases_json = boost::json::object{};
+
+        for (auto&& [phase, summary] : benchmark.phases)
+            phases_json[phase] = boost::json::object{
+                {"min_ms",      summary.min_ms},
+                {"median_ms",   summary.median_ms},
+                {"p90_ms",      summary.p90_ms},
+                {"max_ms",      summary.max_ms},
+                {"peak_rss_kb", summary.peak_rss_kb},
+            };
+
+        auto&& benchmark_json = boost::json::object{
+            {"bytes",  benchmark.bytes},
+            {"phases", std::move(phases_json)},
+        };
+
+        if (not benchmark.failure.empty())
+            benchmark_json["failure"] = benchmark.failure;
+
+        benchmarks[source] = std::move(benchmark_json);
+    }
+
+    return boost::json::object{
+        {"paracl-bench",       2},
+        {"optimization_level", OptimizationLevel.getValue()},
+        {"warmup",             Warmup.getValue()},
+        {"repetitions",        Repetitions.getValue()},
+        {"benchmarks",         std::move(benchmarks)},
+    };
+}
+
+void write_json(Results const & results, std::filesystem::path const & file)
+{
+    auto&& out = std::ofstream{file};
+    if (not out.is_open())
+        throw std::runtime_error("Failed to open '" + file.string() + "'");
+
+    out << boost::json::serialize(to_json(results)) << "\n";
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+void print_table(std::ostream& out, Results const & results)
+{
+    out << std::fixed << std::setprecision(3);
+
+    for (auto&& [source, benchmark] : results)
+    {
+        out << source << " (median of " << Repetitions << " runs after " << Warmup << " warmup)\n";
+
+        if (not benchmark.failure.empty())
+        {
+            out << "  failed: " << benchmark.failure << "\n\n";
+            continue;
+        }
+
+        out << "  " << std::left << std::setw(12) << "phase" << std::right
+            << std::setw(12) << "min ms" << std::setw(12) << "median ms" << std::setw(12) << "p90 ms"
+            << std::setw(12) << "max ms" << std::setw(14) << "peak rss MB" << "\n";
+
+        for (auto&& phase : phases)
+        {
+            auto&& found = benchmark.phases.find(std::string(phase));
+            if (found == benchmark.phases.end()) continue;
+
+            auto&& summary = found->second;
+
+            out << "  " << std::left << std::setw(12) << phase << std::right
+                << std::setw(12) << summary.min_ms << std::setw(12) << summary.median_ms << std::setw(12) << summary.p90_ms
+                << std::setw(12) << summary.max_ms << std::setw(14) << static_cast<double>(summary.peak_rss_kb) / 1024 << "\n";
+        }
+
+        out << "\n";
+    }
+
+    out << std::defaultfloat;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* paracl-gen --corpus writes <shape>-<size>.cl */
+std::string group_of(std::string const & source)
+{
+    auto&& dash = source.rfind('-');
+    return (dash == std::string::npos) ? source : source.substr(0, dash);
+}
+
+/*
+growth of time against growth of source between neighbour sizes:
+about 1 - linear, 2 after tenfold size - time grows as size^1.3, 10 - quadratic.
+*/
+void print_curves(std::ostream& out, Results const & results)
+{
+    auto&& groups = std::map<std::string, std::vector<std::pair<std::string, Benchmark const *>>>{};
+    for (auto&& [source, benchmark] : results)
+        groups[group_of(source)].emplace_back(source, &benchmark);
+
+    out << std::fixed << std::setprecision(3);
+
+    for (auto&& [group, members] : groups)
+    {
+        std::ranges::sort(members, [](auto&& lhs, auto&& rhs) { return lhs.second->bytes < rhs.second->bytes; });
+
+        out << group << " (median of " << Repetitions << " runs after " << Warmup << " warmup)\n";
+
+        for (auto&& [source, benchmark] : members)
+            if (not benchmark->failure.empty()) out << "  " << source << ": failed: " << benchmark->failure << "\n";
+
+        for (auto&& phase : phases)
+        {
+            auto&& header   = false;
+            auto&& previous = static_cast<std::pair<size_t, Summary> const *>(nullptr);
+            auto&& point    = std::pair<size_t, Summary>{};
+
+            for (auto&& [source, benchmark] : members)
+            {
+                auto&& found = benchmark->phases.find(std::string(phase));
+                if (found == benchmark->phases.end()) continue;
+
+                if (not header)
+                {
+                    out << "  " << phase << "\n"
+                        << "    " << std::left << std::setw(28) << "source" << std::right << std::setw(14) << "KB"
+                        << std::setw(14) << "median ms" << std::setw(14) << "peak rss MB" << std::setw(10) << "growth" << "\n";
+                    header = true;
+                }
+
+                auto&& summary = found->second;
+
+                out << "    " << std::left << std::setw(28) << source << std::right
+                    << std::setw(14) << static_cast<double>(benchmark->bytes) / 1024 << std::setw(14) << summary.median_ms
+                    << std::setw(14) << static_cast<double>(summary.peak_rss_kb) / 1024;
+
+                if (previous and previous->second.median_ms > 0 and previous->first != 0)
+                    out << std::setw(10) << (summary.median_ms / previous->second.median_ms)
+                                          / (static_cast<double>(benchmark->bytes) / static_cast<double>(previous->first));
+                else
+                    out << std::setw(10) << "-";
+
+                out << "\n";
+
+                point    = std::pair{benchmark->bytes, summary};
+                previous = &point;
+            }
+        }
+
+        out << "\n";
+    }
+
+    out << std::defaultfloat;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* medians against baseline: true if nothing became slower than tolerance allows */
+bool compare_with_baseline(Results const & results, std::filesystem::path const & file)
+{
+    auto&& in = std::ifstream{file};
+    auto&& text = std::ostringstream{};
+    text << in.rdbuf();
+
+    auto&& baseline = boost::json::parse(text.str()).as_object().at("benchmarks").as_object();
+    auto&& success  = true;
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (auto&& [source, benchmark] : results)
+    {
+        if (not benchmark.failure.empty())
+        {
+            std::cout << "FAILED     " << source << ": " << benchmark.failure << "\n";
+            success = false;
+            continue;
+        }
+
+        auto&& base_benchmark = baseline.if_contains(source);
+        if (not base_benchmark)
+        {
+            std::cout << "baseline: " << source << ": not in baseline\n";
+            continue;
+        }
+
+        auto&& base_phases = base_benchmark->as_object().at("phases").as_object();
+
+        for (auto&& [phase, summary] : benchmark.phases)
+        {
+            auto&& base_phase = base_phases.if_contains(phase);
+            if (not base_phase) continue;
+
+            auto&& base   = base_phase->as_object().at("median_ms").to_number<double>();
+            auto&& slower = summary.median_ms > base * (1 + Tolerance) and summary.median_ms - base > NoiseFloor;
+
+            if (slower) success = false;
+
+            std::cout << (slower ? "REGRESSION " : "ok         ") << source << ": " << phase << ": "
+                      << base << " ms -> " << summary.median_ms << " ms\n";
+        }
+    }
+
+    std::cout << std::defaultfloat;
+    return success;
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    llvm::cl::ParseCommandLineOptions(argc, argv, "paracl-bench: time and peak memory of every phase of frontend and both backends\n");
+
+    for (auto&& phase : Phases)
+        if (std::ranges::find(phases, phase) == std::end(phases))
+            throw std::invalid_argument("Unknown phase '" + phase + "'");
+
+    if (Repetitions == 0)
+        throw std::invalid_argument("--repetitions must be positive");
+
+    if (UpdateBaseline and Baseline.empty())
+        throw std::invalid_argument("--update-baseline needs --baseline=<file>");
+
+    /* missing baseline is an error, not a pass: otherwise regression check could never fail */
+    if (not Baseline.empty() and not UpdateBaseline and not std::filesystem::exists(Baseline.getValue()))
+        throw std::runtime_error("No baseline '" + Baseline.getValue() + "', record it on reference machine with --update-baseline");
+
+    /* programs write into /dev/null: output is flushed by big blocks, like in pipe */
+    interpreter::io::configure(interpreter::io::Flush::FULL);
+
+    auto&& work_dir = std::filesystem::temp_directory_path() / ("paracl-bench-" + std::to_string(::getpid()));
+    std::filesystem::create_directories(work_dir);
+
+    auto&& codegen = compiler::Codegen{compiler::Toolchain{compiler::CompileOptions{.optimization_level = OptimizationLevel}}};
+    auto&& results = Results{};
+
+    /* by name of file: baseline of one machine is compared with results of checkout in other directory */
+    for (auto&& source : collect_sources())
+        results[source.filename().string()] = bench_isolated(source, work_dir, codegen);
+
+    auto&& ec = std::error_code{};
+    std::filesystem::remove_all(work_dir, ec);
+
+    if (JsonOutput == "-")
+        std::cout << boost::json::serialize(to_json(results)) << "\n";
+    else if (Curves)
+        print_curves(std::cout, results);
+    else
+        print_table(std::cout, results);
+
+    if (not JsonOutput.empty() and JsonOutput != "-")
+        write_json(results, JsonOutput.getValue());
+
+    auto&& failed = std::ranges::any_of(results, [](auto&& result) { return not result.second.failure.empty(); });
+
+    if (Baseline.empty()) return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    if (UpdateBaseline)
+    {
+        if (failed)
+            throw std::runtime_error("Some sources failed, baseline is not updated");
+
+        write_json(results, Baseline.getValue());
+        std::cout << "paracl-bench: baseline '" << Baseline << "' is updated\n";
+        return EXIT_SUCCESS;
+    }
+
+    return compare_with_baseline(results, Baseline.getValue()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (std::exception const & e)
+{
+    std::cerr << "paracl-bench: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <llvm/Support/CommandLine.h>
+
+//---------------------------------------------------------------------------------------------------------------
+
+/*
+paracl-gen: machine-like programs of given size for scalability benchmarks.
+every program terminates quickly and prints a few variables at the end, so it may be interpreted and compiled.
+shapes:
+    flat       - <size> assignments with long-living variables
+    nested     - scopes (plain, if and while, that runs once) nested <size> levels deep
+    chain      - if / else if chain of <size> branches, the last one is taken
+    expression - one expression of <size> operands
+    variables  - <size> distinct variables, each is used by the next one
+*/
+
+enum class Shape
+{
+    FLAT,
+    NESTED,
+    CHAIN,
+    EXPRESSION,
+    VARIABLES,
+};
+
+llvm::cl::opt<Shape> ShapeOption(
+    "shape",
+    llvm::cl::desc("Shape of program:"),
+    llvm::cl::values(
+        clEnumValN(Shape::FLAT,       "flat",       "assignments with long-living variables (default)"),
+        clEnumValN(Shape::NESTED,     "nested",     "scopes, if and while nested <size> levels deep"),
+        clEnumValN(Shape::CHAIN,      "chain",      "if / else if chain of <size> branches"),
+        clEnumValN(Shape::EXPRESSION, "expression", "one expression of <size> operands"),
+        clEnumValN(Shape::VARIABLES,  "variables",  "<size> distinct variables")
+    ),
+    llvm::cl::init(Shape::FLAT)
+);
+
+llvm::cl::opt<size_t> Size(
+    "size",
+    llvm::cl::desc("Statements, nesting levels, branches, operands or variables, depends on shape (default: 1000)"),
+    llvm::cl::init(1000)
+);
+
+llvm::cl::opt<size_t> Variables(
+    "variables",
+    llvm::cl::desc("Variables of flat program (default: 64)"),
+    llvm::cl::init(64)
+);
+
+llvm::cl::opt<uint32_t> Seed(
+    "seed",
+    llvm::cl::desc("Seed of generator: the same seed gives the same program (default: 1)"),
+    llvm::cl::init(1)
+);
+
+llvm::cl::opt<std::string> Output(
+    "o",
+    llvm::cl::desc("Output file (default: stdout)"),
+    llvm::cl::value_desc("file")
+);
+
+llvm::cl::opt<std::string> Corpus(
+    "corpus",
+    llvm::cl::desc("Write every shape of sizes 10^3, 10^4, ... up to --max-size to <directory>/<shape>-<size>.cl"),
+    llvm::cl::value_desc("directory")
+);
+
+llvm::cl::opt<size_t> MaxSize(
+    "max-size",
+    llvm::cl::desc("The biggest size of --corpus (default: 1000000)"),
+    llvm::cl::init(1000000)
+);
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* values stay less than it: no expression of generated program overflows int */
+constexpr int modulo = 1009;
+
+//---------------------------------------------------------------------------------------------------------------
+
+class Generator final
+{
+  private:
+    std::ostream& out_;
+    std::minstd_rand random_;
+
+  public:
+    Generator(std::ostream& out, uint32_t seed) :
+    out_(out), random_(seed)
+    {}
+
+    void generate(Shape shape, size_t size)
+    {
+        switch (shape)
+        {
+            case Shape::FLAT:       flat_(size);       break;
+            case Shape::NESTED:     nested_(size);     break;
+            case Shape::CHAIN:      chain_(size);      break;
+            case Shape::EXPRESSION: expression_(size); break;
+            case Shape::VARIABLES:  variables_(size);  break;
+            default: __builtin_unreachable();
+        }
+    }
+
+  private:
+    size_t random_below_(size_t bound)
+    { return static_cast<size_t>(random_()) % bound; }
+
+    void flat_(size_t size)
+    {
+        auto&& variables = size_t{std::max<size_t>(Variables, 1)};
+
+        for (auto&& it = size_t{0}; it != variables; ++it)
+            out_ << "v" << it << " = " << it % modulo << ";\n";
+
+        for (auto&& it = size_t{variables}; it < size; ++it)
+            out_ << "v" << random_below_(variables) << " = (v" << random_below_(variables) << " * 3 + v"
+                 << random_below_(variables) << " + " << random_below_(modulo) << ") % " << modulo << ";\n";
+
+        out_ << "print v0, \" \", v" << variables - 1 << ";\n";
+    }
+
+    /* level <it> declares its own variable n<it>: every scope has something to forget at the end */
+    void nested_(size_t depth)
+    {
+        out_ << "n0 = 0;\n";
+
+        for (auto&& it = size_t{1}; it <= depth; ++it)
+        {
+            switch (it % 3)
+            {
+                case 0:  out_ << "{\n"; break;
+                case 1:  out_ << "if (n" << it - 1 << " >= 0) {\n"; break;
+                default: out_ << "w" << it << " = 0; while (w" << it << " < 1) { w" << it << " += 1;\n"; break;
+            }
+
+            out_ << "n" << it << " = (n" << it - 1 << " + 1) % " << modulo << ";\n";
+        }
+
+        out_ << "print n" << depth << ";\n";
+
+        for (auto&& it = size_t{0}; it != depth; ++it) out_ << "}";
+        out_ << "\nprint n0;\n";
+    }
+
+    void chain_(size_t branches)
+    {
+        out_ << "x = " << (branches == 0 ? 0 : branches - 1) << ";\ny = 0;\n";
+
+        for (auto&& it = size_t{0}; it != branches; ++it)
+        {
+            if (it != 0) out_ << "else ";
+            out_ << "if (x == " << it << ") { y = " << it % modulo << "; }\n";
+        }
+
+        if (branches != 0) out_ << "else { y = -1; }\n";
+        out_ << "print y;\n";
+    }
+
+    /* operands go by pairs +a -a: value of expression doesn`t grow, but nothing is known to ast optimizer */
+    void expression_(size_t operands)
+    {
+        static constexpr size_t variables = 16;
+
+        for (auto&& it = size_t{0}; it != variables; ++it)
+            out_ << "e" << it << " = ?;\n";
+
+        out_ << "x = e0";
+
+        for (auto&& it = size_t{1}; it < operands; ++it)
+        {
+            auto&& variable = (it + 1) / 2 % variables;
+            out_ << ((it % 2 == 1) ? " + e" : " - e") << variable;
+            if (it % 16 == 0) out_ << "\n";
+        }
+
+        out_ << ";\nprint x;\n";
+    }
+
+    void variables_(size_t count)
+    {
+        out_ << "v0 = 1;\n";
+
+        for (auto&& it = size_t{1}; it < count; ++it)
+            out_ << "v" << it << " = (v" << it - 1 << " + " << random_below_(modulo) << ") % " << modulo << ";\n";
+
+        out_ << "print v" << (count == 0 ? 0 : count - 1) << ";\n";
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------
+
+void generate(std::filesystem::path const & file, Shape shape, size_t size)
+{
+    auto&& out = std::ofstream{file};
+    if (not out.is_open())
+        throw std::runtime_error("Failed to create '" + file.string() + "'");
+
+    Generator{out, Seed}.generate(shape, size);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+/* all shapes of sizes 10^3 .. --max-size. <shape>.in is input of expression programs */
+void generate_corpus(std::filesystem::path const & directory)
+{
+    std::filesystem::create_directories(directory);
+
+    auto&& shapes = {
+        std::pair{Shape::FLAT,       "flat"},
+        std::pair{Shape::NESTED,     "nested"},
+        std::pair{Shape::CHAIN,      "chain"},
+        std::pair{Shape::EXPRESSION, "expression"},
+        std::pair{Shape::VARIABLES,  "variables"},
+    };
+
+    for (auto&& [shape, name] : shapes)
+    {
+        for (auto&& size = size_t{1000}; size <= MaxSize; size *= 10)
+        {
+            auto&& file = directory / (std::string(name) + "-" + std::to_string(size) + ".cl");
+            generate(file, shape, size);
+
+            if (shape == Shape::EXPRESSION)
+                std::ofstream{std::filesystem::path{file}.replace_extension(".in")} << "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16\n";
+
+            std::cout << "paracl-gen: " << file.string() << "\n";
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) try
+{
+    llvm::cl::ParseCommandLineOptions(argc, argv, "paracl-gen: generated ParaCL programs for scalability benchmarks\n");
+
+    if (not Corpus.empty())
+    {
+        generate_corpus(Corpus.getValue());
+        return EXIT_SUCCESS;
+    }
+
+    if (not Output.empty())
+    {
+        generate(Output.getValue(), ShapeOption, Size);
+        return EXIT_SUCCESS;
+    }
+
+    Generator{std::cout, Seed}.generate(ShapeOption, Size);
+    return EXIT_SUCCESS;
+}
+catch (std::exception const & e)
+{
+    std::cerr << "paracl-gen: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}